@@ -1,687 +1,3137 @@
 //--------------------------------------------------//
 // Headers
 //--------------------------------------------------//
-#include <cmath>
-#include <cstdint>
-#include <cstdlib>
-#include <fstream>
-#include <iomanip>
-#include <iostream>
-#include <string>
-#include <vector>
+#include "Rhea.hpp"
 
-//--------------------------------------------------//
-// Definitions
-//--------------------------------------------------//
-#define __RHEA_VERSION__ "0.1.0-alpha.9"
-#define __RHEA_DEBUG__ 0
+#include <charconv>
+
+/**
+ * @brief Whether or not this is the benchmark harness (the rhea_bench target), which only runs the benchmark suite.
+ */
+#ifndef __RHEA_BENCH__
+    #define __RHEA_BENCH__ 0
+#endif
 
 //--------------------------------------------------//
 // Code
 //--------------------------------------------------//
 namespace Rhea {
-    /**
-     * @brief Converts a value into its hexadecimal representation.
-     * @param value The value.
-     * @param digits The digits.
-     * @return The hexadecimal representation.
-     */
-    static std::string format_hex(const std::uint16_t value, const std::uint8_t digits = 4) {
-        std::stringstream converter;
-
-        converter << std::setfill('0') << std::setw(digits) << std::uppercase << std::hex << value;
-
-        return converter.str();
-    }
-
     /**
      * @brief Checks if a string is prefixed.
      * @param string The string.
      * @param prefix The prefix.
      * @return Whether or not is the string prefixed.
      */
-    static bool is_prefixed(const std::string string, const std::string prefix) {
-        return string.size() >= prefix.size() && 0 == string.compare(0, prefix.size(), prefix);
+    static bool is_prefixed(const std::string_view string, const std::string_view prefix) noexcept {
+        return string.substr(0, prefix.size()) == prefix;
     }
 
     /**
-     * @brief Checks if a string is suffixed.
+     * @brief Splits a string into tokens, skipping the empty ones. The tokens point into the string, and reusing the
+     *        same vector keeps its storage, so splitting doesn't allocate once it has grown enough.
      * @param string The string.
-     * @param suffix The suffix.
-     * @return Whether or not is the string suffixed.
+     * @param delimiter The delimiter.
+     * @param tokens The tokens.
      */
-    static bool is_suffixed(const std::string string, const std::string suffix) {
-        return string.size() >= suffix.size() && 0 == string.compare(string.size() - suffix.size(), suffix.size(), suffix);
+    static void split(const std::string_view string, const char delimiter, std::vector<std::string_view> & tokens) {
+        std::size_t start = 0, end = 0;
+
+        tokens.clear();
+
+        while(start < string.size()) {
+            end = string.find(delimiter, start);
+
+            if(end == std::string_view::npos) {
+                end = string.size();
+            }
+
+            if(end > start) {
+                tokens.push_back(string.substr(start, end - start));
+            }
+
+            start = end + 1;
+        }
     }
 
     /**
-     * @brief Splits a string into tokens.
-     * @param string The string.
-     * @param delimiter The delimiter
-     * @return The tokens.
-     * @note Solution from https://stackoverflow.com/questions/14265581.
+     * @brief Parses a number without throwing. A leading "+" is allowed but a leading "-" is rejected, the values
+     *        are unsigned, and hexadecimal numbers can be prefixed with "0x".
+     * @param text The text, which must be the number alone.
+     * @param value The value, untouched if the text can't be parsed.
+     * @param base The base.
+     * @return Whether or not the text is a number that fits the value.
      */
-    static std::vector<std::string> split(const std::string string, const std::string delimiter) {
-        std::size_t start = 0, end = 0, size = delimiter.size();
-        std::string token;
-        std::vector<std::string> tokens;
+    template<typename Integer>
+    static bool parse_number(std::string_view text, Integer & value, const int base = 16) noexcept {
+        std::uint64_t parsed = 0;
+
+        if(!text.empty() && text.front() == '+') {
+            text.remove_prefix(1);
+        }
 
-        while((end = string.find(delimiter, start)) != std::string::npos) {
-            token = string.substr(start, end - start);
-            start = end + size;
-            tokens.push_back(token);
+        if(base == 16 && text.size() > 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) {
+            text.remove_prefix(2);
         }
 
-        tokens.push_back(string.substr(start));
+        std::from_chars_result result = std::from_chars(text.data(), text.data() + text.size(), parsed, base);
+
+        if(text.empty() || result.ec != std::errc() || result.ptr != text.data() + text.size() || parsed > std::numeric_limits<Integer>::max()) {
+            return false;
+        }
+
+        value = static_cast<Integer> (parsed);
+
+        return true;
+    }
+
+    /**
+     * @brief Commands of the console.
+     */
+    enum class Command : std::uint8_t {
+        None, LoadAt, Load, Save, Dump, Jump, Get, Set, Step, Run, Dispatch, Cache, Attach, Protect, MemBench, HexBench,
+        Batch, Snapshot, Restore, Trace, Break, Watch, Fill, Copy, Find, Diff, Bench, Profile, Clock, Reset, Irq, Nmi,
+        Timer, SaveState, LoadState, Swarm, Disasm, Asm, Assemble, Journal, Replay, Analyze, Stats, Help, Exit
+    };
+
+    /**
+     * @brief Identifies a command by its name, comparing only against the names of the same length.
+     * @param name The name, like "-load".
+     * @return The command, None if there isn't one with that name.
+     */
+    static Command parse_command(const std::string_view name) noexcept {
+        switch(name.size()) {
+            case 4:
+                if(name == "-get") return Command::Get;
+                if(name == "-set") return Command::Set;
+                if(name == "-run") return Command::Run;
+                if(name == "-irq") return Command::Irq;
+                if(name == "-nmi") return Command::Nmi;
+                if(name == "-asm") return Command::Asm;
+                break;
+
+            case 5:
+                if(name == "-load") return Command::Load;
+                if(name == "-save") return Command::Save;
+                if(name == "-dump") return Command::Dump;
+                if(name == "-jump") return Command::Jump;
+                if(name == "-step") return Command::Step;
+                if(name == "-fill") return Command::Fill;
+                if(name == "-copy") return Command::Copy;
+                if(name == "-find") return Command::Find;
+                if(name == "-diff") return Command::Diff;
+                if(name == "-help") return Command::Help;
+                if(name == "-exit") return Command::Exit;
+                if(name == "-quit") return Command::Exit;
+                break;
+
+            case 6:
+                if(name == "-cache") return Command::Cache;
+                if(name == "-stats") return Command::Stats;
+                if(name == "-batch") return Command::Batch;
+                if(name == "-trace") return Command::Trace;
+                if(name == "-break") return Command::Break;
+                if(name == "-watch") return Command::Watch;
+                if(name == "-bench") return Command::Bench;
+                if(name == "-clock") return Command::Clock;
+                if(name == "-reset") return Command::Reset;
+                if(name == "-timer") return Command::Timer;
+                if(name == "-swarm") return Command::Swarm;
+                break;
+
+            case 7:
+                if(name == "-attach") return Command::Attach;
+                if(name == "-disasm") return Command::Disasm;
+                if(name == "-replay") return Command::Replay;
+                break;
+
+            case 8:
+                if(name == "-load-at") return Command::LoadAt;
+                if(name == "-profile") return Command::Profile;
+                if(name == "-protect") return Command::Protect;
+                if(name == "-restore") return Command::Restore;
+                if(name == "-journal") return Command::Journal;
+                if(name == "-analyze") return Command::Analyze;
+                break;
+
+            case 9:
+                if(name == "-dispatch") return Command::Dispatch;
+                if(name == "-membench") return Command::MemBench;
+                if(name == "-hexbench") return Command::HexBench;
+                if(name == "-snapshot") return Command::Snapshot;
+                if(name == "-assemble") return Command::Assemble;
+                break;
+
+            case 10:
+                if(name == "-savestate") return Command::SaveState;
+                if(name == "-loadstate") return Command::LoadState;
+                break;
+
+            default:
+                break;
+        }
 
-        return tokens;
+        return Command::None;
     }
 
-    class Memory {
+    class Batched : public std::streambuf {
         public:
             /**
              * @brief Constructor.
+             * @param target The buffer the output finally goes to.
              */
-            Memory() {
-                this->data = new std::uint8_t[0x10000]();
+            Batched(std::streambuf * target) {
+                this->target = target;
+                this->setp(this->buffer.data(), this->buffer.data() + this->buffer.size());
             }
 
             /**
-             * @brief Get a byte from a specific address.
-             * @param address The address of the byte.
-             * @return The byte
+             * @brief Destructor.
              */
-            std::uint8_t get(const std::uint16_t address) const noexcept {
-                return this->data[address];
+            ~Batched() noexcept {
+                this->drain();
             }
 
             /**
-             * @brief Set a byte from a specific address to a specific value.
-             * @param address The address
-             * @param value The value.
-             * @return Self-reference.
+             * @brief Passes everything buffered so far to the target and flushes it.
              */
-            Memory & set(const std::uint16_t address, const std::uint8_t value) noexcept {
-                this->data[address] = value;
-                return *this;
+            void drain() {
+                this->target->sputn(this->pbase(), this->pptr() - this->pbase());
+                this->target->pubsync();
+                this->setp(this->buffer.data(), this->buffer.data() + this->buffer.size());
             }
 
+        protected:
             /**
-             * @brief Loads the contents of a binary file into the ROM.
-             * @param path The path to the file.
-             * @return If the operation was successful.
+             * @brief Drains the full buffer and takes the character that didn't fit.
+             * @param character The character.
+             * @return Anything but EOF.
              */
-            bool load(const std::string path) {
-                std::ifstream file = std::ifstream(path, std::ios::binary);
-
-                if(!file.is_open()) {
-                    std::cerr << "\tFile at \"" << path << "\" not found." << std::endl;
-                    return false;
-                }
+            int overflow(const int character) override {
+                this->drain();
 
-                if(!file.read(reinterpret_cast<char *> (&this->data[0x8000]), 0x8000)) {
-                    std::cerr << "\tFile at \"" << path << "\" can't be loaded." << std::endl;
-                    return false;
+                if(character != traits_type::eof()) {
+                    this->sputc(character);
                 }
 
-                file.close();
-
-                return true;
+                return traits_type::not_eof(character);
             }
 
             /**
-             * @brief Saves the contents of the ROM into a binary file.
-             * @param path The path to the file.
-             * @return If the operation was successful.
+             * @brief Ignores the flush requests (std::endl), the output only goes out in whole buffers.
+             * @return 0, always successful.
              */
-            bool save(const std::string path) const {
-                std::ofstream file = std::ofstream(path, std::ios::binary);
-
-                if(!file.is_open()) {
-                    std::cerr << "\tFile at \"" << path << "\" not found." << std::endl;
-                    return false;
-                }
-
-                if(!file.write(reinterpret_cast<char *> (&this->data[0x8000]), 0x8000)) {
-                    std::cerr << "\tFile at \"" << path << "\" can't be saved." << std::endl;
-                    return false;
-                }
-
-                file.close();
-
-                return true;
+            int sync() override {
+                return 0;
             }
 
         private:
             /**
-             * @brief Internal representation of the memory.
+             * @brief Output not yet passed to the target.
              */
-            std::uint8_t * data;
-    };
+            std::array<char, 0x10000> buffer;
 
-    class Machine {
-        public:
             /**
-             * @brief Constructor.
+             * @brief The buffer the output finally goes to.
              */
-            Machine() noexcept {
-                this->a_register = 0x00;
-                this->x_register = 0x00;
-                this->y_register = 0x00;
-                this->s_register = 0x00;
-                this->i_pointer = 0x8000;
-                this->s_pointer = 0xFF;
-                this->memory = Memory();
-            }
+            std::streambuf * target;
+    };
 
-            ~Machine() noexcept {
-                this->memory.~Memory();
-            }
+    /**
+     * @brief Job of a batch: one machine running one ROM with one input.
+     */
+    struct Job {
+        /**
+         * @brief Path to the ROM.
+         */
+        std::string rom;
+
+        /**
+         * @brief Maximum number of cycles to run.
+         */
+        std::uint64_t max_cycles;
+
+        /**
+         * @brief Path to the file fed to the console, empty for none.
+         */
+        std::string input;
+
+        /**
+         * @brief Page the console is attached to.
+         */
+        std::uint8_t console_page;
+
+        //--------------------------------------------------//
+        // Results
+        //--------------------------------------------------//
+
+        /**
+         * @brief Why the job stopped: "halted" (illegal opcode), "limit" (max cycles) or "error" (ROM or input not loaded).
+         */
+        std::string exit_reason;
+
+        /**
+         * @brief Why the job couldn't run, printed once every job is done so the workers never write to std::cerr.
+         */
+        std::string error;
+
+        /**
+         * @brief Registers and pointers when the job stopped: AR, XR, YR, SR, SP and IP.
+         */
+        std::uint8_t registers[5];
+        std::uint16_t i_pointer;
+
+        /**
+         * @brief Cycles and instructions the job ran.
+         */
+        std::uint64_t cycles;
+        std::uint64_t instructions;
+    };
 
-            /**
-             * @brief Loads the contents of a binary file into the ROM.
-             * @param path The path to the file.
-             * @return If the operation was successful.
-             */
-            bool load(const std::string path) {
-                return this->memory.load(path);
-            }
+    /**
+     * @brief Runs a batch of jobs on all the host cores and writes their results.
+     * @param manifest Path to the manifest, one "<rom> [max_cycles] [input] [console_page]" job per line ('#' comments).
+     * @param results Path to the results file, one line per job in the manifest order.
+     * @return If the operation was successful.
+     */
+    static bool run_batch(const std::string manifest, const std::string results) {
+        std::ifstream manifest_file = std::ifstream(manifest);
+        std::string line;
+        std::vector<std::string_view> fields;
+        std::vector<Job> jobs;
+
+        if(!manifest_file.is_open()) {
+            std::cerr << "\tFile at \"" << manifest << "\" not found." << std::endl;
+            return false;
+        }
 
-            /**
-             * @brief Saves the contents of the ROM into a binary file.
-             * @param path The path to the file.
-             * @return If the operation was successful.
-             */
-            bool save(const std::string path) const {
-                return this->memory.save(path);
+        while(std::getline(manifest_file, line)) {
+            Job job = Job();
+
+            split(line, ' ', fields);
+
+            if(fields.empty() || is_prefixed(fields.at(0), "#")) {
+                continue;
             }
 
-            /**
-             * @brief Dumps the state of the machine into a text file. This is useful when some kind of error occurs.
-             * @param path The path to the file.
-             * @return If the operation was successful.
-             */
-            bool dump(const std::string path) const {
-                std::ofstream file = std::ofstream(path);
+            job.rom = fields.at(0);
+            job.max_cycles = 0x100000;
+            job.input = fields.size() > 2 ? fields.at(2) : "";
+            job.console_page = 0x40;
 
-                if(!file.is_open()) {
-                    std::cerr << "\tFile at \"" << path << "\" not found." << std::endl;
-                    return false;
-                }
-
-                file << "Registers" << std::endl;
-                file << "----------------------------------------------------------------------" << std::endl;
-                file << "AR: " << format_hex(this->a_register);
-                file << "  ";
-                file << "XR: " << format_hex(this->x_register);
-                file << "  ";
-                file << "YR: " << format_hex(this->y_register);
-                file << "  ";
-                file << "SR: " << format_hex(this->s_register);
-                file << std::endl;
-                file << std::endl;
-                file << "Pointers" << std::endl;
-                file << "----------------------------------------------------------------------" << std::endl;
-                file << "IP: " << format_hex(this->i_pointer) << " -> (" << format_hex(this->memory.get(this->i_pointer), 2) << ")";
-                file << "  ";
-                file << "SP: " << format_hex(this->s_pointer) << " -> (" << format_hex(this->memory.get(0x0100 + this->s_pointer), 2) << ")";
-                file << std::endl;
-                file << std::endl;
-                file << "Memory Contents (Near IP):" << std::endl;
-                file << "----------------------------------------------------------------------" << std::endl;
-
-                for(std::uint32_t address = this->i_pointer; address <= (this->i_pointer + 0x00FF);) {
-                    std::string hex_view = "";
-                    std::string char_view = "";
-
-                    for(std::uint32_t scan_address = address; scan_address <= (address + 0xF); scan_address++) {
-                        if(scan_address > 0xFFFF) { // If the currently scanned address is greater than 0xFFFF,
-                            hex_view += "   ";      // display
-                            char_view += ' ';       // spaces.
-                        } else {                    // Else, get the actual value and display it.
-                            std::uint8_t value = this->memory.get(scan_address);
-
-                            hex_view += format_hex(value, 2); // Convert the value to his hexadecimal representation and display it.
-                            hex_view += ' ';
-
-                            if(!std::isprint(value)) { // If the value is not displayable,
-                                char_view += '.';      // display a '.'.
-                            }  else {                  // Else, convert the value to his character representation
-                                char_view += value;    // and display it.
-                            }
-                        }
-                    }
+            if((fields.size() > 1 && !parse_number(fields.at(1), job.max_cycles)) || (fields.size() > 3 && !parse_number(fields.at(3), job.console_page))) {
+                std::cerr << "\tCan't parse line " << (jobs.size() + 1) << " of the manifest \"" << line << "\"." << std::endl;
+                return false;
+            }
 
-                    file << hex_view << "\t" << char_view << std::endl; // Display the hexadecimal and character representation of the values on.
+            jobs.push_back(job);
+        }
 
-                    address += 0x10;
+        Pool pool = Pool();
+        auto start = std::chrono::steady_clock::now();
 
-                    if(address > 0xFFFF) { // If the address is greater than 0xFFFF,
-                        break;             // stop.
-                    }
-                }
+        pool.run(jobs.size(), [&jobs](std::size_t index) { // Each job only touches its own entry and its own machine.
+            Job & job = jobs[index];
+            std::unique_ptr<Machine> machine = std::make_unique<Machine>();
+            std::ostringstream output, errors;
 
-                return true;
-            }
+            job.exit_reason = "error";
 
-            Memory & reference_memory() noexcept {
-                return this->memory;
+            if(!machine->load(job.rom, true, errors)) {
+                job.error = errors.str();
+                return;
             }
 
-            std::uint8_t & reference_a_register() noexcept {
-                return this->a_register;
-            }
+            if(!job.input.empty()) {
+                std::ifstream input_file = std::ifstream(job.input, std::ios::binary);
 
-            std::uint8_t & reference_x_register() noexcept {
-                return this->x_register;
-            }
+                if(!input_file.is_open()) {
+                    job.error = "\tFile at \"" + job.input + "\" not found.\n";
+                    return;
+                }
 
-            std::uint8_t & reference_y_register() noexcept {
-                return this->y_register;
-            }
+                std::string input = std::string(std::istreambuf_iterator<char>(input_file), std::istreambuf_iterator<char>());
 
-            std::uint8_t & reference_s_register() noexcept {
-                return this->s_register;
+                machine->reference_memory().attach(job.console_page, job.console_page, std::make_shared<Console>(output, input));
             }
 
-            std::uint16_t & reference_i_pointer() noexcept {
-                return this->i_pointer;
-            }
+            job.instructions = machine->run(job.max_cycles);
+            job.exit_reason = machine->is_halted() ? "halted" : "limit";
+            job.registers[0] = machine->reference_a_register();
+            job.registers[1] = machine->reference_x_register();
+            job.registers[2] = machine->reference_y_register();
+            job.registers[3] = machine->reference_s_register();
+            job.registers[4] = machine->reference_s_pointer();
+            job.i_pointer = machine->reference_i_pointer();
+            job.cycles = machine->reference_cycles();
+        });
+
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::ofstream results_file = std::ofstream(results);
+        std::uint64_t instructions = 0;
+
+        for(const Job & job : jobs) {
+            std::cerr << job.error;
+        }
 
-            std::uint8_t & reference_s_pointer() noexcept{
-                return this->s_pointer;
-            }
+        if(!results_file.is_open()) {
+            std::cerr << "\tFile at \"" << results << "\" not found." << std::endl;
+            return false;
+        }
 
-        private:
-            //--------------------------------------------------//
-            // Registers
-            //--------------------------------------------------//
+        for(const Job & job : jobs) {
+            results_file << job.rom << " " << job.exit_reason;
 
-            /**
-             * @brief A (Accumulator) Register: The accumulator, one of the most used registers.
-             */
-            std::uint8_t a_register;
+            if(job.exit_reason != "error") {
+                results_file << " AR: " << format_hex(job.registers[0], 2) << " XR: " << format_hex(job.registers[1], 2) << " YR: " << format_hex(job.registers[2], 2);
+                results_file << " SR: " << format_hex(job.registers[3], 2) << " IP: " << format_hex(job.i_pointer) << " SP: " << format_hex(job.registers[4], 2);
+                results_file << " Cycles: " << job.cycles << " Instructions: " << job.instructions;
+                instructions += job.instructions;
+            }
 
-            /**
-             * @brief X Register: General purpose register.
-             */
-            std::uint8_t x_register;
+            results_file << "\n";
+        }
 
-            /**
-             * @brief Y Register: General purpose register.
-             */
-            std::uint8_t y_register;
+        std::cout << "\tRan " << jobs.size() << " job(s) on " << pool.count_workers() << " worker(s) in " << std::fixed << std::setprecision(3) << seconds << std::defaultfloat << " second(s)." << std::endl;
+        std::cout << "\tAggregate speed: " << static_cast<std::uint64_t>(seconds > 0 ? instructions / seconds : 0) << " instruction(s) per second." << std::endl;
 
-            /**
-             * @brief S (Status) Register: The status, holds the current status of the machine.
-             */
-            std::uint8_t s_register;
+        return true;
+    }
 
-            //--------------------------------------------------//
-            // Pointers
-            //--------------------------------------------------//
+    /**
+     * @brief Analyzes ROM images on all the host cores and reports each one: blocks, code, unreached bytes,
+     *        self-modifying writes and illegal opcodes reached, in the given order.
+     * @param paths Paths to the ROM images.
+     * @return If every image was loaded.
+     */
+    static bool analyze_roms(const std::vector<std::string> & paths) {
+        std::vector<std::string> reports = std::vector<std::string>(paths.size());
+        std::vector<std::string> errors = std::vector<std::string>(paths.size());
+        std::vector<std::uint8_t> is_loaded = std::vector<std::uint8_t>(paths.size(), false);
+        Pool pool = Pool();
+        auto start = std::chrono::steady_clock::now();
+
+        pool.run(paths.size(), [&](std::size_t index) { // Each image only touches its own memory, report and error.
+            std::unique_ptr<Memory> memory = std::make_unique<Memory>();
+            std::ostringstream error;
+
+            if(!memory->load(paths[index], false, error)) {
+                errors[index] = error.str();
+                return;
+            }
 
-            /**
-             * @brief Instruction Pointer: Points to the location of the current instruction in the memory.
-             */
-            std::uint16_t i_pointer;
+            Analysis analysis = Analysis(*memory);
+            std::vector<std::pair<std::uint16_t, std::uint16_t>> unreached = analysis.get_unreached(*memory);
+            std::uint32_t unreached_bytes = 0;
+            std::string & report = reports[index];
 
-            /**
-             * @brief Stack Pointer: Points to the location of the current stack value.
-             */
-            std::uint8_t s_pointer;
+            for(const std::pair<std::uint16_t, std::uint16_t> & range : unreached) {
+                unreached_bytes += range.second - range.first + 1;
+            }
 
-            //--------------------------------------------------//
-            // Storage
-            //--------------------------------------------------//
+            report = std::to_string(analysis.get_blocks().size()) + " block(s), " + std::to_string(analysis.count_code()) + " byte(s) of code, " + std::to_string(unreached_bytes) + " unreached, ";
+            report += std::to_string(analysis.get_writes().size()) + " self-modifying write(s), " + std::to_string(analysis.get_illegal().size()) + " illegal opcode(s) reached";
 
-            /**
-             * @brief Memory : Holds all the data, this includes the ROM and the RAM.
-             */
-            Memory memory;
-    };
-}
+            for(const Analysis::Vector & vector : analysis.get_vectors()) {
+                if(vector.is_set && !vector.is_reached) {
+                    report += ", " + std::string(vector.name) + " vector to an illegal opcode";
+                }
+            }
 
+            is_loaded[index] = true;
+        });
 
-//--------------------------------------------------//
-// Main Code
-//--------------------------------------------------//
-int main(int argc, const char * argv[]) {
-    Rhea::Machine machine = Rhea::Machine();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
 
-    std::cout << "Rhea [Version: " << __RHEA_VERSION__ << "]" << std::endl;
-    std::cout << "----------------------------------------------------------------------" << std::endl;
+        for(std::size_t index = 0; index < paths.size(); index++) {
+            if(is_loaded[index]) {
+                std::cout << "\t" << paths[index] << ": " << reports[index] << "." << std::endl;
+            } else {
+                std::cerr << errors[index];
+            }
+        }
 
-    bool is_option_none, is_option_1, is_option_2, is_option_3, is_option_4, is_option_5, is_option_6, is_option_7, is_option_8;
-    std::uint8_t byte_1, byte_2;
-    std::uint16_t word_1, word_2;
-    std::string command, command_arg_1, command_arg_2, command_arg_3, command_arg_4;
-    std::vector<std::string> command_varargs;
+        std::cout << "\tAnalyzed " << std::count(is_loaded.begin(), is_loaded.end(), true) << " of " << paths.size() << " ROM(s) on " << pool.count_workers() << " worker(s) in " << std::fixed << std::setprecision(3) << seconds * 1e3 << std::defaultfloat << " ms." << std::endl;
 
-    while(true) {
-        std::cout << "> ";
-        std::getline(std::cin, command);
+        return std::count(is_loaded.begin(), is_loaded.end(), false) == 0;
+    }
 
-        if(Rhea::is_prefixed(command, "-load")) {
-            command_varargs = Rhea::split(command, " ");
+    /**
+     * @brief Measures random reads and writes on the RAM pages of a memory bus against the same accesses on a flat array.
+     * @param count The number of reads and writes.
+     * @return The nanoseconds per read and write of the bus and of the array, negative if their contents differ.
+     */
+    static std::pair<double, double> benchmark_memory(const std::uint64_t count) {
+        Memory bus = Memory();
+        std::vector<std::uint8_t> flat = std::vector<std::uint8_t>(0x10000);
+        std::uint32_t address = 1;
 
-            if(command_varargs.size() < 2) {
-                command_arg_1 = "rom.bin";
+        bus.protect(0x80, 0xFF, true); // Same layout as a loaded ROM, so only the RAM pages take the fast path.
 
-                std::cout << "\tUsing default value \"" << command_arg_1 << "\" of argument #1 of this command." << std::endl;
-            } else {
-                command_arg_1 = command_varargs.at(1);
-            }
+        for(std::uint16_t page = 0x00; page < 0x80; page++) { // Marks the RAM pages dirty up front, like after any real run.
+            bus.set(page << 8, 0x00);
+        }
 
-            if(machine.load(command_arg_1)) {
-                std::cout << "\tLoaded the \"" << command_arg_1 << "\" file correctly." << std::endl;
-            }
+        auto start = std::chrono::steady_clock::now();
 
-            continue;
+        for(std::uint64_t index = 0; index < count; index++) {
+            address = (address * 1103515245 + 12345) & 0x7FFF;
+            bus.set(address ^ 0x55, bus.get(address) + 1);
         }
 
-        if(Rhea::is_prefixed(command, "-save")) {
-            command_varargs = Rhea::split(command, " ");
+        double bus_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
 
-            if(command_varargs.size() < 2) {
-                command_arg_1 = "rom.bin";
+        start = std::chrono::steady_clock::now();
+        address = 1;
 
-                std::cout << "\tUsing default value \"" << command_arg_1 << "\" of argument #1 of this command." << std::endl;
-            } else {
-                command_arg_1 = command_varargs.at(1);
-            }
+        for(std::uint64_t index = 0; index < count; index++) {
+            address = (address * 1103515245 + 12345) & 0x7FFF;
+            flat[address ^ 0x55] = flat[address] + 1;
+        }
 
-            if(machine.save(command_arg_1)) {
-                std::cout << "\tSaved the \"" << command_arg_1 << "\" file correctly." << std::endl;
-            }
+        double flat_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
 
-            continue;
+        for(std::uint32_t index = 0; index < 0x8000; index++) {
+            if(bus.get(index) != flat[index]) {
+                return { -1, -1 };
+            }
         }
 
-        if(Rhea::is_prefixed(command, "-dump")) {
-            command_varargs = Rhea::split(command, " ");
+        return { bus_seconds * 1e9 / count, flat_seconds * 1e9 / count };
+    }
 
-            if(command_varargs.size() < 2) {
-                command_arg_1 = "machine.dmp";
+    /**
+     * @brief Measures full memory dumps against the same text built with a string stream per value and appended
+     *        character by character, the way dumps used to be built.
+     * @param count The number of dumps.
+     * @return The microseconds per dump of the table encoder and of the string streams, negative if their texts differ.
+     */
+    static std::pair<double, double> benchmark_dump(const std::uint64_t count) {
+        Machine machine = Machine();
+        std::string text, reference;
+        std::size_t length = 0;
 
-                std::cout << "\tUsing default value \"" << command_arg_1 << "\" of argument #1 of this command." << std::endl;
-            } else {
-                command_arg_1 = command_varargs.at(1);
-            }
+        for(std::uint32_t address = 0x0000; address <= 0xFFFF; address++) { // Every value, printable or not.
+            machine.reference_memory().set(address, (address * 7) ^ (address >> 8));
+        }
 
-            if(machine.dump(command_arg_1)) {
-                std::cout << "\tDumped the machine into the \"" << command_arg_1 << "\" file correctly." << std::endl;
-            }
+        auto start = std::chrono::steady_clock::now();
 
-            continue;
+        for(std::uint64_t index = 0; index < count; index++) {
+            text.clear();
+            machine.format_dump(text, true);
+            length += text.size();
         }
 
-        if(Rhea::is_prefixed(command, "-jump")) {
-            command_varargs = Rhea::split(command, " ");
+        double table_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
 
-            if(command_varargs.size() < 2) {
-                command_arg_1 = "0000";
+        start = std::chrono::steady_clock::now();
 
-                std::cout << "\tUsing default value \"" << command_arg_1 << "\" of argument #1 of this command." << std::endl;
-            } else {
-                command_arg_1 = command_varargs.at(1);
-            }
+        for(std::uint64_t index = 0; index < count; index++) {
+            reference.clear();
 
-            is_option_1 = Rhea::is_prefixed(command_arg_1, "+");
-            is_option_2 = Rhea::is_prefixed(command_arg_1, "-");
+            for(std::uint32_t address = 0x0000; address <= 0xFFFF; address += 0x10) {
+                std::stringstream converter;
+                std::string hex_view = "";
+                std::string char_view = "";
 
-            try {
-                word_1 = std::labs(std::stol(command_arg_1, 0, 16));
-            } catch(...) {
-                std::cerr << "\tCan't parse argument #1 value \"" << command_arg_1 << "\"." << std::endl;
-                continue;
-            }
+                converter << std::setfill('0') << std::setw(4) << std::uppercase << std::hex << address;
 
-            if(is_option_1 || is_option_2) {
-                std::cout << "\tJumped to the \"" << Rhea::format_hex(machine.reference_i_pointer()) << "\"" << (is_option_2 ? " - " : " + ") << "\"" << Rhea::format_hex(word_1) << "\" address successfully." << std::endl;
+                for(std::uint32_t scan_address = address; scan_address <= (address + 0xF); scan_address++) {
+                    std::stringstream value_converter;
+                    std::uint8_t value = machine.reference_memory().get(scan_address);
 
-                if(is_option_1) {
-                    machine.reference_i_pointer() += word_1;
-                }
+                    value_converter << std::setfill('0') << std::setw(2) << std::uppercase << std::hex << +value;
 
-                if(is_option_2) {
-                    machine.reference_i_pointer() -= word_1;
+                    hex_view += value_converter.str();
+                    hex_view += ' ';
+                    char_view += std::isprint(value) ? value : '.';
                 }
 
-                continue;
+                reference += converter.str() + "  " + hex_view + "\t" + char_view + "\n";
             }
 
-            machine.reference_i_pointer() = word_1;
+            length += reference.size();
+        }
 
-            std::cout << "\tJumped to the \"" << Rhea::format_hex(word_1) << "\" address successfully." << std::endl;
-            continue;
+        double stream_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        if(length == 0 || text.compare(text.size() - reference.size(), reference.size(), reference) != 0) {
+            return { -1, -1 };
         }
 
-        if(Rhea::is_prefixed(command, "-get")) {
-            command_varargs = Rhea::split(command, " ");
+        return { table_seconds * 1e6 / count, stream_seconds * 1e6 / count };
+    }
+
+    /**
+     * @brief The result of a workload of the benchmark suite.
+     */
+    struct Benchmark {
+        /**
+         * @brief Name of the workload.
+         */
+        std::string name;
+
+        /**
+         * @brief Instructions and cycles emulated, and the host time they took.
+         */
+        std::uint64_t instructions;
+        std::uint64_t cycles;
+        double seconds;
+    };
+
+    /**
+     * @brief Synthetic ROMs of the benchmark suite, each one an endless loop starting at 8000.
+     */
+    static const std::pair<const char *, std::vector<std::uint8_t>> benchmark_roms[] = {
+        { "alu", {              // Arithmetic and logic on the registers only.
+            0xA9, 0x00,         // 8000: LDA #00
+            0x18,               // 8002: CLC
+            0x69, 0x01,         // 8003: ADC #01
+            0x49, 0x55,         // 8005: EOR #55
+            0x0A,               // 8007: ASL A
+            0xE8,               // 8008: INX
+            0xC8,               // 8009: INY
+            0x4C, 0x02, 0x80    // 800A: JMP 8002
+        } },
+        { "copy", {             // Copies the 0200 page into the 0300 page over and over.
+            0xA2, 0x00,         // 8000: LDX #00
+            0xBD, 0x00, 0x02,   // 8002: LDA 0200,X
+            0x9D, 0x00, 0x03,   // 8005: STA 0300,X
+            0xE8,               // 8008: INX
+            0xD0, 0xF7,         // 8009: BNE 8002
+            0x4C, 0x00, 0x80    // 800B: JMP 8000
+        } },
+        { "branch", {           // Taken and not taken branches, alternating on the low bit of XR.
+            0xE8,               // 8000: INX
+            0x8A,               // 8001: TXA
+            0x29, 0x01,         // 8002: AND #01
+            0xF0, 0x03,         // 8004: BEQ 8009
+            0xC8,               // 8006: INY
+            0xD0, 0xF7,         // 8007: BNE 8000
+            0x88,               // 8009: DEY
+            0x30, 0xF4,         // 800A: BMI 8000
+            0x10, 0xF2          // 800C: BPL 8000
+        } },
+        { "stack", {            // Nested JSR/RTS chains with pushes and pulls at the bottom.
+            0x20, 0x06, 0x80,   // 8000: JSR 8006
+            0x4C, 0x00, 0x80,   // 8003: JMP 8000
+            0x20, 0x0A, 0x80,   // 8006: JSR 800A
+            0x60,               // 8009: RTS
+            0x20, 0x0E, 0x80,   // 800A: JSR 800E
+            0x60,               // 800D: RTS
+            0x48,               // 800E: PHA
+            0xE8,               // 800F: INX
+            0x68,               // 8010: PLA
+            0x60                // 8011: RTS
+        } }
+    };
 
-            if(command_varargs.size() < 2) {
-                command_arg_1 = "0000";
+    /**
+     * @brief Runs copies of a machine for a number of cycles and keeps the fastest run, so the result depends as
+     *        little as possible on what else the host is doing.
+     * @param name The name of the workload.
+     * @param machine The machine, left untouched, its devices are left out of the runs.
+     * @param max_cycles The cycles of each run.
+     * @param repeats The number of runs.
+     * @param metrics The counters the copies update, null for none.
+     * @param is_paged If the copies also count the memory accesses of each page.
+     * @return The fastest run.
+     */
+    static Benchmark benchmark_machine(const std::string name, const Machine & machine, const std::uint64_t max_cycles, const std::uint8_t repeats = 3, Metrics * metrics = nullptr, const bool is_paged = false) {
+        Benchmark benchmark = Benchmark { name, 0, 0, 0 };
 
-                std::cout << "\tUsing default value \"" << command_arg_1 << "\" of argument #1 of this command." << std::endl;
-            } else {
-                command_arg_1 = command_varargs.at(1);
-            }
+        for(std::uint8_t repeat = 0; repeat < repeats; repeat++) {
+            std::unique_ptr<Machine> copy = std::make_unique<Machine>(machine);
 
-            is_option_1 = command_arg_1 == "ar";
-            is_option_2 = command_arg_1 == "xr";
-            is_option_3 = command_arg_1 == "yr";
-            is_option_4 = command_arg_1 == "sr";
-            is_option_5 = command_arg_1 == "ip";
-            is_option_6 = command_arg_1 == "sp";
-            is_option_none = !(is_option_1 || is_option_2 || is_option_3 || is_option_4 || is_option_5 || is_option_6);
+            copy->detach();
 
-            try {
-                word_1 = is_option_none ? std::labs(std::stol(command_arg_1, 0, 16)) : 0x0000;
-            } catch(...) {
-                std::cerr << "\tCan't parse argument #1 value \"" << command_arg_1 << "\"." << std::endl;
-                continue;
+            if(metrics != nullptr) {
+                copy->set_metrics(metrics);
+                copy->reference_memory().set_metrics(is_paged ? metrics : nullptr);
             }
 
-            word_2 = is_option_none ? machine.reference_memory().get(word_1) : 0x0000;
+            std::uint64_t start_cycles = copy->reference_cycles();
 
-            if(!is_option_none) {
-                if(is_option_1) {
-                    word_2 = machine.reference_a_register();
-                }
-
-                if(is_option_2) {
-                    word_2 = machine.reference_x_register();
-                }
+            auto start = std::chrono::steady_clock::now();
+            std::uint64_t executed = copy->run(max_cycles);
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
 
-                if(is_option_3) {
-                    word_2 = machine.reference_y_register();
-                }
+            if(repeat == 0 || seconds < benchmark.seconds) {
+                benchmark.instructions = executed;
+                benchmark.cycles = copy->reference_cycles() - start_cycles;
+                benchmark.seconds = seconds;
+            }
+        }
 
-                if(is_option_4) {
-                    word_2 = machine.reference_s_register();
-                }
+        return benchmark;
+    }
 
-                if(is_option_5) {
-                    word_2 = machine.reference_i_pointer();
-                }
+    /**
+     * @brief Runs the benchmark suite: the synthetic ROMs, the loaded machine if any and the memory bus. Prints the
+     *        results and writes them as JSON, tagged with the version, so runs of different versions can be compared.
+     *        The synthetic ROMs run again with the metrics counting, to check they cost nothing measurable.
+     * @param loaded The loaded machine, null for none.
+     * @param max_cycles The cycles each workload runs, also the number of memory accesses.
+     * @param path The path to the JSON file.
+     * @return If the operation was successful.
+     */
+    static bool run_benchmarks(const Machine * loaded, const std::uint64_t max_cycles, const std::string path) {
+        std::vector<Benchmark> benchmarks;
+        std::unique_ptr<Metrics> metrics = std::make_unique<Metrics>();
+        double plain_seconds = 0, metered_seconds = 0, paged_seconds = 0;
 
-                if(is_option_6) {
-                    word_2 = machine.reference_s_pointer();
-                }
+        for(const std::pair<const char *, std::vector<std::uint8_t>> & rom : benchmark_roms) {
+            std::unique_ptr<Machine> synthetic = std::make_unique<Machine>();
 
-                std::cout << "\tThe value of \"" << command_arg_1 << "\" is \"" << Rhea::format_hex(word_2, (is_option_5 ? 4 : 2)) << "\"." << std::endl;
-                continue;
+            for(std::size_t index = 0; index < rom.second.size(); index++) {
+                synthetic->reference_memory().set(0x8000 + index, rom.second[index]);
             }
 
-            std::cout << "\tThe value on the \"" << Rhea::format_hex(word_1) << "\" address is \"" << Rhea::format_hex(word_2, 2) << "\"." << std::endl;
-            continue;
+            benchmarks.push_back(benchmark_machine(rom.first, *synthetic, max_cycles));
+            plain_seconds += benchmarks.back().seconds;
+            metered_seconds += benchmark_machine(rom.first, *synthetic, max_cycles, 3, metrics.get()).seconds;
+            paged_seconds += benchmark_machine(rom.first, *synthetic, max_cycles, 3, metrics.get(), true).seconds;
         }
 
-        if(Rhea::is_prefixed(command, "-set")) {
-            command_varargs = Rhea::split(command, " ");
+        double metered_overhead = plain_seconds > 0 ? 100.0 * (metered_seconds - plain_seconds) / plain_seconds : 0;
+        double paged_overhead = plain_seconds > 0 ? 100.0 * (paged_seconds - plain_seconds) / plain_seconds : 0;
 
-            if(command_varargs.size() < 2) {
-                command_arg_1 = "0000";
+        if(loaded != nullptr) {
+            benchmarks.push_back(benchmark_machine("loaded", *loaded, max_cycles));
+        }
 
-                std::cout << "\tUsing default value \"" << command_arg_1 << "\" of argument #1 of this command." << std::endl;
-            } else {
-                command_arg_1 = command_varargs.at(1);
-            }
+        std::pair<double, double> memory = benchmark_memory(max_cycles);
+        std::ofstream file = std::ofstream(path);
 
-            if(command_varargs.size() < 3) {
-                command_arg_2 = "00";
+        if(!file.is_open()) {
+            std::cerr << "\tFile at \"" << path << "\" not found." << std::endl;
+            return false;
+        }
 
-                std::cout << "\tUsing default value \"" << command_arg_2 << "\" of argument #2 of this command." << std::endl;
-            } else {
-                command_arg_2 = command_varargs.at(2);
-            }
+        file << std::fixed << std::setprecision(3);
+        file << "{" << std::endl;
+        file << "  \"version\": \"" << __RHEA_VERSION__ << "\"," << std::endl;
+        file << "  \"max_cycles\": " << max_cycles << "," << std::endl;
+        file << "  \"workloads\": [" << std::endl;
 
-            is_option_1 = command_arg_1 == "ar";
-            is_option_2 = command_arg_1 == "xr";
-            is_option_3 = command_arg_1 == "yr";
-            is_option_4 = command_arg_1 == "sr";
-            is_option_5 = command_arg_1 == "ip";
-            is_option_6 = command_arg_1 == "sp";
-            is_option_none = !(is_option_1 || is_option_2 || is_option_3 || is_option_4 || is_option_5 || is_option_6);
+        for(std::size_t index = 0; index < benchmarks.size(); index++) {
+            const Benchmark & benchmark = benchmarks[index];
+            double rate = benchmark.seconds > 0 ? benchmark.instructions / benchmark.seconds : 0;
+            double host_ns = benchmark.instructions > 0 ? benchmark.seconds * 1e9 / benchmark.instructions : 0;
 
-            try {
-                word_1 = is_option_none ? std::labs(std::stol(command_arg_1, 0, 16)) : 0x0000;
-            } catch(...) {
-                std::cerr << "\tCan't parse argument #1 value \"" << command_arg_1 << "\"." << std::endl;
-                continue;
-            }
-            
-            try {
-                word_2 = std::labs(std::stol(command_arg_2, 0, 16));
-            } catch(...) {
-                std::cerr << "\tCan't parse argument #2 value \"" << command_arg_2 << "\"." << std::endl;
-                continue;
-            }
+            file << "    { \"name\": \"" << benchmark.name << "\", \"instructions\": " << benchmark.instructions << ", \"cycles\": " << benchmark.cycles;
+            file << ", \"seconds\": " << std::setprecision(6) << benchmark.seconds << std::setprecision(3);
+            file << ", \"instructions_per_second\": " << rate << ", \"ns_per_instruction\": " << host_ns << " }" << (index + 1 < benchmarks.size() ? "," : "") << std::endl;
 
-            if(!is_option_none) {
-                if(!is_option_5) {
-                    if(word_2 > 0xFF) {
-                        std::cerr << "\tArgument #2 is out of range." << std::endl;
-                        continue;
-                    }
+            std::cout << "\t" << std::left << std::setw(8) << benchmark.name << std::right << std::fixed << std::setprecision(0) << std::setw(12) << rate << " instruction(s) per second, ";
+            std::cout << std::setprecision(2) << host_ns << " ns per instruction." << std::defaultfloat << std::endl;
+        }
 
-                    if(is_option_1) {
-                        machine.reference_a_register() = word_2;
-                    }
+        file << "  ]," << std::endl;
+        file << "  \"memory\": { \"bus_ns\": " << memory.first << ", \"array_ns\": " << memory.second << " }," << std::endl;
+        file << "  \"metrics\": { \"overhead_percent\": " << metered_overhead << ", \"paged_overhead_percent\": " << paged_overhead << " }" << std::endl;
+        file << "}" << std::endl;
 
-                    if(is_option_2) {
-                        machine.reference_x_register() = word_2;
-                    }
+        std::cout << "\tMemory: " << std::fixed << std::setprecision(3) << memory.first << " ns per bus read and write, " << memory.second << " ns on an array." << std::defaultfloat << std::endl;
+        std::cout << "\tMetrics: " << std::fixed << std::setprecision(2) << metered_overhead << "% slower counting, " << paged_overhead << "% slower counting each page." << std::defaultfloat << std::endl;
 
-                    if(is_option_3) {
-                        machine.reference_y_register() = word_2;
-                    }
+        return true;
+    }
 
-                    if(is_option_4) {
-                        machine.reference_s_register() = word_2;
-                    }
+    /**
+     * @brief Runs copies of a machine as the lanes of a swarm and as separate machines, each getting its lane number
+     *        as input at an address. Checks every lane ends up as its machine did and prints both throughputs.
+     * @param machine The machine, its devices, timers and pending IRQs are left out of both runs.
+     * @param lanes The number of lanes.
+     * @param max_cycles The cycles each lane runs.
+     * @param address Where each lane gets its input, the low byte of its number.
+     * @return If every lane matched its machine.
+     */
+    static bool run_swarm(const Machine & machine, const std::uint32_t lanes, const std::uint64_t max_cycles, const std::uint16_t address) {
+        std::vector<Machine> machines = std::vector<Machine>(lanes, machine);
+        Swarm swarm = Swarm(machines.front(), lanes);
+
+        for(std::uint32_t lane = 0; lane < lanes; lane++) {
+            Machine & separate = machines[lane];
+            std::uint8_t input = lane & 0xFF;
+
+            separate.detach();
+            separate.reference_memory().load_bytes(address, &input, 1);
+            separate.clear_schedule();
+            separate.set_irq(Machine::Line::Requested, false);
+            swarm.patch(lane, address, input);
+        }
 
-                    if(is_option_6) {
-                        machine.reference_s_pointer() = word_2;
-                    }
-                }
+        auto start = std::chrono::steady_clock::now();
+        std::uint64_t separate_executed = 0;
 
-                machine.reference_i_pointer() = word_2;
+        for(Machine & separate : machines) {
+            separate_executed += separate.run(max_cycles);
+        }
 
-                std::cout << "\tThe value of \"" << command_arg_1 << "\" is now \"" << Rhea::format_hex(word_2, (is_option_5 ? 4 : 2)) << "\"." << std::endl;
-                continue;
-            }
+        double separate_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
 
-            machine.reference_memory().set(word_1, word_2);
+        start = std::chrono::steady_clock::now();
+        std::uint64_t swarm_executed = swarm.run(max_cycles);
+        double swarm_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::uint32_t mismatches = 0;
 
-            std::cout << "\tThe value on the \"" << Rhea::format_hex(word_1) << "\" address is now \"" << Rhea::format_hex(word_2, 2) << "\"." << std::endl;
-            continue;
+        for(std::uint32_t lane = 0; lane < lanes; lane++) {
+            if(!swarm.is_matching(lane, machines[lane])) {
+                if(mismatches++ == 0) {
+                    std::cerr << "\tThe lane #" << lane << " doesn't match its machine, IP is at \"" << format_hex(swarm.reference_i_pointer(lane)) << "\" instead of \"" << format_hex(machines[lane].reference_i_pointer()) << "\"." << std::endl;
+                }
+            }
         }
 
-        if(Rhea::is_prefixed(command, "-help")) {
-            command_varargs = Rhea::split(command, " ");
+        double separate_rate = separate_seconds > 0 ? separate_executed / separate_seconds : 0;
+        double swarm_rate = swarm_seconds > 0 ? swarm_executed / swarm_seconds : 0;
+        double converged = swarm_executed > 0 ? 100.0 * swarm.count_converged() / swarm_executed : 0;
 
-            if(command_varargs.size() < 2) {
-                std::cerr << "\tCommand name required as argument #1." << std::endl;
-                continue;
-            } else {
-                command_arg_1 = command_varargs.at(1);
-            }
-        
-            is_option_1 = command_arg_1 == "dump";
-            is_option_2 = command_arg_1 == "get";
-            is_option_3 = command_arg_1 == "jump";
-            is_option_4 = command_arg_1 == "load";
-            is_option_5 = command_arg_1 == "save";
-            is_option_6 = command_arg_1 == "set";
-            
-            if(is_option_1) {
-                std::cout << "\tdump <file : string>"<< std::endl;
-                std::cout << std::endl;
-                std::cout << "\tDumps the state of the machine into a text \"file\". This is just the" << std::endl;
-                std::cout << "\tcurrent values of the AR, XR, YR and SR; anlog with the values that IP" << std::endl;
-                std::cout << "\tand SP currently point to. Also a view to the next 255 bytes after the" << std::endl;
-                std::cout << "\tvalue IP is currently pointing to is provided (including IP)." << std::endl;
-                continue;
-            }
+        std::cout << std::fixed << std::setprecision(0);
+        std::cout << "\tMachines: " << separate_executed << " instruction(s), " << separate_rate << " per second." << std::endl;
+        std::cout << "\tSwarm:    " << swarm_executed << " instruction(s), " << swarm_rate << " per second, " << std::setprecision(2) << (separate_rate > 0 ? swarm_rate / separate_rate : 0) << "x." << std::endl;
+        std::cout << "\t" << std::setprecision(1) << converged << "% of the instructions ran in lockstep, the lanes copied " << swarm.count_private_pages() << " page(s)." << std::defaultfloat << std::endl;
 
-            if(is_option_2) {
-                std::cout << "\tget <address : number>"<< std::endl;
-                std::cout << "\tget <internal : string (ar | xr | yr | sr | ip | sp)>"<< std::endl;
-                std::cout << std::endl;
-                std::cout << "\tGets the value at the specified \"address\" on the memory or at the" << std::endl;
-                std::cout << "\tspecified \"internal\" register/pointer. The value can be a byte or a" << std::endl;
-                std::cout << "\tword depending of the register/pointer, but with the addresses it will" << std::endl;
-                std::cout << "\talways be a byte." << std::endl;
-                continue;
-            }
+        if(mismatches > 0) {
+            std::cerr << "\t" << mismatches << " of " << lanes << " lane(s) don't match their machine." << std::endl;
+            return false;
+        }
 
-            if(is_option_3) {
-                std::cout << "\tjump [sign: string (+ | -)]<address: number>"<< std::endl;
-                std::cout << std::endl;
-                std::cout << "\tJumps (sets IP) to an specific \"address\" in the memory. If the \"sign\"" << std::endl;
-                std::cout << "\tis + the machine jumps to [IP + \"address\"]; else, if it's - the machine" << std::endl;
-                std::cout << "\tjumps to [IP - \"address\"]. If there is no \"sign\" the machine just" << std::endl;
-                std::cout << "\tjumps to the \"address\"." << std::endl;
-                continue;
-            }
+        return true;
+    }
+}
 
-            if(is_option_4) {
-                std::cout << "\tload <file : string>"<< std::endl;
-                std::cout << std::endl;
-                std::cout << "\tLoads the ROM from a binary \"file\" of 32 KB." << std::endl;
-                continue;
-            }
 
-            if(is_option_4) {
-                std::cout << "\tload <file : string>"<< std::endl;
-                std::cout << std::endl;
-                std::cout << "\tSaves the ROM into a binary \"file\" of 32 KB." << std::endl;
-                continue;
-            }
+//--------------------------------------------------//
+// Main Code
+//--------------------------------------------------//
+int main(int argc, const char * argv[]) {
+    if(argc > 2 && std::string(argv[1]) == "--batch") { // Headless: Rhea --batch <manifest> [results]
+        return Rhea::run_batch(argv[2], argc > 3 ? argv[3] : "results.txt") ? 0 : 1;
+    }
 
-            if(is_option_6) {
-                std::cout << "\tset <address : number> <value: number>"<< std::endl;
-                std::cout << "\tset <internal : string (ar | xr | yr | sr | ip | sp)> <value: number>"<< std::endl;
-                std::cout << std::endl;
-                std::cout << "\tSets the \"value\" at the specified \"address\" on the memory or at the" << std::endl;
-                std::cout << "\tspecified \"internal\" register/pointer. The \"value\" can be a byte or a" << std::endl;
-                std::cout << "\tword depending of the register/pointer, but with the addresses it will" << std::endl;
-                std::cout << "\talways be a byte." << std::endl;
-                continue;
-            }
+    if(__RHEA_BENCH__ || (argc > 1 && std::string(argv[1]) == "--bench")) { // Headless: Rhea --bench [results] [cycles], or rhea_bench [results] [cycles]
+        int first = __RHEA_BENCH__ ? 1 : 2;
+        std::uint64_t max_cycles = 0x400000;
 
-            std::cerr << "\tUnrecognized help topic \"" << command_arg_1 << "\"." << std::endl;
-            continue;
+        if(argc > first + 1 && !Rhea::parse_number(argv[first + 1], max_cycles)) {
+            std::cerr << "\tCan't parse the cycles \"" << argv[first + 1] << "\"." << std::endl;
+            return 1;
         }
 
-        if(Rhea::is_prefixed(command, "-exit") || Rhea::is_prefixed(command, "-quit")) {
-            break;
-        }
+        return Rhea::run_benchmarks(nullptr, max_cycles, argc > first ? argv[first] : "bench.json") ? 0 : 1;
+    }
 
-        std::cerr << "\tUnrecognized command \"" << command << "\"." << std::endl;
+    if(argc > 2 && std::string(argv[1]) == "--analyze") { // Headless: Rhea --analyze <rom> [rom ...]
+        return Rhea::analyze_roms(std::vector<std::string>(argv + 2, argv + argc)) ? 0 : 1;
+    }
+
+    bool is_script = argc > 2 && std::string(argv[1]) == "--script"; // Rhea --script <file>
+
+    #if __RHEA_MAPPED__
+        bool is_interactive = !is_script && isatty(STDIN_FILENO);
+    #else
+        bool is_interactive = !is_script;
+    #endif
+
+    std::string script;
+    std::size_t script_offset = 0;
+    std::uint64_t line = 0, errors = 0;
+    std::ostringstream command_errors;
+    std::streambuf * output_buffer = std::cout.rdbuf(), * error_buffer = std::cerr.rdbuf();
+    Rhea::Batched batched_output = Rhea::Batched(output_buffer);
+    auto report_errors = [&]() { // Writes the errors of the last command, prefixed with its line.
+        std::string errors_text = "Line " + std::to_string(line) + ":" + command_errors.str();
+
+        batched_output.drain();
+        error_buffer->sputn(errors_text.data(), errors_text.size());
+        command_errors.str("");
+        errors++;
+    };
+
+    if(is_script) {
+        std::ifstream file = std::ifstream(argv[2], std::ios::binary | std::ios::ate);
+
+        if(!file.is_open()) {
+            std::cerr << "\tFile at \"" << argv[2] << "\" not found." << std::endl;
+            return 1;
+        }
+
+        script.resize(file.tellg());
+        file.seekg(0);
+        file.read(&script[0], script.size());
+    }
+
+    if(!is_interactive) { // No prompts nor flushes, and the errors of each command are held to prefix them with its line.
+        std::cout.rdbuf(&batched_output);
+        std::cerr.rdbuf(command_errors.rdbuf());
+    }
+
+    Rhea::Machine machine = Rhea::Machine();
+
+    if(is_interactive) {
+        std::cout << "Rhea [Version: " << __RHEA_VERSION__ << "]" << std::endl;
+        std::cout << "----------------------------------------------------------------------" << std::endl;
+    }
+
+    bool is_option_none, is_option_1, is_option_2, is_option_3, is_option_4, is_option_5, is_option_6;
+    std::uint8_t byte_1;
+    std::uint16_t word_1, word_2;
+    std::string command, command_arg_1, command_arg_2, command_arg_3, command_arg_4;
+    std::vector<std::string_view> command_varargs;
+    std::vector<std::shared_ptr<const Rhea::Machine::Snapshot>> snapshots;
+    Rhea::Tracer tracer = Rhea::Tracer();
+    Rhea::Profiler profiler = Rhea::Profiler();
+    Rhea::Scheduler scheduler = Rhea::Scheduler();
+    Rhea::Disassembler disassembler = Rhea::Disassembler();
+    Rhea::Assembler assembler = Rhea::Assembler();
+    bool is_assembling = false;
+    std::uint16_t assembly_address = 0x0000;
+    Rhea::Journal journal = Rhea::Journal();
+    Rhea::Metrics metrics = Rhea::Metrics();
+    std::uint64_t stats_instructions = 0, stats_nanoseconds = 0;
+
+    machine.set_metrics(&metrics); // Counted in slices, so it's always on.
+
+    auto analyze = [&machine]() { // Takes milliseconds, so every load is analyzed for the dumps and the debugger.
+        machine.set_analysis(std::make_shared<const Rhea::Analysis>(machine.reference_memory()));
+    };
+    std::string journaled_command;
+    bool is_journal_paused = false;
+
+    while(true) {
+        if(!is_interactive && command_errors.tellp() > 0) { // The previous command failed.
+            report_errors();
+        }
+
+        line++;
+
+        if(is_script) {
+            std::size_t end = script.find('\n', script_offset);
+
+            if(script_offset >= script.size()) {
+                break;
+            }
+
+            if(end == std::string::npos) {
+                end = script.size();
+            }
+
+            command.assign(script, script_offset, end - script_offset);
+            script_offset = end + 1;
+        } else {
+            if(is_interactive) {
+                std::cout << (is_assembling ? Rhea::format_hex(assembly_address) + ": " : "> ");
+            }
+
+            if(!std::getline(std::cin, command)) {
+                break;
+            }
+        }
+
+        if(!command.empty() && command.back() == '\r') {
+            command.pop_back();
+        }
+
+        if(is_assembling) { // The lines after -asm are assembled, up to a blank one or ".".
+            if(command.find_first_not_of(" \t") == std::string::npos || command == ".") {
+                is_assembling = false;
+
+                std::cout << "\tAssembled up to the \"" << Rhea::format_hex(assembly_address) << "\" address." << std::endl;
+                continue;
+            }
+
+            assembler.assemble_line(command, machine.reference_memory(), assembly_address);
+            continue;
+        }
+
+        if(is_journal_paused) { // The previous command is done, what it changed goes into the journal as a checkpoint.
+            journal.resume(journaled_command);
+            is_journal_paused = false;
+        }
+
+        Rhea::split(command, ' ', command_varargs);
+
+        Rhea::Command command_name = Rhea::parse_command(command_varargs.empty() ? std::string_view() : command_varargs.front());
+
+        if(command_name == Rhea::Command::Exit) {
+            break;
+        }
+
+        if(journal.is_active() && command_name != Rhea::Command::None && command_name != Rhea::Command::Run && command_name != Rhea::Command::Step && command_name != Rhea::Command::Trace &&
+           command_name != Rhea::Command::Journal && command_name != Rhea::Command::Replay && command_name != Rhea::Command::Help) { // Only runs are recorded as inputs, the other commands change the machine from outside.
+            journal.pause();
+            journaled_command = command;
+            is_journal_paused = true;
+        }
+
+        switch(command_name) {
+            case Rhea::Command::LoadAt: {
+                if(command_varargs.size() < 3) {
+                    std::cerr << "\tAddress and file required as arguments #1 and #2." << std::endl;
+                    continue;
+                }
+
+                command_arg_1 = command_varargs.at(1);
+                command_arg_2 = command_varargs.at(2);
+
+                if(!Rhea::parse_number(command_arg_1, word_1)) {
+                    std::cerr << "\tCan't parse argument #1 value \"" << command_arg_1 << "\"." << std::endl;
+                    continue;
+                }
+
+                std::uint32_t loaded = machine.reference_memory().load_at(command_arg_2, word_1);
+
+                if(loaded > 0) {
+                    analyze();
+
+                    std::cout << "\tLoaded " << loaded << " byte(s) of the \"" << command_arg_2 << "\" file at the \"" << Rhea::format_hex(word_1) << "\" address." << std::endl;
+                }
+
+                continue;
+            }
+
+            case Rhea::Command::Load: {
+                if(command_varargs.size() < 2) {
+                    command_arg_1 = "rom.bin";
+
+                    std::cout << "\tUsing default value \"" << command_arg_1 << "\" of argument #1 of this command." << std::endl;
+                } else {
+                    command_arg_1 = command_varargs.at(1);
+                }
+
+                if(command_varargs.size() < 3) {
+                    command_arg_2 = "copy";
+                } else {
+                    command_arg_2 = command_varargs.at(2);
+                }
+
+                is_option_1 = command_arg_2 == "copy";
+                is_option_2 = command_arg_2 == "map";
+
+                if(!(is_option_1 || is_option_2)) {
+                    std::cerr << "\tCan't parse argument #2 value \"" << command_arg_2 << "\"." << std::endl;
+                    continue;
+                }
+
+                if(machine.load(command_arg_1, is_option_2)) {
+                    analyze();
+
+                    std::cout << "\tLoaded the \"" << command_arg_1 << "\" file correctly." << std::endl;
+                }
+
+                continue;
+            }
+
+            case Rhea::Command::Save: {
+                if(command_varargs.size() < 2) {
+                    command_arg_1 = "rom.bin";
+
+                    std::cout << "\tUsing default value \"" << command_arg_1 << "\" of argument #1 of this command." << std::endl;
+                } else {
+                    command_arg_1 = command_varargs.at(1);
+                }
+
+                if(machine.save(command_arg_1)) {
+                    std::cout << "\tSaved the \"" << command_arg_1 << "\" file correctly." << std::endl;
+                }
+
+                continue;
+            }
+
+            case Rhea::Command::Dump: {
+                if(command_varargs.size() < 2) {
+                    command_arg_1 = "machine.dmp";
+
+                    std::cout << "\tUsing default value \"" << command_arg_1 << "\" of argument #1 of this command." << std::endl;
+                } else {
+                    command_arg_1 = command_varargs.at(1);
+                }
+
+                is_option_1 = command_varargs.size() > 2 && command_varargs.at(2) == "full";
+
+                if(command_varargs.size() > 2 && !is_option_1) {
+                    std::cerr << "\tCan't parse argument #2 value \"" << command_varargs.at(2) << "\"." << std::endl;
+                    continue;
+                }
+
+                if(machine.dump(command_arg_1, is_option_1)) {
+                    std::cout << "\tDumped the machine into the \"" << command_arg_1 << "\" file correctly." << std::endl;
+                }
+
+                continue;
+            }
+
+            case Rhea::Command::Jump: {
+                if(command_varargs.size() < 2) {
+                    command_arg_1 = "0000";
+
+                    std::cout << "\tUsing default value \"" << command_arg_1 << "\" of argument #1 of this command." << std::endl;
+                } else {
+                    command_arg_1 = command_varargs.at(1);
+                }
+
+                is_option_1 = Rhea::is_prefixed(command_arg_1, "+");
+                is_option_2 = Rhea::is_prefixed(command_arg_1, "-");
+
+                if(!Rhea::parse_number(std::string_view(command_arg_1).substr(is_option_1 || is_option_2 ? 1 : 0), word_1)) { // The sign picks the direction.
+                    std::cerr << "\tCan't parse argument #1 value \"" << command_arg_1 << "\"." << std::endl;
+                    continue;
+                }
+
+                if(is_option_1 || is_option_2) {
+                    std::cout << "\tJumped to the \"" << Rhea::format_hex(machine.reference_i_pointer()) << "\"" << (is_option_2 ? " - " : " + ") << "\"" << Rhea::format_hex(word_1) << "\" address successfully." << std::endl;
+
+                    if(is_option_1) {
+                        machine.reference_i_pointer() += word_1;
+                    }
+
+                    if(is_option_2) {
+                        machine.reference_i_pointer() -= word_1;
+                    }
+
+                    continue;
+                }
+
+                machine.reference_i_pointer() = word_1;
+
+                std::cout << "\tJumped to the \"" << Rhea::format_hex(word_1) << "\" address successfully." << std::endl;
+                continue;
+            }
+
+            case Rhea::Command::Get: {
+                if(command_varargs.size() < 2) {
+                    command_arg_1 = "0000";
+
+                    std::cout << "\tUsing default value \"" << command_arg_1 << "\" of argument #1 of this command." << std::endl;
+                } else {
+                    command_arg_1 = command_varargs.at(1);
+                }
+
+                is_option_1 = command_arg_1 == "ar";
+                is_option_2 = command_arg_1 == "xr";
+                is_option_3 = command_arg_1 == "yr";
+                is_option_4 = command_arg_1 == "sr";
+                is_option_5 = command_arg_1 == "ip";
+                is_option_6 = command_arg_1 == "sp";
+                is_option_none = !(is_option_1 || is_option_2 || is_option_3 || is_option_4 || is_option_5 || is_option_6);
+
+                word_1 = 0x0000;
+
+                if(is_option_none && !Rhea::parse_number(command_arg_1, word_1)) {
+                    std::cerr << "\tCan't parse argument #1 value \"" << command_arg_1 << "\"." << std::endl;
+                    continue;
+                }
+
+                word_2 = is_option_none ? machine.reference_memory().get(word_1) : 0x0000;
+
+                if(!is_option_none) {
+                    if(is_option_1) {
+                        word_2 = machine.reference_a_register();
+                    }
+
+                    if(is_option_2) {
+                        word_2 = machine.reference_x_register();
+                    }
+
+                    if(is_option_3) {
+                        word_2 = machine.reference_y_register();
+                    }
+
+                    if(is_option_4) {
+                        word_2 = machine.reference_s_register();
+                    }
+
+                    if(is_option_5) {
+                        word_2 = machine.reference_i_pointer();
+                    }
+
+                    if(is_option_6) {
+                        word_2 = machine.reference_s_pointer();
+                    }
+
+                    std::cout << "\tThe value of \"" << command_arg_1 << "\" is \"" << Rhea::format_hex(word_2, (is_option_5 ? 4 : 2)) << "\"." << std::endl;
+                    continue;
+                }
+
+                std::cout << "\tThe value on the \"" << Rhea::format_hex(word_1) << "\" address is \"" << Rhea::format_hex(word_2, 2) << "\"." << std::endl;
+                continue;
+            }
+
+            case Rhea::Command::Set: {
+                if(command_varargs.size() < 2) {
+                    command_arg_1 = "0000";
+
+                    std::cout << "\tUsing default value \"" << command_arg_1 << "\" of argument #1 of this command." << std::endl;
+                } else {
+                    command_arg_1 = command_varargs.at(1);
+                }
+
+                if(command_varargs.size() < 3) {
+                    command_arg_2 = "00";
+
+                    std::cout << "\tUsing default value \"" << command_arg_2 << "\" of argument #2 of this command." << std::endl;
+                } else {
+                    command_arg_2 = command_varargs.at(2);
+                }
+
+                is_option_1 = command_arg_1 == "ar";
+                is_option_2 = command_arg_1 == "xr";
+                is_option_3 = command_arg_1 == "yr";
+                is_option_4 = command_arg_1 == "sr";
+                is_option_5 = command_arg_1 == "ip";
+                is_option_6 = command_arg_1 == "sp";
+                is_option_none = !(is_option_1 || is_option_2 || is_option_3 || is_option_4 || is_option_5 || is_option_6);
+
+                word_1 = 0x0000;
+
+                if(is_option_none && !Rhea::parse_number(command_arg_1, word_1)) {
+                    std::cerr << "\tCan't parse argument #1 value \"" << command_arg_1 << "\"." << std::endl;
+                    continue;
+                }
+            
+                if(!Rhea::parse_number(command_arg_2, word_2)) {
+                    std::cerr << "\tCan't parse argument #2 value \"" << command_arg_2 << "\"." << std::endl;
+                    continue;
+                }
+
+                if(!is_option_none) {
+                    if(!is_option_5) {
+                        if(word_2 > 0xFF) {
+                            std::cerr << "\tArgument #2 is out of range." << std::endl;
+                            continue;
+                        }
+
+                        if(is_option_1) {
+                            machine.reference_a_register() = word_2;
+                        }
+
+                        if(is_option_2) {
+                            machine.reference_x_register() = word_2;
+                        }
+
+                        if(is_option_3) {
+                            machine.reference_y_register() = word_2;
+                        }
+
+                        if(is_option_4) {
+                            machine.reference_s_register() = word_2;
+                        }
+
+                        if(is_option_6) {
+                            machine.reference_s_pointer() = word_2;
+                        }
+                    }
+
+                    if(is_option_5) {
+                        machine.reference_i_pointer() = word_2;
+                    }
+
+                    std::cout << "\tThe value of \"" << command_arg_1 << "\" is now \"" << Rhea::format_hex(word_2, (is_option_5 ? 4 : 2)) << "\"." << std::endl;
+                    continue;
+                }
+
+                machine.reference_memory().patch(word_1, word_2);
+
+                std::cout << "\tThe value on the \"" << Rhea::format_hex(word_1) << "\" address is now \"" << Rhea::format_hex(word_2, 2) << "\"." << std::endl;
+                continue;
+            }
+
+            case Rhea::Command::Step: {
+                if(command_varargs.size() < 2) {
+                    command_arg_1 = "1";
+                } else {
+                    command_arg_1 = command_varargs.at(1);
+                }
+
+                std::uint64_t count, executed = 0;
+
+                if(!Rhea::parse_number(command_arg_1, count)) {
+                    std::cerr << "\tCan't parse argument #1 value \"" << command_arg_1 << "\"." << std::endl;
+                    continue;
+                }
+
+                while(executed < count && (tracer.is_active() ? machine.run(1, tracer) : profiler.is_active() ? machine.run(1, profiler) : machine.step()) != 0) {
+                    executed++;
+                }
+
+                std::cout << "\tStepped " << executed << " instruction(s), IP is now at the \"" << Rhea::format_hex(machine.reference_i_pointer()) << "\" address." << std::endl;
+
+                if(executed < count) {
+                    std::cerr << "\tHalted on the illegal opcode \"" << Rhea::format_hex(machine.reference_memory().get(machine.reference_i_pointer()), 2) << "\"." << std::endl;
+                }
+
+                continue;
+            }
+
+            case Rhea::Command::Run: {
+                if(command_varargs.size() < 2) {
+                    command_arg_1 = "100000";
+
+                    std::cout << "\tUsing default value \"" << command_arg_1 << "\" of argument #1 of this command." << std::endl;
+                } else {
+                    command_arg_1 = command_varargs.at(1);
+                }
+
+                std::uint64_t max_cycles, start_cycles = machine.reference_cycles();
+
+                if(!Rhea::parse_number(command_arg_1, max_cycles)) {
+                    std::cerr << "\tCan't parse argument #1 value \"" << command_arg_1 << "\"." << std::endl;
+                    continue;
+                }
+
+                auto runner = [&](const std::uint64_t cycles) {
+                    return tracer.is_active() ? machine.run(cycles, tracer) : profiler.is_active() ? machine.run(cycles, profiler) : machine.run(cycles);
+                };
+
+                auto start = std::chrono::steady_clock::now();
+                std::uint64_t executed = scheduler.is_throttled() ? scheduler.run(machine, max_cycles, runner) : runner(max_cycles);
+                double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+                std::cout << "\tRan " << executed << " instruction(s) in " << (machine.reference_cycles() - start_cycles) << " cycle(s), IP is now at the \"" << Rhea::format_hex(machine.reference_i_pointer()) << "\" address." << std::endl;
+                std::cout << "\tHost speed: " << static_cast<std::uint64_t>(seconds > 0 ? executed / seconds : 0) << " instruction(s) per second." << std::endl;
+
+                if(scheduler.is_throttled()) {
+                    std::cout << "\tClock: " << scheduler.get_rate() << " Hz, drift " << std::showpos << std::fixed << std::setprecision(3) << (scheduler.get_drift() * 1e3) << std::noshowpos << " ms over " << seconds << " s." << std::defaultfloat << std::endl;
+                }
+
+                if(machine.is_halted()) {
+                    std::cerr << "\tHalted on the illegal opcode \"" << Rhea::format_hex(machine.reference_memory().get(machine.reference_i_pointer()), 2) << "\"." << std::endl;
+                }
+
+                if(!tracer.is_active() && !profiler.is_active() && machine.get_event() == Rhea::Machine::Event::Breakpoint) {
+                    std::cout << "\tStopped on the breakpoint at the \"" << Rhea::format_hex(machine.reference_i_pointer()) << "\" address." << std::endl;
+                }
+
+                if(!tracer.is_active() && !profiler.is_active() && machine.get_event() == Rhea::Machine::Event::Watchpoint) {
+                    const Rhea::Memory::Access & access = machine.get_watch_hit();
+
+                    std::cout << "\tStopped on the " << (access.is_write ? "write" : "read") << " of \"" << Rhea::format_hex(access.value, 2) << "\" at the \"" << Rhea::format_hex(access.address) << "\" address." << std::endl;
+                }
+
+                continue;
+            }
+
+            case Rhea::Command::Reset: {
+                machine.reset();
+
+                std::cout << "\tReset the machine, IP is now at the \"" << Rhea::format_hex(machine.reference_i_pointer()) << "\" address." << std::endl;
+                continue;
+            }
+
+            case Rhea::Command::Irq: {
+                machine.request_irq();
+
+                std::cout << "\tRequested an IRQ, it's taken before the next instruction run with interrupts enabled." << std::endl;
+                continue;
+            }
+
+            case Rhea::Command::Nmi: {
+                machine.trigger_nmi();
+
+                std::cout << "\tTriggered an NMI, it's taken before the next instruction run." << std::endl;
+                continue;
+            }
+
+            case Rhea::Command::Timer: {
+                if(command_varargs.size() < 2) {
+                    std::cerr << "\tPeriod required as argument #1." << std::endl;
+                    continue;
+                }
+
+                command_arg_1 = command_varargs.at(1);
+
+                if(command_arg_1 == "off") {
+                    machine.clear_schedule();
+
+                    std::cout << "\tStopped every timer." << std::endl;
+                    continue;
+                }
+
+                if(command_varargs.size() < 3) {
+                    command_arg_2 = "irq";
+
+                    std::cout << "\tUsing default value \"" << command_arg_2 << "\" of argument #2 of this command." << std::endl;
+                } else {
+                    command_arg_2 = command_varargs.at(2);
+                }
+
+                std::uint64_t period;
+
+                if(!Rhea::parse_number(command_arg_1, period) || period == 0) {
+                    std::cerr << "\tCan't parse argument #1 value \"" << command_arg_1 << "\"." << std::endl;
+                    continue;
+                }
+
+                is_option_1 = command_arg_2 == "irq";
+                is_option_2 = command_arg_2 == "nmi";
+
+                if(!is_option_1 && !is_option_2) {
+                    std::cerr << "\tCan't parse argument #2 value \"" << command_arg_2 << "\"." << std::endl;
+                    continue;
+                }
+
+                if(is_option_1) {
+                    machine.schedule(machine.reference_cycles() + period, [](Rhea::Machine & timed) { timed.request_irq(); }, period);
+                } else {
+                    machine.schedule(machine.reference_cycles() + period, [](Rhea::Machine & timed) { timed.trigger_nmi(); }, period);
+                }
+
+                std::cout << "\tAn " << (is_option_1 ? "IRQ" : "NMI") << " is now requested every " << period << " cycle(s)." << std::endl;
+                continue;
+            }
+
+            case Rhea::Command::Clock: {
+                if(command_varargs.size() < 2) { // Without a rate, reports the timings since it was set.
+                    if(!scheduler.is_throttled()) {
+                        std::cout << "\tRunning as fast as possible." << std::endl;
+                        continue;
+                    }
+
+                    double host_seconds = scheduler.get_host_seconds();
+
+                    std::cout << "\tClock: " << scheduler.get_rate() << " Hz." << std::endl;
+                    std::cout << std::fixed << std::setprecision(3);
+                    std::cout << "\tEmulated " << scheduler.get_emulated_seconds() << " s in " << host_seconds << " s, drift " << std::showpos << (scheduler.get_drift(true) * 1e3) << std::noshowpos << " ms." << std::endl;
+                    std::cout << "\tWorst lag " << (scheduler.get_worst_lag() * 1e3) << " ms, host busy " << std::setprecision(1) << (host_seconds > 0 ? scheduler.get_busy_seconds() * 100 / host_seconds : 0) << "% of the time." << std::defaultfloat << std::endl;
+                    continue;
+                }
+
+                command_arg_1 = command_varargs.at(1);
+
+                std::uint64_t hz = 0;
+
+                if(command_arg_1 != "max" && (!Rhea::parse_number(command_arg_1, hz, 10) || hz == 0)) {
+                    std::cerr << "\tCan't parse argument #1 value \"" << command_arg_1 << "\"." << std::endl;
+                    continue;
+                }
+
+                scheduler.set_rate(hz);
+
+                if(hz == 0) {
+                    std::cout << "\t\"-run\" now runs as fast as possible." << std::endl;
+                } else {
+                    std::cout << "\t\"-run\" now runs at " << hz << " Hz." << std::endl;
+                }
+
+                continue;
+            }
+
+            case Rhea::Command::Dispatch: {
+                if(command_varargs.size() < 2) {
+                    command_arg_1 = "1000000";
+
+                    std::cout << "\tUsing default value \"" << command_arg_1 << "\" of argument #1 of this command." << std::endl;
+                } else {
+                    command_arg_1 = command_varargs.at(1);
+                }
+
+                std::uint64_t max_cycles;
+
+                if(!Rhea::parse_number(command_arg_1, max_cycles)) {
+                    std::cerr << "\tCan't parse argument #1 value \"" << command_arg_1 << "\"." << std::endl;
+                    continue;
+                }
+
+                Rhea::Machine switched = machine;
+
+                switched.detach(); // Each strategy reads the same, and the devices of the machine are left as they were.
+
+                auto start = std::chrono::steady_clock::now();
+                std::uint64_t executed = switched.run<Rhea::Machine::Dispatch::Switch>(max_cycles);
+                double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+                std::cout << "\tSwitch:   " << executed << " instruction(s), " << static_cast<std::uint64_t>(seconds > 0 ? executed / seconds : 0) << " instruction(s) per second." << std::endl;
+
+                #if __RHEA_THREADED__
+                    Rhea::Machine threaded = machine;
+
+                    threaded.detach();
+
+                    start = std::chrono::steady_clock::now();
+                    executed = threaded.run<Rhea::Machine::Dispatch::Threaded>(max_cycles);
+                    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+                    std::cout << "\tThreaded: " << executed << " instruction(s), " << static_cast<std::uint64_t>(seconds > 0 ? executed / seconds : 0) << " instruction(s) per second." << std::endl;
+
+                    if(!switched.is_identical(threaded)) {
+                        std::cerr << "\tThe strategies ended in different states." << std::endl;
+                        continue;
+                    }
+                #else
+                    std::cout << "\tThreaded dispatch is not available in this build." << std::endl;
+                #endif
+
+                Rhea::Machine cached = machine;
+
+                cached.detach();
+
+                start = std::chrono::steady_clock::now();
+                executed = cached.run<Rhea::Machine::Dispatch::Cached>(max_cycles);
+                seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+                std::cout << "\tCached:   " << executed << " instruction(s), " << static_cast<std::uint64_t>(seconds > 0 ? executed / seconds : 0) << " instruction(s) per second." << std::endl;
+
+                if(!switched.is_identical(cached)) {
+                    std::cerr << "\tThe strategies ended in different states." << std::endl;
+                    continue;
+                }
+
+                std::cout << "\tAll the strategies ended in the same state." << std::endl;
+                continue;
+            }
+
+            case Rhea::Command::Cache: {
+                if(command_varargs.size() >= 2) {
+                    command_arg_1 = command_varargs.at(1);
+
+                    is_option_1 = command_arg_1 == "on";
+                    is_option_2 = command_arg_1 == "off";
+                    is_option_3 = command_arg_1 == "flush";
+
+                    if(!(is_option_1 || is_option_2 || is_option_3)) {
+                        std::cerr << "\tCan't parse argument #1 value \"" << command_arg_1 << "\"." << std::endl;
+                        continue;
+                    }
+
+                    machine.set_caching(is_option_3 ? machine.is_caching_enabled() : is_option_1);
+                }
+
+                std::cout << "\tThe translation cache is " << (machine.is_caching_enabled() ? "on" : "off") << " with " << machine.count_blocks() << " block(s)." << std::endl;
+                std::cout << "\tHits: " << machine.count_cache_hits() << "  Misses: " << machine.count_cache_misses() << "  Invalidations: " << machine.count_cache_invalidations() << std::endl;
+                continue;
+            }
+
+            case Rhea::Command::Attach: {
+                if(command_varargs.size() < 3) {
+                    std::cerr << "\tDevice name and page required as arguments #1 and #2." << std::endl;
+                    continue;
+                }
+
+                command_arg_1 = command_varargs.at(1);
+                command_arg_2 = command_varargs.at(2);
+
+                is_option_1 = command_arg_1 == "ram";
+                is_option_2 = command_arg_1 == "console";
+                is_option_3 = command_arg_1 == "random";
+
+                if(!(is_option_1 || is_option_2 || is_option_3)) {
+                    std::cerr << "\tCan't parse argument #1 value \"" << command_arg_1 << "\"." << std::endl;
+                    continue;
+                }
+
+                if(!Rhea::parse_number(command_arg_2, word_1)) {
+                    std::cerr << "\tCan't parse argument #2 value \"" << command_arg_2 << "\"." << std::endl;
+                    continue;
+                }
+
+                if(word_1 > 0xFF) {
+                    std::cerr << "\tArgument #2 is out of range." << std::endl;
+                    continue;
+                }
+
+                std::shared_ptr<Rhea::Device> device = nullptr;
+
+                if(is_option_2) {
+                    device = std::make_shared<Rhea::Console>(std::cout);
+                }
+
+                if(is_option_3) {
+                    device = std::make_shared<Rhea::Random>();
+                }
+
+                machine.reference_memory().attach(word_1, word_1, device);
+
+                std::cout << "\tAttached \"" << command_arg_1 << "\" to the \"" << Rhea::format_hex(word_1 << 8) << "\" page successfully." << std::endl;
+                continue;
+            }
+
+            case Rhea::Command::Protect: {
+                if(command_varargs.size() < 2) {
+                    command_arg_1 = "80";
+
+                    std::cout << "\tUsing default value \"" << command_arg_1 << "\" of argument #1 of this command." << std::endl;
+                } else {
+                    command_arg_1 = command_varargs.at(1);
+                }
+
+                if(command_varargs.size() < 3) {
+                    command_arg_2 = "FF";
+
+                    std::cout << "\tUsing default value \"" << command_arg_2 << "\" of argument #2 of this command." << std::endl;
+                } else {
+                    command_arg_2 = command_varargs.at(2);
+                }
+
+                if(command_varargs.size() < 4) {
+                    command_arg_3 = "on";
+                } else {
+                    command_arg_3 = command_varargs.at(3);
+                }
+
+                if(!Rhea::parse_number(command_arg_1, word_1)) {
+                    std::cerr << "\tCan't parse argument #1 value \"" << command_arg_1 << "\"." << std::endl;
+                    continue;
+                }
+
+                if(!Rhea::parse_number(command_arg_2, word_2)) {
+                    std::cerr << "\tCan't parse argument #2 value \"" << command_arg_2 << "\"." << std::endl;
+                    continue;
+                }
+
+                is_option_1 = command_arg_3 == "on";
+                is_option_2 = command_arg_3 == "off";
+
+                if(!(is_option_1 || is_option_2)) {
+                    std::cerr << "\tCan't parse argument #3 value \"" << command_arg_3 << "\"." << std::endl;
+                    continue;
+                }
+
+                if(word_1 > 0xFF || word_2 > 0xFF || word_1 > word_2) {
+                    std::cerr << "\tArguments #1 and #2 are out of range." << std::endl;
+                    continue;
+                }
+
+                machine.reference_memory().protect(word_1, word_2, is_option_1);
+
+                std::cout << "\tThe \"" << Rhea::format_hex(word_1 << 8) << "\" to \"" << Rhea::format_hex((word_2 << 8) | 0xFF) << "\" range is now " << (is_option_1 ? "read-only" : "writable") << "." << std::endl;
+                continue;
+            }
+
+            case Rhea::Command::MemBench: {
+                if(command_varargs.size() < 2) {
+                    command_arg_1 = "10000000";
+
+                    std::cout << "\tUsing default value \"" << command_arg_1 << "\" of argument #1 of this command." << std::endl;
+                } else {
+                    command_arg_1 = command_varargs.at(1);
+                }
+
+                std::uint64_t count;
+
+                if(!Rhea::parse_number(command_arg_1, count)) {
+                    std::cerr << "\tCan't parse argument #1 value \"" << command_arg_1 << "\"." << std::endl;
+                    continue;
+                }
+
+                std::pair<double, double> timings = Rhea::benchmark_memory(count);
+
+                if(timings.first < 0) {
+                    std::cerr << "\tThe bus and the array ended with different contents." << std::endl;
+                    continue;
+                }
+
+                std::cout << "\tBus:   " << std::fixed << std::setprecision(3) << timings.first << " ns per read and write." << std::endl;
+                std::cout << "\tArray: " << timings.second << " ns per read and write." << std::defaultfloat << std::endl;
+                continue;
+            }
+
+            case Rhea::Command::HexBench: {
+                if(command_varargs.size() < 2) {
+                    command_arg_1 = "100";
+
+                    std::cout << "\tUsing default value \"" << command_arg_1 << "\" of argument #1 of this command." << std::endl;
+                } else {
+                    command_arg_1 = command_varargs.at(1);
+                }
+
+                std::uint64_t count;
+
+                if(!Rhea::parse_number(command_arg_1, count)) {
+                    std::cerr << "\tCan't parse argument #1 value \"" << command_arg_1 << "\"." << std::endl;
+                    continue;
+                }
+
+                if(count == 0) {
+                    std::cerr << "\tArgument #1 must be greater than 0." << std::endl;
+                    continue;
+                }
+
+                std::pair<double, double> timings = Rhea::benchmark_dump(count);
+
+                if(timings.first < 0) {
+                    std::cerr << "\tThe table encoder and the string streams produced different dumps." << std::endl;
+                    continue;
+                }
+
+                std::cout << "\tTable:   " << std::fixed << std::setprecision(1) << timings.first << " us per full dump." << std::endl;
+                std::cout << "\tStreams: " << timings.second << " us per full dump." << std::defaultfloat << std::endl;
+                continue;
+            }
+
+            case Rhea::Command::Bench: {
+                if(command_varargs.size() < 2) {
+                    command_arg_1 = "400000";
+
+                    std::cout << "\tUsing default value \"" << command_arg_1 << "\" of argument #1 of this command." << std::endl;
+                } else {
+                    command_arg_1 = command_varargs.at(1);
+                }
+
+                if(command_varargs.size() < 3) {
+                    command_arg_2 = "bench.json";
+
+                    std::cout << "\tUsing default value \"" << command_arg_2 << "\" of argument #2 of this command." << std::endl;
+                } else {
+                    command_arg_2 = command_varargs.at(2);
+                }
+
+                std::uint64_t max_cycles;
+
+                if(!Rhea::parse_number(command_arg_1, max_cycles) || max_cycles == 0) {
+                    std::cerr << "\tCan't parse argument #1 value \"" << command_arg_1 << "\"." << std::endl;
+                    continue;
+                }
+
+                if(Rhea::run_benchmarks(&machine, max_cycles, command_arg_2)) {
+                    std::cout << "\tWrote the results into the \"" << command_arg_2 << "\" file." << std::endl;
+                }
+
+                continue;
+            }
+
+            case Rhea::Command::Batch: {
+                if(command_varargs.size() < 2) {
+                    std::cerr << "\tManifest file required as argument #1." << std::endl;
+                    continue;
+                }
+
+                command_arg_1 = command_varargs.at(1);
+
+                if(command_varargs.size() < 3) {
+                    command_arg_2 = "results.txt";
+
+                    std::cout << "\tUsing default value \"" << command_arg_2 << "\" of argument #2 of this command." << std::endl;
+                } else {
+                    command_arg_2 = command_varargs.at(2);
+                }
+
+                if(Rhea::run_batch(command_arg_1, command_arg_2)) {
+                    std::cout << "\tWrote the results into the \"" << command_arg_2 << "\" file correctly." << std::endl;
+                }
+
+                continue;
+            }
+
+            case Rhea::Command::Snapshot: {
+                std::shared_ptr<const Rhea::Machine::Snapshot> snapshot = machine.snapshot();
+
+                snapshots.push_back(snapshot);
+
+                std::cout << "\tTook the snapshot #" << (snapshots.size() - 1) << ", copying " << snapshot->changed.size() << " page(s)." << std::endl;
+                continue;
+            }
+
+            case Rhea::Command::SaveState: {
+                if(command_varargs.size() < 2) {
+                    command_arg_1 = "machine.sav";
+
+                    std::cout << "\tUsing default value \"" << command_arg_1 << "\" of argument #1 of this command." << std::endl;
+                } else {
+                    command_arg_1 = command_varargs.at(1);
+                }
+
+                is_option_1 = command_varargs.size() > 2 && command_varargs.at(2) == "raw";
+
+                if(command_varargs.size() > 2 && !is_option_1) {
+                    std::cerr << "\tCan't parse argument #2 value \"" << command_varargs.at(2) << "\"." << std::endl;
+                    continue;
+                }
+
+                if(machine.save_state(command_arg_1, !is_option_1)) {
+                    std::cout << "\tSaved the state into the \"" << command_arg_1 << "\" file correctly." << std::endl;
+                }
+
+                continue;
+            }
+
+            case Rhea::Command::LoadState: {
+                if(command_varargs.size() < 2) {
+                    command_arg_1 = "machine.sav";
+
+                    std::cout << "\tUsing default value \"" << command_arg_1 << "\" of argument #1 of this command." << std::endl;
+                } else {
+                    command_arg_1 = command_varargs.at(1);
+                }
+
+                if(machine.load_state(command_arg_1)) {
+                    analyze();
+
+                    std::cout << "\tLoaded the state from the \"" << command_arg_1 << "\" file, IP is now at the \"" << Rhea::format_hex(machine.reference_i_pointer()) << "\" address." << std::endl;
+                }
+
+                continue;
+            }
+
+            case Rhea::Command::Swarm: {
+                if(command_varargs.size() < 2) {
+                    std::cerr << "\tNumber of lanes required as argument #1." << std::endl;
+                    continue;
+                }
+
+                command_arg_1 = command_varargs.at(1);
+
+                if(command_varargs.size() < 3) {
+                    command_arg_2 = "10000";
+
+                    std::cout << "\tUsing default value \"" << command_arg_2 << "\" of argument #2 of this command." << std::endl;
+                } else {
+                    command_arg_2 = command_varargs.at(2);
+                }
+
+                std::uint32_t lanes;
+                std::uint64_t max_cycles;
+
+                if(!Rhea::parse_number(command_arg_1, lanes, 10) || lanes == 0) {
+                    std::cerr << "\tCan't parse argument #1 value \"" << command_arg_1 << "\"." << std::endl;
+                    continue;
+                }
+
+                if(!Rhea::parse_number(command_arg_2, max_cycles)) {
+                    std::cerr << "\tCan't parse argument #2 value \"" << command_arg_2 << "\"." << std::endl;
+                    continue;
+                }
+
+                if(command_varargs.size() > 3 && !Rhea::parse_number(command_varargs.at(3), word_1)) {
+                    std::cerr << "\tCan't parse argument #3 value \"" << command_varargs.at(3) << "\"." << std::endl;
+                    continue;
+                }
+
+                if(Rhea::run_swarm(machine, lanes, max_cycles, command_varargs.size() > 3 ? word_1 : 0x0000)) {
+                    std::cout << "\tEvery one of the " << lanes << " lane(s) matched its machine." << std::endl;
+                }
+
+                continue;
+            }
+
+            case Rhea::Command::Disasm: {
+                if(command_varargs.size() < 2) {
+                    command_arg_1 = Rhea::format_hex(machine.reference_i_pointer());
+
+                    std::cout << "\tUsing default value \"" << command_arg_1 << "\" of argument #1 of this command." << std::endl;
+                } else {
+                    command_arg_1 = command_varargs.at(1);
+                }
+
+                if(command_varargs.size() < 3) {
+                    command_arg_2 = "16";
+
+                    std::cout << "\tUsing default value \"" << command_arg_2 << "\" of argument #2 of this command." << std::endl;
+                } else {
+                    command_arg_2 = command_varargs.at(2);
+                }
+
+                std::uint32_t count;
+
+                if(!Rhea::parse_number(command_arg_1, word_1)) {
+                    std::cerr << "\tCan't parse argument #1 value \"" << command_arg_1 << "\"." << std::endl;
+                    continue;
+                }
+
+                if(!Rhea::parse_number(command_arg_2, count, 10)) {
+                    std::cerr << "\tCan't parse argument #2 value \"" << command_arg_2 << "\"." << std::endl;
+                    continue;
+                }
+
+                std::string text;
+
+                disassembler.format_listing(text, machine.reference_memory(), word_1, count);
+
+                for(std::size_t offset = 0; offset < text.size();) { // Indented like the rest of the output.
+                    std::size_t end = text.find('\n', offset) + 1;
+
+                    std::cout << '\t';
+                    std::cout.write(&text[offset], end - offset);
+                    offset = end;
+                }
+
+                continue;
+            }
+
+            case Rhea::Command::Asm: {
+                if(command_varargs.size() < 2) {
+                    command_arg_1 = Rhea::format_hex(machine.reference_i_pointer());
+
+                    std::cout << "\tUsing default value \"" << command_arg_1 << "\" of argument #1 of this command." << std::endl;
+                } else {
+                    command_arg_1 = command_varargs.at(1);
+                }
+
+                if(!Rhea::parse_number(command_arg_1, assembly_address)) {
+                    std::cerr << "\tCan't parse argument #1 value \"" << command_arg_1 << "\"." << std::endl;
+                    continue;
+                }
+
+                is_assembling = true;
+
+                std::cout << "\tAssembling at the \"" << Rhea::format_hex(assembly_address) << "\" address, until a blank line or \".\"." << std::endl;
+                continue;
+            }
+
+            case Rhea::Command::Assemble: {
+                if(command_varargs.size() < 2) {
+                    std::cerr << "\tFile required as argument #1." << std::endl;
+                    continue;
+                }
+
+                command_arg_1 = command_varargs.at(1);
+
+                std::uint32_t size;
+
+                if(assembler.assemble_file(command_arg_1, machine.reference_memory(), size)) {
+                    analyze();
+
+                    std::cout << "\tAssembled " << size << " byte(s) of the \"" << command_arg_1 << "\" file correctly." << std::endl;
+                }
+
+                continue;
+            }
+
+            case Rhea::Command::Journal: {
+                if(command_varargs.size() < 2) {
+                    std::cerr << "\tFile required as argument #1." << std::endl;
+                    continue;
+                }
+
+                command_arg_1 = command_varargs.at(1);
+
+                if(command_arg_1 == "off") {
+                    if(!journal.is_active()) {
+                        std::cerr << "\tNot journaling." << std::endl;
+                        continue;
+                    }
+
+                    journal.stop();
+
+                    std::cout << "\tStopped the journal: " << journal.count_inputs() << " input(s) and " << journal.count_checkpoints() << " checkpoint(s) in " << journal.count_bytes() << " byte(s)." << std::endl;
+                    continue;
+                }
+
+                if(journal.is_active()) {
+                    std::cerr << "\tJournaling already, stop it first." << std::endl;
+                    continue;
+                }
+
+                if(command_varargs.size() < 3) {
+                    command_arg_2 = "100000";
+
+                    std::cout << "\tUsing default value \"" << command_arg_2 << "\" of argument #2 of this command." << std::endl;
+                } else {
+                    command_arg_2 = command_varargs.at(2);
+                }
+
+                std::uint64_t period;
+
+                if(!Rhea::parse_number(command_arg_2, period) || period == 0) {
+                    std::cerr << "\tCan't parse argument #2 value \"" << command_arg_2 << "\"." << std::endl;
+                    continue;
+                }
+
+                if(journal.start(command_arg_1, machine, period)) {
+                    std::cout << "\tJournaling the inputs into the \"" << command_arg_1 << "\" file, with a checkpoint every " << period << " cycle(s)." << std::endl;
+                }
+
+                continue;
+            }
+
+            case Rhea::Command::Replay: {
+                if(command_varargs.size() < 2) {
+                    std::cerr << "\tFile required as argument #1." << std::endl;
+                    continue;
+                }
+
+                command_arg_1 = command_varargs.at(1);
+
+                if(journal.is_active()) {
+                    std::cerr << "\tJournaling, stop it first." << std::endl;
+                    continue;
+                }
+
+                if(command_varargs.size() < 3) {
+                    command_arg_2 = "end";
+
+                    std::cout << "\tUsing default value \"" << command_arg_2 << "\" of argument #2 of this command." << std::endl;
+                } else {
+                    command_arg_2 = command_varargs.at(2);
+                }
+
+                std::uint64_t cycle = std::numeric_limits<std::uint64_t>::max(), start, inputs;
+
+                if(command_arg_2 != "end" && !Rhea::parse_number(command_arg_2, cycle)) {
+                    std::cerr << "\tCan't parse argument #2 value \"" << command_arg_2 << "\"." << std::endl;
+                    continue;
+                }
+
+                if(Rhea::Journal::replay(command_arg_1, machine, cycle, start, inputs)) {
+                    std::cout << "\tReplayed " << inputs << " input(s) from the checkpoint at cycle " << start << " up to cycle " << machine.reference_cycles() << ", IP is now at the \"" << Rhea::format_hex(machine.reference_i_pointer()) << "\" address." << std::endl;
+                }
+
+                continue;
+            }
+
+            case Rhea::Command::Analyze: {
+                if(command_varargs.size() > 1 && command_varargs.at(1) == "roms") {
+                    if(command_varargs.size() < 3) {
+                        std::cerr << "\tROM files required as arguments #2 onwards." << std::endl;
+                        continue;
+                    }
+
+                    Rhea::analyze_roms(std::vector<std::string>(command_varargs.begin() + 2, command_varargs.end()));
+                    continue;
+                }
+
+                if(command_varargs.size() > 1 && command_varargs.at(1) != "block") {
+                    std::cerr << "\tCan't parse argument #1 value \"" << command_varargs.at(1) << "\"." << std::endl;
+                    continue;
+                }
+
+                if(command_varargs.size() > 1) {
+                    if(command_varargs.size() < 3) {
+                        std::cerr << "\tAddress required as argument #2." << std::endl;
+                        continue;
+                    }
+
+                    command_arg_2 = command_varargs.at(2);
+
+                    if(!Rhea::parse_number(command_arg_2, word_1)) {
+                        std::cerr << "\tCan't parse argument #2 value \"" << command_arg_2 << "\"." << std::endl;
+                        continue;
+                    }
+
+                    if(machine.get_analysis() == nullptr) {
+                        analyze();
+                    }
+
+                    const Rhea::Analysis & analysis = *machine.get_analysis();
+                    const Rhea::Analysis::Block * block = analysis.find_block(word_1);
+                    const char * kinds[] = { "fallthrough", "branch", "jump", "call", "indirect" };
+
+                    if(block == nullptr) {
+                        std::cout << "\tThe \"" << Rhea::format_hex(word_1) << "\" address is data, no instruction reached from the vectors covers it." << std::endl;
+                        continue;
+                    }
+
+                    std::cout << "\tBlock " << Rhea::format_hex(block->first) << "-" << Rhea::format_hex(block->first + block->size - 1) << ": " << block->instructions << " instruction(s), " << analysis.count_incoming(*block) << " edge(s) in." << std::endl;
+
+                    for(std::uint32_t edge = block->edge; edge < block->edge + block->edges; edge++) {
+                        const Rhea::Analysis::Edge & out = analysis.get_edges()[edge];
+
+                        std::cout << "\t  -> " << Rhea::format_hex(out.target) << " " << kinds[static_cast<std::uint8_t> (out.kind)] << std::endl;
+                    }
+
+                    if(analysis.get_flags(word_1) & Rhea::Analysis::Flag::Written) {
+                        std::cout << "\tThe \"" << Rhea::format_hex(word_1) << "\" address is written by the code itself." << std::endl;
+                    }
+
+                    continue;
+                }
+
+                auto start = std::chrono::steady_clock::now();
+
+                analyze();
+
+                double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                const Rhea::Analysis & analysis = *machine.get_analysis();
+                std::vector<std::pair<std::uint16_t, std::uint16_t>> unreached = analysis.get_unreached(machine.reference_memory());
+                std::vector<std::string_view> summary;
+                std::string text;
+
+                analysis.format_summary(text, machine.reference_memory());
+                Rhea::split(text, '\n', summary);
+
+                for(const std::string_view item : summary) {
+                    std::cout << "\t" << item << std::endl;
+                }
+
+                for(std::size_t index = 0; index < unreached.size() && index < 8; index++) {
+                    std::cout << "\tUnreached: " << Rhea::format_hex(unreached[index].first) << "-" << Rhea::format_hex(unreached[index].second) << std::endl;
+                }
+
+                for(std::size_t index = 0; index < analysis.get_writes().size() && index < 8; index++) {
+                    std::cout << "\tSelf-modifying: " << Rhea::format_hex(analysis.get_writes()[index].first) << " writes to " << Rhea::format_hex(analysis.get_writes()[index].second) << std::endl;
+                }
+
+                std::cout << "\tAnalyzed the memory in " << std::fixed << std::setprecision(3) << seconds * 1e3 << std::defaultfloat << " ms." << std::endl;
+                continue;
+            }
+
+            case Rhea::Command::Stats: {
+                command_arg_1 = command_varargs.size() > 1 ? command_varargs.at(1) : "";
+
+                if(command_arg_1 == "clear") {
+                    metrics.clear();
+                    stats_instructions = 0;
+                    stats_nanoseconds = 0;
+
+                    std::cout << "\tCleared every counter." << std::endl;
+                    continue;
+                }
+
+                if(command_arg_1 == "pages") {
+                    is_option_1 = command_varargs.size() > 2 && command_varargs.at(2) == "on";
+                    is_option_2 = command_varargs.size() > 2 && command_varargs.at(2) == "off";
+
+                    if(!is_option_1 && !is_option_2) {
+                        std::cerr << "\tCan't parse argument #2 value \"" << (command_varargs.size() > 2 ? command_varargs.at(2) : "") << "\"." << std::endl;
+                        continue;
+                    }
+
+                    machine.reference_memory().set_metrics(is_option_1 ? &metrics : nullptr);
+
+                    std::cout << "\t" << (is_option_1 ? "Counting" : "Stopped counting") << " the reads and writes of each page." << std::endl;
+                    continue;
+                }
+
+                if(command_arg_1 == "publish") {
+                    if(command_varargs.size() < 3) {
+                        std::cerr << "\tFile or \"unix:<path>\" socket required as argument #2." << std::endl;
+                        continue;
+                    }
+
+                    command_arg_2 = command_varargs.at(2);
+
+                    if(command_arg_2 == "off") {
+                        metrics.stop();
+
+                        std::cout << "\tStopped publishing the counters." << std::endl;
+                        continue;
+                    }
+
+                    if(command_varargs.size() < 4) {
+                        command_arg_3 = "1000";
+
+                        std::cout << "\tUsing default value \"" << command_arg_3 << "\" of argument #3 of this command." << std::endl;
+                    } else {
+                        command_arg_3 = command_varargs.at(3);
+                    }
+
+                    std::uint32_t interval;
+
+                    if(!Rhea::parse_number(command_arg_3, interval, 10) || interval == 0) {
+                        std::cerr << "\tCan't parse argument #3 value \"" << command_arg_3 << "\"." << std::endl;
+                        continue;
+                    }
+
+                    if(metrics.publish(command_arg_2, interval)) {
+                        std::cout << "\tPublishing the counters to \"" << command_arg_2 << "\" every " << interval << " ms." << std::endl;
+                    }
+
+                    continue;
+                }
+
+                if(!command_arg_1.empty()) {
+                    std::cerr << "\tCan't parse argument #1 value \"" << command_arg_1 << "\"." << std::endl;
+                    continue;
+                }
+
+                std::uint64_t instructions = metrics.get_instructions() - stats_instructions, nanoseconds = metrics.get_nanoseconds() - stats_nanoseconds;
+
+                std::cout << "\tInstructions: " << metrics.get_instructions() << ", cycles: " << metrics.get_cycles() << "." << std::endl;
+                std::cout << "\tInterrupts: " << metrics.get_irqs() << " IRQ(s), " << metrics.get_nmis() << " NMI(s)." << std::endl;
+                std::cout << "\tHost speed: " << static_cast<std::uint64_t>(nanoseconds > 0 ? instructions * 1e9 / nanoseconds : 0) << " instruction(s) per second since the last \"-stats\"." << std::endl;
+
+                if(machine.reference_memory().is_counting()) {
+                    std::vector<std::pair<std::uint64_t, std::uint16_t>> pages;
+
+                    for(std::uint16_t page = 0x00; page < 0x100; page++) {
+                        if(metrics.get_reads(page) + metrics.get_writes(page) > 0) {
+                            pages.push_back({ metrics.get_reads(page) + metrics.get_writes(page), page });
+                        }
+                    }
+
+                    std::sort(pages.rbegin(), pages.rend());
+
+                    for(std::size_t index = 0; index < pages.size() && index < 8; index++) {
+                        std::uint16_t page = pages[index].second;
+
+                        std::cout << "\tPage " << Rhea::format_hex(page, 2) << ": " << metrics.get_reads(page) << " read(s), " << metrics.get_writes(page) << " write(s)." << std::endl;
+                    }
+                }
+
+                if(metrics.is_publishing()) {
+                    std::cout << "\tPublishing to \"" << metrics.get_published() << "\"." << std::endl;
+                }
+
+                stats_instructions = metrics.get_instructions();
+                stats_nanoseconds = metrics.get_nanoseconds();
+                continue;
+            }
+
+            case Rhea::Command::Restore: {
+                if(snapshots.empty()) {
+                    std::cerr << "\tNo snapshot was taken yet." << std::endl;
+                    continue;
+                }
+
+                if(command_varargs.size() < 2) {
+                    command_arg_1 = std::to_string(snapshots.size() - 1);
+
+                    std::cout << "\tUsing default value \"" << command_arg_1 << "\" of argument #1 of this command." << std::endl;
+                } else {
+                    command_arg_1 = command_varargs.at(1);
+                }
+
+                std::size_t index;
+
+                if(!Rhea::parse_number(command_arg_1, index, 10)) {
+                    std::cerr << "\tCan't parse argument #1 value \"" << command_arg_1 << "\"." << std::endl;
+                    continue;
+                }
+
+                if(index >= snapshots.size()) {
+                    std::cerr << "\tThere is no snapshot #" << index << "." << std::endl;
+                    continue;
+                }
+
+                if(machine.restore(snapshots[index])) {
+                    std::cout << "\tRestored the snapshot #" << index << ", IP is now at the \"" << Rhea::format_hex(machine.reference_i_pointer()) << "\" address." << std::endl;
+                }
+
+                continue;
+            }
+
+            case Rhea::Command::Trace: {
+                if(command_varargs.size() < 2) {
+                    std::cerr << "\tAction required as argument #1." << std::endl;
+                    continue;
+                }
+
+                command_arg_1 = command_varargs.at(1);
+
+                if(command_varargs.size() < 3) {
+                    command_arg_2 = "trace.bin";
+
+                    if(command_arg_1 != "stop") {
+                        std::cout << "\tUsing default value \"" << command_arg_2 << "\" of argument #2 of this command." << std::endl;
+                    }
+                } else {
+                    command_arg_2 = command_varargs.at(2);
+                }
+
+                if(command_arg_1 == "start") {
+                    if(tracer.is_active()) {
+                        std::cerr << "\tAlready tracing, stop it first." << std::endl;
+                        continue;
+                    }
+
+                    if(profiler.is_active()) {
+                        std::cerr << "\tProfiling, stop it first." << std::endl;
+                        continue;
+                    }
+
+                    if(tracer.start(command_arg_2, machine)) {
+                        std::cout << "\tTracing into the \"" << command_arg_2 << "\" file, \"-run\" and \"-step\" are now recorded." << std::endl;
+                    }
+                } else if(command_arg_1 == "stop") {
+                    if(!tracer.is_active()) {
+                        std::cerr << "\tNot tracing." << std::endl;
+                        continue;
+                    }
+
+                    tracer.stop();
+
+                    std::cout << "\tRecorded " << tracer.count_records() << " instruction(s) in " << tracer.count_bytes() << " byte(s)." << std::endl;
+                } else if(command_arg_1 == "decode") {
+                    if(command_varargs.size() < 4) {
+                        command_arg_3 = "trace.txt";
+
+                        std::cout << "\tUsing default value \"" << command_arg_3 << "\" of argument #3 of this command." << std::endl;
+                    } else {
+                        command_arg_3 = command_varargs.at(3);
+                    }
+
+                    if(Rhea::Tracer::decode(command_arg_2, command_arg_3)) {
+                        std::cout << "\tDecoded the \"" << command_arg_2 << "\" trace into the \"" << command_arg_3 << "\" file correctly." << std::endl;
+                    }
+                } else if(command_arg_1 == "verify") {
+                    std::uint64_t max_cycles = std::numeric_limits<std::uint64_t>::max() - machine.reference_cycles();
+
+                    if(command_varargs.size() > 3 && !Rhea::parse_number(command_varargs.at(3), max_cycles)) {
+                        std::cerr << "\tCan't parse argument #3 value \"" << command_varargs.at(3) << "\"." << std::endl;
+                        continue;
+                    }
+
+                    if(tracer.is_active() || profiler.is_active()) {
+                        std::cerr << "\tTracing or profiling, stop it first." << std::endl;
+                        continue;
+                    }
+
+                    Rhea::Verifier verifier = Rhea::Verifier();
+
+                    if(!verifier.start(command_arg_2, machine)) {
+                        continue;
+                    }
+
+                    auto start = std::chrono::steady_clock::now();
+
+                    machine.run(std::min(max_cycles, std::numeric_limits<std::uint64_t>::max() - machine.reference_cycles()), verifier);
+                    verifier.stop();
+
+                    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+                    switch(verifier.get_status()) {
+                        case Rhea::Verifier::Status::Finished:
+                            std::cout << "\tMatched the " << verifier.count_checked() << " instruction(s) of the \"" << command_arg_2 << "\" trace in " << std::fixed << std::setprecision(3) << seconds << std::defaultfloat << " s." << std::endl;
+                            break;
+
+                        case Rhea::Verifier::Status::Diverged:
+                            std::cerr << "\tDiverged from the \"" << command_arg_2 << "\" trace after " << verifier.count_checked() << " matching instruction(s), at the \"" << Rhea::format_hex(verifier.get_expected_address()) << "\" address:" << std::endl;
+                            verifier.report(std::cerr);
+                            break;
+
+                        case Rhea::Verifier::Status::Malformed:
+                            std::cerr << "\tFile at \"" << command_arg_2 << "\" is truncated after " << verifier.count_checked() << " matching instruction(s)." << std::endl;
+                            break;
+
+                        default:
+                            if(machine.is_halted()) {
+                                std::cerr << "\tHalted on the illegal opcode \"" << Rhea::format_hex(machine.reference_memory().get(machine.reference_i_pointer()), 2) << "\" after " << verifier.count_checked() << " matching instruction(s), before the trace ended." << std::endl;
+                            } else {
+                                std::cout << "\tMatched " << verifier.count_checked() << " instruction(s) of the \"" << command_arg_2 << "\" trace, stopped at the cycle limit." << std::endl;
+                            }
+
+                            break;
+                    }
+                } else {
+                    std::cerr << "\tCan't parse argument #1 value \"" << command_arg_1 << "\"." << std::endl;
+                }
+
+                continue;
+            }
+
+            case Rhea::Command::Profile: {
+                #if __RHEA_PROFILER__
+                    if(command_varargs.size() < 2) {
+                        std::cerr << "\tAction required as argument #1." << std::endl;
+                        continue;
+                    }
+
+                    command_arg_1 = command_varargs.at(1);
+
+                    if(command_arg_1 == "start") {
+                        if(tracer.is_active()) {
+                            std::cerr << "\tTracing, stop it first." << std::endl;
+                            continue;
+                        }
+
+                        profiler.start(machine);
+
+                        std::cout << "\tProfiling, \"-run\" and \"-step\" are now counted." << std::endl;
+                    } else if(command_arg_1 == "stop") {
+                        profiler.stop();
+
+                        std::cout << "\tCounted " << profiler.count_instructions() << " instruction(s) in " << profiler.count_cycles() << " cycle(s)." << std::endl;
+                    } else if(command_arg_1 == "clear") {
+                        profiler.clear(machine.reference_i_pointer());
+
+                        std::cout << "\tCleared the profile." << std::endl;
+                    } else if(command_arg_1 == "show") {
+                        if(command_varargs.size() < 3) {
+                            command_arg_2 = "A";
+
+                            std::cout << "\tUsing default value \"" << command_arg_2 << "\" of argument #2 of this command." << std::endl;
+                        } else {
+                            command_arg_2 = command_varargs.at(2);
+                        }
+
+                        std::size_t count;
+
+                        if(!Rhea::parse_number(command_arg_2, count)) {
+                            std::cerr << "\tCan't parse argument #2 value \"" << command_arg_2 << "\"." << std::endl;
+                            continue;
+                        }
+
+                        double total = std::max<std::uint64_t>(profiler.count_cycles(), 1) / 100.0;
+
+                        std::cout << "\tCounted " << profiler.count_instructions() << " instruction(s) in " << profiler.count_cycles() << " cycle(s)." << std::endl;
+                        std::cout << std::fixed << std::setprecision(1);
+                        std::cout << "\tOpcodes:" << std::endl;
+
+                        for(const std::pair<std::uint8_t, std::uint64_t> & hot : profiler.get_hot_opcodes(count)) {
+                            std::cout << "\t\t" << Rhea::format_hex(hot.first, 2) << " " << Rhea::Machine::instructions[hot.first].mnemonic << "  " << hot.second << " cycle(s), " << (hot.second / total) << "%" << std::endl;
+                        }
+
+                        std::cout << "\tAddresses:" << std::endl;
+
+                        for(const std::pair<std::uint16_t, std::uint64_t> & hot : profiler.get_hot_addresses(count)) {
+                            std::cout << "\t\t" << Rhea::format_hex(hot.first) << "  " << hot.second << " cycle(s), " << (hot.second / total) << "%" << std::endl;
+                        }
+
+                        std::cout << "\tSubroutines (including callees):" << std::endl;
+
+                        for(const std::pair<std::uint16_t, std::uint64_t> & hot : profiler.get_hot_subroutines(count)) {
+                            std::cout << "\t\t" << Rhea::format_hex(hot.first) << "  " << hot.second << " cycle(s), " << (hot.second / total) << "%, " << profiler.count_calls(hot.first) << " call(s)" << std::endl;
+                        }
+
+                        std::cout << std::defaultfloat;
+                    } else if(command_arg_1 == "folded") {
+                        if(command_varargs.size() < 3) {
+                            command_arg_2 = "profile.folded";
+
+                            std::cout << "\tUsing default value \"" << command_arg_2 << "\" of argument #2 of this command." << std::endl;
+                        } else {
+                            command_arg_2 = command_varargs.at(2);
+                        }
+
+                        if(profiler.write_folded(command_arg_2)) {
+                            std::cout << "\tWrote the folded stacks into the \"" << command_arg_2 << "\" file correctly." << std::endl;
+                        }
+                    } else {
+                        std::cerr << "\tCan't parse argument #1 value \"" << command_arg_1 << "\"." << std::endl;
+                    }
+                #else
+                    std::cout << "\tThe profiler is not available in this build." << std::endl;
+                #endif
+
+                continue;
+            }
+
+            case Rhea::Command::Break: {
+                if(command_varargs.size() < 2) {
+                    std::cerr << "\tAddress required as argument #1." << std::endl;
+                    continue;
+                }
+
+                command_arg_1 = command_varargs.at(1);
+
+                if(command_arg_1 == "list") {
+                    for(const Rhea::Machine::Breakpoint & breakpoint : machine.get_breakpoints()) {
+                        const char * targets[] = { "ar", "xr", "yr", "sr", "sp" };
+                        const char * comparisons[] = { "", "==", "!=", "<", ">", "<=", ">=" };
+
+                        std::cout << "\t" << Rhea::format_hex(breakpoint.address);
+
+                        if(breakpoint.comparison != Rhea::Machine::Comparison::Always) {
+                            std::cout << " if " << targets[static_cast<std::uint8_t> (breakpoint.target)] << " " << comparisons[static_cast<std::uint8_t> (breakpoint.comparison)] << " " << Rhea::format_hex(breakpoint.value, 2);
+                        }
+
+                        std::cout << std::endl;
+                    }
+
+                    continue;
+                }
+
+                if(command_arg_1 == "clear") {
+                    machine.clear_breakpoints();
+
+                    std::cout << "\tRemoved all the breakpoints." << std::endl;
+                    continue;
+                }
+
+                Rhea::Machine::Breakpoint breakpoint = { 0x0000, Rhea::Machine::Target::ARegister, Rhea::Machine::Comparison::Always, 0x00 };
+
+                if(!Rhea::parse_number(command_arg_1, breakpoint.address)) {
+                    std::cerr << "\tCan't parse argument #1 value \"" << command_arg_1 << "\"." << std::endl;
+                    continue;
+                }
+
+                if(command_varargs.size() > 2) {
+                    if(command_varargs.size() < 5) {
+                        std::cerr << "\tCondition requires a register, a comparison and a value." << std::endl;
+                        continue;
+                    }
+
+                    command_arg_2 = command_varargs.at(2);
+                    command_arg_3 = command_varargs.at(3);
+                    command_arg_4 = command_varargs.at(4);
+
+                    const std::string targets[] = { "ar", "xr", "yr", "sr", "sp" };
+                    const std::string comparisons[] = { "", "==", "!=", "<", ">", "<=", ">=" };
+                    std::size_t target = std::find(std::begin(targets), std::end(targets), command_arg_2) - std::begin(targets);
+                    std::size_t comparison = std::find(std::begin(comparisons) + 1, std::end(comparisons), command_arg_3) - std::begin(comparisons);
+
+                    if(target == std::size(targets)) {
+                        std::cerr << "\tCan't parse argument #2 value \"" << command_arg_2 << "\"." << std::endl;
+                        continue;
+                    }
+
+                    if(comparison == std::size(comparisons)) {
+                        std::cerr << "\tCan't parse argument #3 value \"" << command_arg_3 << "\"." << std::endl;
+                        continue;
+                    }
+
+                    if(!Rhea::parse_number(command_arg_4, breakpoint.value)) {
+                        std::cerr << "\tCan't parse argument #4 value \"" << command_arg_4 << "\"." << std::endl;
+                        continue;
+                    }
+
+                    breakpoint.target = static_cast<Rhea::Machine::Target> (target);
+                    breakpoint.comparison = static_cast<Rhea::Machine::Comparison> (comparison);
+                }
+
+                machine.add_breakpoint(breakpoint);
+
+                std::cout << "\tAdded a breakpoint at the \"" << Rhea::format_hex(breakpoint.address) << "\" address." << std::endl;
+
+                if(machine.get_analysis() != nullptr && !(machine.get_analysis()->get_flags(breakpoint.address) & Rhea::Analysis::Flag::Code)) {
+                    std::cout << "\tNo instruction reached from the vectors starts there, it may never be hit." << std::endl;
+                }
+                continue;
+            }
+
+            case Rhea::Command::Watch: {
+                if(command_varargs.size() < 2) {
+                    std::cerr << "\tAddress required as argument #1." << std::endl;
+                    continue;
+                }
+
+                command_arg_1 = command_varargs.at(1);
+
+                if(command_arg_1 == "list") {
+                    for(const Rhea::Memory::Watch & watch : machine.reference_memory().get_watches()) {
+                        std::cout << "\t" << Rhea::format_hex(watch.first) << "-" << Rhea::format_hex(watch.last) << " " << (watch.is_read ? (watch.is_write ? "access" : "read") : "write") << std::endl;
+                    }
+
+                    continue;
+                }
+
+                if(command_arg_1 == "clear") {
+                    machine.reference_memory().clear_watches();
+
+                    std::cout << "\tRemoved all the watchpoints." << std::endl;
+                    continue;
+                }
+
+                if(command_varargs.size() < 3) {
+                    command_arg_2 = command_arg_1;
+
+                    std::cout << "\tUsing default value \"" << command_arg_2 << "\" of argument #2 of this command." << std::endl;
+                } else {
+                    command_arg_2 = command_varargs.at(2);
+                }
+
+                if(command_varargs.size() < 4) {
+                    command_arg_3 = "access";
+
+                    std::cout << "\tUsing default value \"" << command_arg_3 << "\" of argument #3 of this command." << std::endl;
+                } else {
+                    command_arg_3 = command_varargs.at(3);
+                }
+
+                if(!Rhea::parse_number(command_arg_1, word_1)) {
+                    std::cerr << "\tCan't parse argument #1 value \"" << command_arg_1 << "\"." << std::endl;
+                    continue;
+                }
+
+                if(!Rhea::parse_number(command_arg_2, word_2)) {
+                    std::cerr << "\tCan't parse argument #2 value \"" << command_arg_2 << "\"." << std::endl;
+                    continue;
+                }
+
+                is_option_1 = command_arg_3 == "read";
+                is_option_2 = command_arg_3 == "write";
+                is_option_3 = command_arg_3 == "access";
+
+                if(!is_option_1 && !is_option_2 && !is_option_3) {
+                    std::cerr << "\tCan't parse argument #3 value \"" << command_arg_3 << "\"." << std::endl;
+                    continue;
+                }
+
+                if(word_2 < word_1) {
+                    std::cerr << "\tThe last address can't be lower than the first one." << std::endl;
+                    continue;
+                }
+
+                machine.reference_memory().watch({ word_1, word_2, is_option_1 || is_option_3, is_option_2 || is_option_3 });
+
+                std::cout << "\tWatching the \"" << Rhea::format_hex(word_1) << "\" to \"" << Rhea::format_hex(word_2) << "\" addresses." << std::endl;
+                continue;
+            }
+
+            case Rhea::Command::Fill: {
+                if(command_varargs.size() < 4) {
+                    std::cerr << "\tFirst address, last address and value required as arguments #1, #2 and #3." << std::endl;
+                    continue;
+                }
+
+                command_arg_1 = command_varargs.at(1);
+                command_arg_2 = command_varargs.at(2);
+                command_arg_3 = command_varargs.at(3);
+
+                if(!Rhea::parse_number(command_arg_1, word_1)) {
+                    std::cerr << "\tCan't parse argument #1 value \"" << command_arg_1 << "\"." << std::endl;
+                    continue;
+                }
+
+                if(!Rhea::parse_number(command_arg_2, word_2)) {
+                    std::cerr << "\tCan't parse argument #2 value \"" << command_arg_2 << "\"." << std::endl;
+                    continue;
+                }
+
+                if(!Rhea::parse_number(command_arg_3, byte_1)) {
+                    std::cerr << "\tCan't parse argument #3 value \"" << command_arg_3 << "\"." << std::endl;
+                    continue;
+                }
+
+                if(word_2 < word_1) {
+                    std::cerr << "\tThe last address can't be lower than the first one." << std::endl;
+                    continue;
+                }
+
+                machine.reference_memory().fill(word_1, word_2, byte_1);
+
+                std::cout << "\tThe values from the \"" << Rhea::format_hex(word_1) << "\" to the \"" << Rhea::format_hex(word_2) << "\" address are now \"" << Rhea::format_hex(byte_1, 2) << "\"." << std::endl;
+                continue;
+            }
+
+            case Rhea::Command::Copy: {
+                if(command_varargs.size() < 4) {
+                    std::cerr << "\tSource, destination and count required as arguments #1, #2 and #3." << std::endl;
+                    continue;
+                }
+
+                command_arg_1 = command_varargs.at(1);
+                command_arg_2 = command_varargs.at(2);
+                command_arg_3 = command_varargs.at(3);
+
+                std::uint32_t count;
+
+                if(!Rhea::parse_number(command_arg_1, word_1)) {
+                    std::cerr << "\tCan't parse argument #1 value \"" << command_arg_1 << "\"." << std::endl;
+                    continue;
+                }
+
+                if(!Rhea::parse_number(command_arg_2, word_2)) {
+                    std::cerr << "\tCan't parse argument #2 value \"" << command_arg_2 << "\"." << std::endl;
+                    continue;
+                }
+
+                if(!Rhea::parse_number(command_arg_3, count)) {
+                    std::cerr << "\tCan't parse argument #3 value \"" << command_arg_3 << "\"." << std::endl;
+                    continue;
+                }
+
+                if(word_1 + count > 0x10000 || word_2 + count > 0x10000) {
+                    std::cerr << "\tArgument #3 is out of range." << std::endl;
+                    continue;
+                }
+
+                machine.reference_memory().copy(word_1, word_2, count);
+
+                std::cout << "\tCopied " << count << " byte(s) from the \"" << Rhea::format_hex(word_1) << "\" to the \"" << Rhea::format_hex(word_2) << "\" address." << std::endl;
+                continue;
+            }
+
+            case Rhea::Command::Find: {
+                if(command_varargs.size() < 2) {
+                    std::cerr << "\tPattern required as arguments #1 and onwards." << std::endl;
+                    continue;
+                }
+
+                std::vector<std::uint8_t> pattern;
+                std::vector<std::uint16_t> matches;
+
+                for(std::size_t index = 1; index < command_varargs.size(); index++) {
+                    pattern.push_back(0x00);
+
+                    if(!Rhea::parse_number(command_varargs.at(index), pattern.back())) {
+                        std::cerr << "\tCan't parse argument #" << index << " value \"" << command_varargs.at(index) << "\"." << std::endl;
+                        pattern.clear();
+                        break;
+                    }
+                }
+
+                if(pattern.empty()) {
+                    continue;
+                }
+
+                auto start = std::chrono::steady_clock::now();
+
+                for(std::int32_t address = machine.reference_memory().find(0x0000, 0xFFFF, pattern); address >= 0; address = machine.reference_memory().find(address + 1, 0xFFFF, pattern)) {
+                    matches.push_back(address);
+
+                    if(address == 0xFFFF) {
+                        break;
+                    }
+                }
+
+                double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+                for(std::uint16_t address : matches) {
+                    std::cout << "\t" << Rhea::format_hex(address) << std::endl;
+                }
+
+                std::cout << "\tFound " << matches.size() << " match(es) in " << std::fixed << std::setprecision(1) << (seconds * 1e6) << std::defaultfloat << " microsecond(s)." << std::endl;
+                continue;
+            }
+
+            case Rhea::Command::Diff: {
+                if(command_varargs.size() < 2) {
+                    std::cerr << "\tFile required as argument #1." << std::endl;
+                    continue;
+                }
+
+                command_arg_1 = command_varargs.at(1);
+
+                if(command_varargs.size() < 3) {
+                    command_arg_2 = "8000";
+
+                    std::cout << "\tUsing default value \"" << command_arg_2 << "\" of argument #2 of this command." << std::endl;
+                } else {
+                    command_arg_2 = command_varargs.at(2);
+                }
+
+                if(!Rhea::parse_number(command_arg_2, word_1)) {
+                    std::cerr << "\tCan't parse argument #2 value \"" << command_arg_2 << "\"." << std::endl;
+                    continue;
+                }
+
+                std::ifstream file = std::ifstream(command_arg_1, std::ios::binary);
+                std::vector<std::uint8_t> bytes = std::vector<std::uint8_t>(0x10000 - word_1);
+
+                if(!file.is_open()) {
+                    std::cerr << "\tFile at \"" << command_arg_1 << "\" not found." << std::endl;
+                    continue;
+                }
+
+                file.read(reinterpret_cast<char *> (bytes.data()), bytes.size());
+
+                std::vector<std::pair<std::uint16_t, std::uint16_t>> runs = machine.reference_memory().diff(word_1, bytes.data(), file.gcount());
+
+                for(const std::pair<std::uint16_t, std::uint16_t> & run : runs) {
+                    std::cout << "\t" << Rhea::format_hex(run.first) << "-" << Rhea::format_hex(run.second) << " (" << (run.second - run.first + 1) << " byte(s))" << std::endl;
+                }
+
+                std::cout << "\tCompared " << file.gcount() << " byte(s), " << runs.size() << " range(s) differ." << std::endl;
+                continue;
+            }
+
+            case Rhea::Command::Help: {
+                if(command_varargs.size() < 2) {
+                    std::cerr << "\tCommand name required as argument #1." << std::endl;
+                    continue;
+                } else {
+                    command_arg_1 = command_varargs.at(1);
+                }
+
+                switch(Rhea::parse_command("-" + command_arg_1)) { // The topics are the names of the commands.
+                    case Rhea::Command::Dump: {
+                        std::cout << "\tdump <file : string> [full]"<< std::endl;
+                        std::cout << std::endl;
+                        std::cout << "\tDumps the state of the machine into a text \"file\". This is just the" << std::endl;
+                        std::cout << "\tcurrent values of the AR, XR, YR and SR; anlog with the values that IP" << std::endl;
+                        std::cout << "\tand SP currently point to. Also a view to the next 255 bytes after the" << std::endl;
+                        std::cout << "\tvalue IP is currently pointing to is provided (including IP). With" << std::endl;
+                        std::cout << "\t\"full\" the view covers the whole memory, with the address of each line." << std::endl;
+                        std::cout << "\tThe 16 instructions from IP are listed too." << std::endl;
+                        continue;
+                    }
+
+                    case Rhea::Command::Get: {
+                        std::cout << "\tget <address : number>"<< std::endl;
+                        std::cout << "\tget <internal : string (ar | xr | yr | sr | ip | sp)>"<< std::endl;
+                        std::cout << std::endl;
+                        std::cout << "\tGets the value at the specified \"address\" on the memory or at the" << std::endl;
+                        std::cout << "\tspecified \"internal\" register/pointer. The value can be a byte or a" << std::endl;
+                        std::cout << "\tword depending of the register/pointer, but with the addresses it will" << std::endl;
+                        std::cout << "\talways be a byte." << std::endl;
+                        continue;
+                    }
+
+                    case Rhea::Command::Jump: {
+                        std::cout << "\tjump [sign: string (+ | -)]<address: number>"<< std::endl;
+                        std::cout << std::endl;
+                        std::cout << "\tJumps (sets IP) to an specific \"address\" in the memory. If the \"sign\"" << std::endl;
+                        std::cout << "\tis + the machine jumps to [IP + \"address\"]; else, if it's - the machine" << std::endl;
+                        std::cout << "\tjumps to [IP - \"address\"]. If there is no \"sign\" the machine just" << std::endl;
+                        std::cout << "\tjumps to the \"address\"." << std::endl;
+                        continue;
+                    }
+
+                    case Rhea::Command::Load: {
+                        std::cout << "\tload <file : string> [mode : string (copy | map)]"<< std::endl;
+                        std::cout << std::endl;
+                        std::cout << "\tLoads the ROM from a binary \"file\" of 32 KB. With the \"map\" mode the" << std::endl;
+                        std::cout << "\tfile is mapped copy-on-write instead of copied, so machines loading the" << std::endl;
+                        std::cout << "\tsame file share it until they write to it." << std::endl;
+                        continue;
+                    }
+
+                    case Rhea::Command::Save: {
+                        std::cout << "\tsave <file : string>"<< std::endl;
+                        std::cout << std::endl;
+                        std::cout << "\tSaves the ROM into a binary \"file\" of 32 KB. If the \"file\" is the one" << std::endl;
+                        std::cout << "\tthe ROM was loaded from or last saved to, only the pages written since" << std::endl;
+                        std::cout << "\tthen are written back." << std::endl;
+                        continue;
+                    }
+
+                    case Rhea::Command::Set: {
+                        std::cout << "\tset <address : number> <value: number>"<< std::endl;
+                        std::cout << "\tset <internal : string (ar | xr | yr | sr | ip | sp)> <value: number>"<< std::endl;
+                        std::cout << std::endl;
+                        std::cout << "\tSets the \"value\" at the specified \"address\" on the memory or at the" << std::endl;
+                        std::cout << "\tspecified \"internal\" register/pointer. The \"value\" can be a byte or a" << std::endl;
+                        std::cout << "\tword depending of the register/pointer, but with the addresses it will" << std::endl;
+                        std::cout << "\talways be a byte." << std::endl;
+                        continue;
+                    }
+
+                    case Rhea::Command::Step: {
+                        std::cout << "\tstep [count : number]"<< std::endl;
+                        std::cout << std::endl;
+                        std::cout << "\tExecutes the next \"count\" instructions (1 by default), starting at the" << std::endl;
+                        std::cout << "\tone IP is currently pointing to. Stops early if an illegal opcode is" << std::endl;
+                        std::cout << "\tfound, leaving IP pointing to it." << std::endl;
+                        continue;
+                    }
+
+                    case Rhea::Command::Run: {
+                        std::cout << "\trun [max_cycles : number]"<< std::endl;
+                        std::cout << std::endl;
+                        std::cout << "\tExecutes instructions until \"max_cycles\" cycles have elapsed or an" << std::endl;
+                        std::cout << "\tillegal opcode halts the machine. The number of instructions, cycles" << std::endl;
+                        std::cout << "\tand the host speed are reported afterwards." << std::endl;
+                        continue;
+                    }
+
+                    case Rhea::Command::Dispatch: {
+                        std::cout << "\tdispatch [max_cycles : number]"<< std::endl;
+                        std::cout << std::endl;
+                        std::cout << "\tBenchmarks the switch, threaded and cached dispatch strategies by" << std::endl;
+                        std::cout << "\trunning copies of the machine for \"max_cycles\" cycles each. The machine" << std::endl;
+                        std::cout << "\titself is left untouched, and all the copies must end in the same state." << std::endl;
+                        continue;
+                    }
+
+                    case Rhea::Command::Cache: {
+                        std::cout << "\tcache [state : string (on | off | flush)]"<< std::endl;
+                        std::cout << std::endl;
+                        std::cout << "\tTurns the translation cache on or off, or drops all of its blocks. When" << std::endl;
+                        std::cout << "\ton, run decodes each straight-line block once and executes it from the" << std::endl;
+                        std::cout << "\tcache afterwards; writes into a block drop it. The hits, misses and" << std::endl;
+                        std::cout << "\tinvalidations are reported afterwards." << std::endl;
+                        continue;
+                    }
+
+                    case Rhea::Command::Attach: {
+                        std::cout << "\tattach <device : string (ram | console | random)> <page : number>"<< std::endl;
+                        std::cout << std::endl;
+                        std::cout << "\tAttaches a \"device\" to the 256 bytes of a \"page\" of the memory. The" << std::endl;
+                        std::cout << "\tconsole prints the characters written to its first byte, the random" << std::endl;
+                        std::cout << "\tdevice returns a pseudo-random byte on every read, and ram detaches any" << std::endl;
+                        std::cout << "\tdevice, leaving plain memory." << std::endl;
+                        continue;
+                    }
+
+                    case Rhea::Command::Protect: {
+                        std::cout << "\tprotect [first_page : number] [last_page : number] [state : string (on | off)]"<< std::endl;
+                        std::cout << std::endl;
+                        std::cout << "\tMakes the pages from \"first_page\" to \"last_page\" (the ROM by default)" << std::endl;
+                        std::cout << "\treject or accept the writes of the machine. The set command bypasses the" << std::endl;
+                        std::cout << "\tprotection." << std::endl;
+                        continue;
+                    }
+
+                    case Rhea::Command::MemBench: {
+                        std::cout << "\tmembench [count : number]"<< std::endl;
+                        std::cout << std::endl;
+                        std::cout << "\tMeasures \"count\" random reads and writes on the RAM pages of the memory" << std::endl;
+                        std::cout << "\tbus against the same accesses on a flat array." << std::endl;
+                        continue;
+                    }
+
+                    case Rhea::Command::Batch: {
+                        std::cout << "\tbatch <manifest : string> [results : string]"<< std::endl;
+                        std::cout << std::endl;
+                        std::cout << "\tRuns every job of the \"manifest\" on its own machine, spread across all" << std::endl;
+                        std::cout << "\tthe host cores. Each line of the \"manifest\" is a job:" << std::endl;
+                        std::cout << std::endl;
+                        std::cout << "\t<rom : string> [max_cycles : number] [input : string] [console_page : number]" << std::endl;
+                        std::cout << std::endl;
+                        std::cout << "\tThe \"input\" file is fed to a console attached to \"console_page\" (40 by" << std::endl;
+                        std::cout << "\tdefault). The final registers, cycles and exit reason of every job are" << std::endl;
+                        std::cout << "\twritten into \"results\", and the aggregate speed is reported. The same" << std::endl;
+                        std::cout << "\truns headless with: Rhea --batch <manifest> [results]" << std::endl;
+                        continue;
+                    }
+
+                    case Rhea::Command::Snapshot: {
+                        std::cout << "\tsnapshot"<< std::endl;
+                        std::cout << std::endl;
+                        std::cout << "\tTakes a snapshot of the registers, pointers, cycles and memory and gives" << std::endl;
+                        std::cout << "\tit the next number. Only the pages written since the last snapshot are" << std::endl;
+                        std::cout << "\tcopied, so taking them often is cheap." << std::endl;
+                        continue;
+                    }
+
+                    case Rhea::Command::Restore: {
+                        std::cout << "\trestore [snapshot : number]"<< std::endl;
+                        std::cout << std::endl;
+                        std::cout << "\tRestores the state of the \"snapshot\" with that number, the last one by" << std::endl;
+                        std::cout << "\tdefault. Snapshots taken after it are kept, so the machine can go back" << std::endl;
+                        std::cout << "\tand forth between them." << std::endl;
+                        continue;
+                    }
+
+                    case Rhea::Command::Trace: {
+                        std::cout << "\ttrace <action : string (start | stop)> [file : string]"<< std::endl;
+                        std::cout << "\ttrace decode [file : string] [text : string]"<< std::endl;
+                        std::cout << "\ttrace verify [file : string] [cycles : number]"<< std::endl;
+                        std::cout << std::endl;
+                        std::cout << "\tStarts or stops recording every instruction executed by \"-run\" and" << std::endl;
+                        std::cout << "\t\"-step\" into the binary \"file\" (trace.bin by default). Each record" << std::endl;
+                        std::cout << "\tholds the IP, the opcode, the registers that changed and the writes" << std::endl;
+                        std::cout << "\tthrough the bus, encoded against the previous record. The \"decode\"" << std::endl;
+                        std::cout << "\taction turns a trace into a \"text\" file, one line per instruction." << std::endl;
+                        std::cout << "\tThe \"verify\" action runs the machine, from the state the trace starts" << std::endl;
+                        std::cout << "\tfrom, checking every instruction against the trace until it ends, up to" << std::endl;
+                        std::cout << "\t\"cycles\"; it stops at the first divergence and reports what differs." << std::endl;
+                        continue;
+                    }
+
+                    case Rhea::Command::Break: {
+                        std::cout << "\tbreak <address : number> [register : string (ar | xr | yr | sr | sp)] [comparison : string (== | != | < | > | <= | >=)] [value : number]"<< std::endl;
+                        std::cout << "\tbreak <action : string (list | clear)>"<< std::endl;
+                        std::cout << std::endl;
+                        std::cout << "\tMakes \"-run\" stop before executing the instruction at \"address\", only" << std::endl;
+                        std::cout << "\tif the \"register\" compares true against \"value\" when they are given." << std::endl;
+                        std::cout << "\tThe instruction \"-run\" starts at is never checked, so running again" << std::endl;
+                        std::cout << "\tresumes. With no breakpoints nor watchpoints \"-run\" isn't slowed down." << std::endl;
+                        continue;
+                    }
+
+                    case Rhea::Command::Watch: {
+                        std::cout << "\twatch <first : number> [last : number] [mode : string (read | write | access)]"<< std::endl;
+                        std::cout << "\twatch <action : string (list | clear)>"<< std::endl;
+                        std::cout << std::endl;
+                        std::cout << "\tMakes \"-run\" stop right after an instruction reads or writes (or both" << std::endl;
+                        std::cout << "\twith \"access\", by default) an address from \"first\" to \"last\". Only" << std::endl;
+                        std::cout << "\tthe data accesses count, the instruction fetches don't." << std::endl;
+                        continue;
+                    }
+
+                    case Rhea::Command::LoadAt: {
+                        std::cout << "\tload-at <address : number> <file : string>"<< std::endl;
+                        std::cout << std::endl;
+                        std::cout << "\tLoads a partial image from the \"file\" starting at \"address\", ignoring" << std::endl;
+                        std::cout << "\twhatever doesn't fit below FFFF. Like \"-set\", devices and the write" << std::endl;
+                        std::cout << "\tprotection are bypassed." << std::endl;
+                        continue;
+                    }
+
+                    case Rhea::Command::Fill: {
+                        std::cout << "\tfill <first : number> <last : number> <value : number>"<< std::endl;
+                        std::cout << std::endl;
+                        std::cout << "\tSets every byte from \"first\" to \"last\" to \"value\"." << std::endl;
+                        continue;
+                    }
+
+                    case Rhea::Command::Copy: {
+                        std::cout << "\tcopy <source : number> <destination : number> <count : number>"<< std::endl;
+                        std::cout << std::endl;
+                        std::cout << "\tCopies \"count\" bytes from \"source\" to \"destination\". The ranges can" << std::endl;
+                        std::cout << "\toverlap." << std::endl;
+                        continue;
+                    }
+
+                    case Rhea::Command::Find: {
+                        std::cout << "\tfind <byte : number> [byte : number]..."<< std::endl;
+                        std::cout << std::endl;
+                        std::cout << "\tLists every address of the memory where the pattern of bytes starts." << std::endl;
+                        continue;
+                    }
+
+                    case Rhea::Command::HexBench: {
+                        std::cout << "\thexbench [count : number]"<< std::endl;
+                        std::cout << std::endl;
+                        std::cout << "\tMeasures \"count\" full memory dumps built with the hexadecimal table" << std::endl;
+                        std::cout << "\tagainst the same dumps built with a string stream per value." << std::endl;
+                        continue;
+                    }
+
+                    case Rhea::Command::Bench: {
+                        std::cout << "\tbench [cycles : number] [file : string]"<< std::endl;
+                        std::cout << std::endl;
+                        std::cout << "\tRuns the synthetic ALU, copy, branch and stack ROMs and a copy of the" << std::endl;
+                        std::cout << "\tloaded machine for \"cycles\" cycles each, keeping the fastest of three" << std::endl;
+                        std::cout << "\truns, then measures the memory bus. The results are written as JSON" << std::endl;
+                        std::cout << "\tinto the \"file\" (bench.json by default). The same suite runs headless" << std::endl;
+                        std::cout << "\twith \"Rhea --bench [file] [cycles]\"." << std::endl;
+                        continue;
+                    }
+
+                    case Rhea::Command::Profile: {
+                        std::cout << "\tprofile <action : string (start | stop | clear)>"<< std::endl;
+                        std::cout << "\tprofile show [count : number]"<< std::endl;
+                        std::cout << "\tprofile folded [file : string]"<< std::endl;
+                        std::cout << std::endl;
+                        std::cout << "\tWhile started, \"-run\" and \"-step\" count the cycles of every opcode and" << std::endl;
+                        std::cout << "\taddress, and follow JSR and RTS to build a call graph. \"show\" lists the" << std::endl;
+                        std::cout << "\t\"count\" hottest opcodes, addresses and subroutines; \"folded\" writes the" << std::endl;
+                        std::cout << "\tcall graph as folded stacks for flame graph tools (profile.folded by" << std::endl;
+                        std::cout << "\tdefault). Stopping keeps the counts, \"clear\" drops them. Profiling and" << std::endl;
+                        std::cout << "\ttracing can't be used at the same time." << std::endl;
+                        continue;
+                    }
+
+                    case Rhea::Command::Clock: {
+                        std::cout << "\tclock [rate : number (decimal) | max]"<< std::endl;
+                        std::cout << std::endl;
+                        std::cout << "\tSets the clock \"-run\" emulates, in cycles per second, or lets it run as" << std::endl;
+                        std::cout << "\tfast as possible with \"max\" (the default). Clocked runs go in 5 ms slices" << std::endl;
+                        std::cout << "\tand sleep between them, spinning only the last 0.1 ms. Each run reports" << std::endl;
+                        std::cout << "\tits drift from real time; without arguments the drift, the worst lag" << std::endl;
+                        std::cout << "\tand the host usage since the clock was set are reported." << std::endl;
+                        continue;
+                    }
+
+                    case Rhea::Command::Reset:
+                    case Rhea::Command::Irq:
+                    case Rhea::Command::Nmi: {
+                        std::cout << "\treset"<< std::endl;
+                        std::cout << "\tirq"<< std::endl;
+                        std::cout << "\tnmi"<< std::endl;
+                        std::cout << std::endl;
+                        std::cout << "\tResets the machine through the vector at FFFC (8000 if it's 0000), which" << std::endl;
+                        std::cout << "\tloading a ROM also does; or requests an IRQ (vector at FFFE, taken once" << std::endl;
+                        std::cout << "\tinterrupts are enabled) or an NMI (vector at FFFA, always taken). The" << std::endl;
+                        std::cout << "\tinterrupts are taken before the next instruction run." << std::endl;
+                        continue;
+                    }
+
+                    case Rhea::Command::Timer: {
+                        std::cout << "\ttimer <period : number> [kind : string (irq | nmi)]"<< std::endl;
+                        std::cout << "\ttimer off"<< std::endl;
+                        std::cout << std::endl;
+                        std::cout << "\tRequests an interrupt of the \"kind\" (irq by default) every \"period\"" << std::endl;
+                        std::cout << "\tcycles from now on, or stops every timer." << std::endl;
+                        continue;
+                    }
+
+                    case Rhea::Command::SaveState:
+                    case Rhea::Command::LoadState: {
+                        std::cout << "\tsavestate <file : string> [raw]"<< std::endl;
+                        std::cout << "\tloadstate <file : string>"<< std::endl;
+                        std::cout << std::endl;
+                        std::cout << "\tSaves the whole machine into a binary \"file\": registers, pointers," << std::endl;
+                        std::cout << "\tcycles, pending interrupts, write protection, device states and the 64 KB" << std::endl;
+                        std::cout << "\tof memory, compressed unless \"raw\" is given; or loads it back. The file" << std::endl;
+                        std::cout << "\tis versioned and checksummed, and nothing changes if it doesn't check out." << std::endl;
+                        std::cout << "\tTimers aren't saved, and device states only go to devices attached at" << std::endl;
+                        std::cout << "\tthe same pages." << std::endl;
+                        continue;
+                    }
+
+                    case Rhea::Command::Swarm: {
+                        std::cout << "\tswarm <lanes : number> [cycles : number] [address : number]"<< std::endl;
+                        std::cout << std::endl;
+                        std::cout << "\tRuns \"lanes\" copies of the machine for \"cycles\" (10000 by default) in" << std::endl;
+                        std::cout << "\tlockstep, each with its lane number as the byte at \"address\" (0000 by" << std::endl;
+                        std::cout << "\tdefault), and once more as separate machines. Checks the lanes end up as" << std::endl;
+                        std::cout << "\ttheir machines and compares the throughputs. The lanes share the memory" << std::endl;
+                        std::cout << "\tuntil they write to it, and have no devices, timers nor interrupts. The" << std::endl;
+                        std::cout << "\tmachine is left as it was." << std::endl;
+                        continue;
+                    }
+
+                    case Rhea::Command::Disasm:
+                    case Rhea::Command::Asm:
+                    case Rhea::Command::Assemble: {
+                        std::cout << "\tdisasm [address : number] [count : number]"<< std::endl;
+                        std::cout << "\tasm [address : number]"<< std::endl;
+                        std::cout << "\tassemble <file : string>"<< std::endl;
+                        std::cout << std::endl;
+                        std::cout << "\tLists \"count\" (16 by default) instructions from \"address\" (IP by" << std::endl;
+                        std::cout << "\tdefault); assembles the lines that follow into the memory from \"address\"," << std::endl;
+                        std::cout << "\tup to a blank line or \".\"; or assembles a source \"file\", where the" << std::endl;
+                        std::cout << "\tlabels can be used before they're defined. The lines are like" << std::endl;
+                        std::cout << "\t\"loop: LDA ($10),Y ; comment\", with .org, .byte, .word and \"name = value\"." << std::endl;
+                        std::cout << "\tValues are $hexadecimal, %binary, decimal, 'c' or labels, added or" << std::endl;
+                        std::cout << "\tsubtracted, with < or > for their low or high byte." << std::endl;
+                        continue;
+                    }
+
+                    case Rhea::Command::Journal:
+                    case Rhea::Command::Replay: {
+                        std::cout << "\tjournal <file : string> [period : number]"<< std::endl;
+                        std::cout << "\tjournal off"<< std::endl;
+                        std::cout << "\treplay <file : string> [cycle : number]"<< std::endl;
+                        std::cout << std::endl;
+                        std::cout << "\tRecords what the devices return and the interrupt requests into the" << std::endl;
+                        std::cout << "\t\"file\", by cycle, with a checkpoint of the machine every \"period\"" << std::endl;
+                        std::cout << "\tcycles (100000 by default) and after each command changing it; or stops" << std::endl;
+                        std::cout << "\trecording. Replaying loads the last checkpoint before \"cycle\" (the end" << std::endl;
+                        std::cout << "\tby default) and runs from there feeding the recorded inputs, reporting" << std::endl;
+                        std::cout << "\twhere the machine diverges. It needs the devices attached when recording," << std::endl;
+                        std::cout << "\tat the same pages, and drops the timers, their interrupts are recorded." << std::endl;
+                        continue;
+                    }
+
+                    case Rhea::Command::Analyze: {
+                        std::cout << "\tanalyze"<< std::endl;
+                        std::cout << "\tanalyze block <address : number>"<< std::endl;
+                        std::cout << "\tanalyze roms <file : string> [file : string]..."<< std::endl;
+                        std::cout << std::endl;
+                        std::cout << "\tFollows the code from the NMI, reset and IRQ vectors through every branch," << std::endl;
+                        std::cout << "\tjump and call, and reports the blocks, the unreached parts of the ROM" << std::endl;
+                        std::cout << "\t(padding aside), the code writing into code and the illegal opcodes" << std::endl;
+                        std::cout << "\treached; or shows the block at \"address\" with its edges; or analyzes ROM" << std::endl;
+                        std::cout << "\tfiles across all the host cores. Loads are analyzed on their own, for the" << std::endl;
+                        std::cout << "\tdumps and the breakpoints. The same runs headless with:" << std::endl;
+                        std::cout << "\tRhea --analyze <file> [file]..." << std::endl;
+                        continue;
+                    }
+
+                    case Rhea::Command::Stats: {
+                        std::cout << "\tstats [clear]"<< std::endl;
+                        std::cout << "\tstats pages <state : string (on | off)>"<< std::endl;
+                        std::cout << "\tstats publish <file : string> [interval : number]"<< std::endl;
+                        std::cout << "\tstats publish off"<< std::endl;
+                        std::cout << std::endl;
+                        std::cout << "\tShows the instructions, cycles and interrupts counted so far, and the" << std::endl;
+                        std::cout << "\thost speed since the last time; or sets them back to 0; or counts the" << std::endl;
+                        std::cout << "\treads and writes of each page (every access takes the slow path then);" << std::endl;
+                        std::cout << "\tor publishes them from a background thread every \"interval\" ms (1000" << std::endl;
+                        std::cout << "\tby default, decimal) in the Prometheus text format: into the \"file\"," << std::endl;
+                        std::cout << "\tor to the clients of a Unix socket with \"unix:<path>\"." << std::endl;
+                        continue;
+                    }
+
+                    case Rhea::Command::Diff: {
+                        std::cout << "\tdiff <file : string> [address : number]"<< std::endl;
+                        std::cout << std::endl;
+                        std::cout << "\tCompares the memory from \"address\" (8000 by default) against the" << std::endl;
+                        std::cout << "\tcontents of the \"file\" and lists the ranges that differ." << std::endl;
+                        continue;
+                    }
+
+
+                    default:
+                        std::cerr << "\tUnrecognized help topic \"" << command_arg_1 << "\"." << std::endl;
+                        continue;
+                }
+            }
+
+            default:
+                break;
+        }
+
+        if(!is_interactive && (command_varargs.empty() || Rhea::is_prefixed(command_varargs.front(), "#"))) { // Blank lines and comments of scripts.
+            continue;
+        }
+
+        std::cerr << "\tUnrecognized command \"" << command << "\"." << std::endl;
+    }
+
+    if(is_journal_paused) {
+        journal.resume(journaled_command);
+    }
+
+    if(journal.is_active()) {
+        journal.stop();
+    }
+
+    if(!is_interactive) {
+        if(command_errors.tellp() > 0) {
+            report_errors();
+        }
+
+        batched_output.drain();
+        std::cout.rdbuf(output_buffer);
+        std::cerr.rdbuf(error_buffer);
     }
 
-    return 0;
+    return errors > 0 ? 1 : 0;
 }
\ No newline at end of file
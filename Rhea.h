@@ -0,0 +1,237 @@
+#ifndef __RHEA_H__
+#define __RHEA_H__
+
+//--------------------------------------------------//
+// Headers
+//--------------------------------------------------//
+#include <stddef.h>
+#include <stdint.h>
+
+//--------------------------------------------------//
+// Definitions
+//--------------------------------------------------//
+
+/**
+ * @brief Visibility of the functions of the C interface, the rest of the library stays hidden.
+ */
+#if defined(_WIN32)
+    #if defined(__RHEA_EXPORTS__)
+        #define __RHEA_API__ __declspec(dllexport)
+    #else
+        #define __RHEA_API__
+    #endif
+#elif defined(__GNUC__)
+    #define __RHEA_API__ __attribute__((visibility("default")))
+#else
+    #define __RHEA_API__
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------------------------//
+// Types
+//--------------------------------------------------//
+
+/**
+ * @brief A machine, only handled through pointers.
+ */
+typedef struct rhea_machine rhea_machine;
+
+/**
+ * @brief Registers and pointers of a machine.
+ */
+typedef enum rhea_register {
+    RHEA_AR = 0,
+    RHEA_XR = 1,
+    RHEA_YR = 2,
+    RHEA_SR = 3,
+    RHEA_SP = 4,
+    RHEA_IP = 5
+} rhea_register;
+
+/**
+ * @brief Reads a byte from an attached range, called by the machine from the thread running it.
+ * @param context The context given to rhea_attach.
+ * @param address The address.
+ * @return The byte.
+ */
+typedef uint8_t (*rhea_read_callback)(void * context, uint16_t address);
+
+/**
+ * @brief Writes a byte into an attached range, called by the machine from the thread running it.
+ * @param context The context given to rhea_attach.
+ * @param address The address.
+ * @param value The byte.
+ */
+typedef void (*rhea_write_callback)(void * context, uint16_t address, uint8_t value);
+
+//--------------------------------------------------//
+// Functions
+//--------------------------------------------------//
+
+/**
+ * @brief Gets the version of the library.
+ * @return The version, like "0.1.0-alpha.9".
+ */
+__RHEA_API__ const char * rhea_version(void);
+
+/**
+ * @brief Creates a machine with cleared memory. Machines share nothing, so different threads can run different
+ *        machines at once.
+ * @return The machine, null if it couldn't be allocated.
+ */
+__RHEA_API__ rhea_machine * rhea_create(void);
+
+/**
+ * @brief Creates a copy of a machine: registers, memory and attached ranges (whose callbacks are shared).
+ * @param machine The machine.
+ * @return The copy, null if it couldn't be allocated.
+ */
+__RHEA_API__ rhea_machine * rhea_clone(const rhea_machine * machine);
+
+/**
+ * @brief Destroys a machine.
+ * @param machine The machine, can be null.
+ */
+__RHEA_API__ void rhea_destroy(rhea_machine * machine);
+
+/**
+ * @brief Loads a ROM image from a buffer into 8000-FFFF, clearing the rest of the ROM, and resets the machine.
+ * @param machine The machine.
+ * @param rom The image.
+ * @param size The size of the image, up to 32 KB.
+ * @return 0 on success, -1 if the image doesn't fit.
+ */
+__RHEA_API__ int rhea_load(rhea_machine * machine, const uint8_t * rom, size_t size);
+
+/**
+ * @brief Resets the machine through the vector at FFFC.
+ * @param machine The machine.
+ */
+__RHEA_API__ void rhea_reset(rhea_machine * machine);
+
+/**
+ * @brief Executes a number of instructions, fewer if the machine halts.
+ * @param machine The machine.
+ * @param count The number of instructions.
+ * @return The number of instructions executed.
+ */
+__RHEA_API__ uint64_t rhea_step(rhea_machine * machine, uint64_t count);
+
+/**
+ * @brief Executes instructions until a number of cycles has elapsed or the machine halts.
+ * @param machine The machine.
+ * @param cycles The number of cycles.
+ * @return The number of instructions executed.
+ */
+__RHEA_API__ uint64_t rhea_run(rhea_machine * machine, uint64_t cycles);
+
+/**
+ * @brief Gets the cycles elapsed since the machine was created.
+ * @param machine The machine.
+ * @return The cycles.
+ */
+__RHEA_API__ uint64_t rhea_get_cycles(const rhea_machine * machine);
+
+/**
+ * @brief Checks if the machine stopped on an illegal opcode.
+ * @param machine The machine.
+ * @return 1 if it's halted, 0 otherwise.
+ */
+__RHEA_API__ int rhea_is_halted(const rhea_machine * machine);
+
+/**
+ * @brief Gets a register or pointer.
+ * @param machine The machine.
+ * @param name The register or pointer.
+ * @return Its value, only IP takes 16 bits.
+ */
+__RHEA_API__ uint16_t rhea_get_register(const rhea_machine * machine, rhea_register name);
+
+/**
+ * @brief Sets a register or pointer.
+ * @param machine The machine.
+ * @param name The register or pointer.
+ * @param value The value, cut to 8 bits for all but IP.
+ */
+__RHEA_API__ void rhea_set_register(rhea_machine * machine, rhea_register name, uint16_t value);
+
+/**
+ * @brief Reads a byte through the bus, as the machine would: attached ranges are called.
+ * @param machine The machine.
+ * @param address The address.
+ * @return The byte.
+ */
+__RHEA_API__ uint8_t rhea_read(rhea_machine * machine, uint16_t address);
+
+/**
+ * @brief Writes a byte through the bus, as the machine would: attached ranges are called and read-only pages are
+ *        left alone.
+ * @param machine The machine.
+ * @param address The address.
+ * @param value The byte.
+ */
+__RHEA_API__ void rhea_write(rhea_machine * machine, uint16_t address, uint8_t value);
+
+/**
+ * @brief Copies bytes out of the memory, skipping the attached ranges. Stops at FFFF.
+ * @param machine The machine.
+ * @param address The first address.
+ * @param bytes Where to copy them.
+ * @param count The number of bytes.
+ * @return The number of bytes copied.
+ */
+__RHEA_API__ size_t rhea_peek(const rhea_machine * machine, uint16_t address, uint8_t * bytes, size_t count);
+
+/**
+ * @brief Copies bytes into the memory, skipping the attached ranges and the write protection. Stops at FFFF.
+ * @param machine The machine.
+ * @param address The first address.
+ * @param bytes The bytes.
+ * @param count The number of bytes.
+ * @return The number of bytes copied.
+ */
+__RHEA_API__ size_t rhea_poke(rhea_machine * machine, uint16_t address, const uint8_t * bytes, size_t count);
+
+/**
+ * @brief Attaches callbacks to a range of pages: reads and writes of the machine there call them instead of
+ *        touching the memory.
+ * @param machine The machine.
+ * @param first_page The first page.
+ * @param last_page The last page.
+ * @param read The read callback, null to read zeros.
+ * @param write The write callback, null to ignore the writes.
+ * @param context Passed to the callbacks.
+ * @return 0 on success, -1 if the range is empty.
+ */
+__RHEA_API__ int rhea_attach(rhea_machine * machine, uint8_t first_page, uint8_t last_page, rhea_read_callback read, rhea_write_callback write, void * context);
+
+/**
+ * @brief Detaches whatever is attached to a range of pages, leaving plain memory.
+ * @param machine The machine.
+ * @param first_page The first page.
+ * @param last_page The last page.
+ */
+__RHEA_API__ void rhea_detach(rhea_machine * machine, uint8_t first_page, uint8_t last_page);
+
+/**
+ * @brief Asserts or releases IRQ lines, the request holds while any line is asserted.
+ * @param machine The machine.
+ * @param lines The lines, a mask of 7F.
+ * @param is_asserted Non zero to assert them, zero to release them.
+ */
+__RHEA_API__ void rhea_set_irq(rhea_machine * machine, uint8_t lines, int is_asserted);
+
+/**
+ * @brief Triggers an NMI, taken before the next instruction.
+ * @param machine The machine.
+ */
+__RHEA_API__ void rhea_trigger_nmi(rhea_machine * machine);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
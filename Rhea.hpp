@@ -0,0 +1,9284 @@
+#ifndef __RHEA_HPP__
+#define __RHEA_HPP__
+
+//--------------------------------------------------//
+// Headers
+//--------------------------------------------------//
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if __has_include(<sys/mman.h>)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#if __has_include(<sys/un.h>)
+    #include <poll.h>
+    #include <sys/socket.h>
+    #include <sys/un.h>
+#endif
+
+//--------------------------------------------------//
+// Definitions
+//--------------------------------------------------//
+#define __RHEA_VERSION__ "0.1.0-alpha.9"
+#define __RHEA_DEBUG__ 0
+
+/**
+ * @brief Whether or not ROM images can be memory-mapped (POSIX hosts).
+ */
+#if __has_include(<sys/mman.h>)
+    #define __RHEA_MAPPED__ 1
+#else
+    #define __RHEA_MAPPED__ 0
+#endif
+
+/**
+ * @brief Whether or not the metrics can be published to Unix sockets (POSIX hosts).
+ */
+#if __has_include(<sys/un.h>)
+    #define __RHEA_SOCKETS__ 1
+#else
+    #define __RHEA_SOCKETS__ 0
+#endif
+
+/**
+ * @brief Dispatch strategy of Machine::run, threaded (labels as values) on GCC/Clang and switch elsewhere.
+ */
+#ifndef __RHEA_THREADED__
+    #if defined(__GNUC__)
+        #define __RHEA_THREADED__ 1
+    #else
+        #define __RHEA_THREADED__ 0
+    #endif
+#endif
+
+/**
+ * @brief Built-in profiler of Machine::run. Without it the profiled run loop and its counters aren't compiled at all.
+ */
+#ifndef __RHEA_PROFILER__
+    #define __RHEA_PROFILER__ 1
+#endif
+
+/**
+ * @brief Documented NMOS 6502 instructions: X(opcode, mnemonic, handler, addressing mode, base cycles).
+ */
+#define __RHEA_INSTRUCTIONS__(X) \
+    X(0x69, ADC, adc, Immediate, 2) \
+    X(0x65, ADC, adc, ZeroPage, 3) \
+    X(0x75, ADC, adc, ZeroPageX, 4) \
+    X(0x6D, ADC, adc, Absolute, 4) \
+    X(0x7D, ADC, adc, AbsoluteX, 4) \
+    X(0x79, ADC, adc, AbsoluteY, 4) \
+    X(0x61, ADC, adc, IndirectX, 6) \
+    X(0x71, ADC, adc, IndirectY, 5) \
+    X(0x29, AND, and, Immediate, 2) \
+    X(0x25, AND, and, ZeroPage, 3) \
+    X(0x35, AND, and, ZeroPageX, 4) \
+    X(0x2D, AND, and, Absolute, 4) \
+    X(0x3D, AND, and, AbsoluteX, 4) \
+    X(0x39, AND, and, AbsoluteY, 4) \
+    X(0x21, AND, and, IndirectX, 6) \
+    X(0x31, AND, and, IndirectY, 5) \
+    X(0x0A, ASL, asl, Accumulator, 2) \
+    X(0x06, ASL, asl, ZeroPage, 5) \
+    X(0x16, ASL, asl, ZeroPageX, 6) \
+    X(0x0E, ASL, asl, Absolute, 6) \
+    X(0x1E, ASL, asl, AbsoluteX, 7) \
+    X(0x90, BCC, bcc, Relative, 2) \
+    X(0xB0, BCS, bcs, Relative, 2) \
+    X(0xF0, BEQ, beq, Relative, 2) \
+    X(0x24, BIT, bit, ZeroPage, 3) \
+    X(0x2C, BIT, bit, Absolute, 4) \
+    X(0x30, BMI, bmi, Relative, 2) \
+    X(0xD0, BNE, bne, Relative, 2) \
+    X(0x10, BPL, bpl, Relative, 2) \
+    X(0x00, BRK, brk, Implied, 7) \
+    X(0x50, BVC, bvc, Relative, 2) \
+    X(0x70, BVS, bvs, Relative, 2) \
+    X(0x18, CLC, clc, Implied, 2) \
+    X(0xD8, CLD, cld, Implied, 2) \
+    X(0x58, CLI, cli, Implied, 2) \
+    X(0xB8, CLV, clv, Implied, 2) \
+    X(0xC9, CMP, cmp, Immediate, 2) \
+    X(0xC5, CMP, cmp, ZeroPage, 3) \
+    X(0xD5, CMP, cmp, ZeroPageX, 4) \
+    X(0xCD, CMP, cmp, Absolute, 4) \
+    X(0xDD, CMP, cmp, AbsoluteX, 4) \
+    X(0xD9, CMP, cmp, AbsoluteY, 4) \
+    X(0xC1, CMP, cmp, IndirectX, 6) \
+    X(0xD1, CMP, cmp, IndirectY, 5) \
+    X(0xE0, CPX, cpx, Immediate, 2) \
+    X(0xE4, CPX, cpx, ZeroPage, 3) \
+    X(0xEC, CPX, cpx, Absolute, 4) \
+    X(0xC0, CPY, cpy, Immediate, 2) \
+    X(0xC4, CPY, cpy, ZeroPage, 3) \
+    X(0xCC, CPY, cpy, Absolute, 4) \
+    X(0xC6, DEC, dec, ZeroPage, 5) \
+    X(0xD6, DEC, dec, ZeroPageX, 6) \
+    X(0xCE, DEC, dec, Absolute, 6) \
+    X(0xDE, DEC, dec, AbsoluteX, 7) \
+    X(0xCA, DEX, dex, Implied, 2) \
+    X(0x88, DEY, dey, Implied, 2) \
+    X(0x49, EOR, eor, Immediate, 2) \
+    X(0x45, EOR, eor, ZeroPage, 3) \
+    X(0x55, EOR, eor, ZeroPageX, 4) \
+    X(0x4D, EOR, eor, Absolute, 4) \
+    X(0x5D, EOR, eor, AbsoluteX, 4) \
+    X(0x59, EOR, eor, AbsoluteY, 4) \
+    X(0x41, EOR, eor, IndirectX, 6) \
+    X(0x51, EOR, eor, IndirectY, 5) \
+    X(0xE6, INC, inc, ZeroPage, 5) \
+    X(0xF6, INC, inc, ZeroPageX, 6) \
+    X(0xEE, INC, inc, Absolute, 6) \
+    X(0xFE, INC, inc, AbsoluteX, 7) \
+    X(0xE8, INX, inx, Implied, 2) \
+    X(0xC8, INY, iny, Implied, 2) \
+    X(0x4C, JMP, jmp, Absolute, 3) \
+    X(0x6C, JMP, jmp, Indirect, 5) \
+    X(0x20, JSR, jsr, Absolute, 6) \
+    X(0xA9, LDA, lda, Immediate, 2) \
+    X(0xA5, LDA, lda, ZeroPage, 3) \
+    X(0xB5, LDA, lda, ZeroPageX, 4) \
+    X(0xAD, LDA, lda, Absolute, 4) \
+    X(0xBD, LDA, lda, AbsoluteX, 4) \
+    X(0xB9, LDA, lda, AbsoluteY, 4) \
+    X(0xA1, LDA, lda, IndirectX, 6) \
+    X(0xB1, LDA, lda, IndirectY, 5) \
+    X(0xA2, LDX, ldx, Immediate, 2) \
+    X(0xA6, LDX, ldx, ZeroPage, 3) \
+    X(0xB6, LDX, ldx, ZeroPageY, 4) \
+    X(0xAE, LDX, ldx, Absolute, 4) \
+    X(0xBE, LDX, ldx, AbsoluteY, 4) \
+    X(0xA0, LDY, ldy, Immediate, 2) \
+    X(0xA4, LDY, ldy, ZeroPage, 3) \
+    X(0xB4, LDY, ldy, ZeroPageX, 4) \
+    X(0xAC, LDY, ldy, Absolute, 4) \
+    X(0xBC, LDY, ldy, AbsoluteX, 4) \
+    X(0x4A, LSR, lsr, Accumulator, 2) \
+    X(0x46, LSR, lsr, ZeroPage, 5) \
+    X(0x56, LSR, lsr, ZeroPageX, 6) \
+    X(0x4E, LSR, lsr, Absolute, 6) \
+    X(0x5E, LSR, lsr, AbsoluteX, 7) \
+    X(0xEA, NOP, nop, Implied, 2) \
+    X(0x09, ORA, ora, Immediate, 2) \
+    X(0x05, ORA, ora, ZeroPage, 3) \
+    X(0x15, ORA, ora, ZeroPageX, 4) \
+    X(0x0D, ORA, ora, Absolute, 4) \
+    X(0x1D, ORA, ora, AbsoluteX, 4) \
+    X(0x19, ORA, ora, AbsoluteY, 4) \
+    X(0x01, ORA, ora, IndirectX, 6) \
+    X(0x11, ORA, ora, IndirectY, 5) \
+    X(0x48, PHA, pha, Implied, 3) \
+    X(0x08, PHP, php, Implied, 3) \
+    X(0x68, PLA, pla, Implied, 4) \
+    X(0x28, PLP, plp, Implied, 4) \
+    X(0x2A, ROL, rol, Accumulator, 2) \
+    X(0x26, ROL, rol, ZeroPage, 5) \
+    X(0x36, ROL, rol, ZeroPageX, 6) \
+    X(0x2E, ROL, rol, Absolute, 6) \
+    X(0x3E, ROL, rol, AbsoluteX, 7) \
+    X(0x6A, ROR, ror, Accumulator, 2) \
+    X(0x66, ROR, ror, ZeroPage, 5) \
+    X(0x76, ROR, ror, ZeroPageX, 6) \
+    X(0x6E, ROR, ror, Absolute, 6) \
+    X(0x7E, ROR, ror, AbsoluteX, 7) \
+    X(0x40, RTI, rti, Implied, 6) \
+    X(0x60, RTS, rts, Implied, 6) \
+    X(0xE9, SBC, sbc, Immediate, 2) \
+    X(0xE5, SBC, sbc, ZeroPage, 3) \
+    X(0xF5, SBC, sbc, ZeroPageX, 4) \
+    X(0xED, SBC, sbc, Absolute, 4) \
+    X(0xFD, SBC, sbc, AbsoluteX, 4) \
+    X(0xF9, SBC, sbc, AbsoluteY, 4) \
+    X(0xE1, SBC, sbc, IndirectX, 6) \
+    X(0xF1, SBC, sbc, IndirectY, 5) \
+    X(0x38, SEC, sec, Implied, 2) \
+    X(0xF8, SED, sed, Implied, 2) \
+    X(0x78, SEI, sei, Implied, 2) \
+    X(0x85, STA, sta, ZeroPage, 3) \
+    X(0x95, STA, sta, ZeroPageX, 4) \
+    X(0x8D, STA, sta, Absolute, 4) \
+    X(0x9D, STA, sta, AbsoluteX, 5) \
+    X(0x99, STA, sta, AbsoluteY, 5) \
+    X(0x81, STA, sta, IndirectX, 6) \
+    X(0x91, STA, sta, IndirectY, 6) \
+    X(0x86, STX, stx, ZeroPage, 3) \
+    X(0x96, STX, stx, ZeroPageY, 4) \
+    X(0x8E, STX, stx, Absolute, 4) \
+    X(0x84, STY, sty, ZeroPage, 3) \
+    X(0x94, STY, sty, ZeroPageX, 4) \
+    X(0x8C, STY, sty, Absolute, 4) \
+    X(0xAA, TAX, tax, Implied, 2) \
+    X(0xA8, TAY, tay, Implied, 2) \
+    X(0xBA, TSX, tsx, Implied, 2) \
+    X(0x8A, TXA, txa, Implied, 2) \
+    X(0x9A, TXS, txs, Implied, 2) \
+    X(0x98, TYA, tya, Implied, 2)
+
+//--------------------------------------------------//
+// Code
+//--------------------------------------------------//
+namespace Rhea {
+    /**
+     * @brief The two hexadecimal digits of every byte, so encoding a value is just copying pairs of characters.
+     */
+    struct HexTable {
+        char pairs[0x100][2];
+
+        constexpr HexTable() : pairs() {
+            for(std::uint16_t value = 0x00; value < 0x100; value++) {
+                this->pairs[value][0] = "0123456789ABCDEF"[value >> 4];
+                this->pairs[value][1] = "0123456789ABCDEF"[value & 0xF];
+            }
+        }
+    };
+
+    inline constexpr HexTable hex_table = HexTable();
+
+    /**
+     * @brief Writes the hexadecimal representation of a value into a buffer. Like a stream with a fill width,
+     *        more digits than requested are written when the value needs them.
+     * @param buffer The buffer, with room for 4 characters.
+     * @param value The value.
+     * @param digits The minimum digits (up to 4).
+     * @return The end of the written characters.
+     */
+    inline char * encode_hex(char * buffer, const std::uint16_t value, std::uint8_t digits = 4) noexcept {
+        while(digits < 4 && (value >> (digits << 2)) != 0) {
+            digits++;
+        }
+
+        std::uint16_t rest = value;
+        std::uint8_t position = digits;
+
+        for(; position >= 2; position -= 2, rest >>= 8) {
+            std::memcpy(buffer + position - 2, hex_table.pairs[rest & 0xFF], 2);
+        }
+
+        if(position == 1) {
+            buffer[0] = hex_table.pairs[rest & 0xF][1];
+        }
+
+        return buffer + digits;
+    }
+
+    /**
+     * @brief Converts a value into its hexadecimal representation.
+     * @param value The value.
+     * @param digits The digits.
+     * @return The hexadecimal representation.
+     */
+    inline std::string format_hex(const std::uint16_t value, const std::uint8_t digits = 4) {
+        char buffer[4];
+
+        return std::string(buffer, encode_hex(buffer, value, digits)); // Short enough to never allocate.
+    }
+
+    /**
+     * @brief Checksums bytes FNV-1a style over words: 4 hashes take every 4th word of 8 bytes, so their multiplications
+     *        overlap, and are folded into one with the rest of the bytes at the end.
+     * @param bytes The bytes.
+     * @param count The number of bytes.
+     * @return The checksum.
+     */
+    inline std::uint64_t checksum(const std::uint8_t * bytes, const std::size_t count) noexcept {
+        std::uint64_t hash = 0xCBF29CE484222325, hash_1 = 0x84222325CBF29CE4, hash_2 = 0xCBF29CE400000000, hash_3 = 0x0000000084222325;
+        std::uint64_t words[4];
+        std::size_t index = 0;
+
+        auto mix = [](std::uint64_t value, const std::uint64_t word) {
+            value = (value ^ word) * 0x100000001B3;
+            return value ^ (value >> 29);
+        };
+
+        for(; index + 32 <= count; index += 32) {
+            std::memcpy(words, &bytes[index], 32);
+            hash = mix(hash, words[0]);
+            hash_1 = mix(hash_1, words[1]);
+            hash_2 = mix(hash_2, words[2]);
+            hash_3 = mix(hash_3, words[3]);
+        }
+
+        hash = mix(mix(mix(hash, hash_1), hash_2), hash_3);
+
+        for(; index < count; index++) {
+            hash = (hash ^ bytes[index]) * 0x100000001B3;
+        }
+
+        return hash;
+    }
+
+    class Device {
+        public:
+            virtual ~Device() noexcept = default;
+
+            /**
+             * @brief Reads a byte from one of the addresses the device is attached to.
+             * @param address The address.
+             * @return The byte.
+             */
+            virtual std::uint8_t read(const std::uint16_t address) = 0;
+
+            /**
+             * @brief Writes a byte into one of the addresses the device is attached to.
+             * @param address The address.
+             * @param value The byte.
+             */
+            virtual void write(const std::uint16_t address, const std::uint8_t value) = 0;
+
+            /**
+             * @brief Appends the internal state of the device, for the save states.
+             * @param state Where to append it.
+             */
+            virtual void save_state(std::string & state) const {
+                (void) state; // Stateless by default.
+            }
+
+            /**
+             * @brief Restores the internal state appended by Device::save_state.
+             * @param state The state.
+             * @return Whether or not the state is valid for this device.
+             */
+            virtual bool load_state(const std::string & state) {
+                return state.empty();
+            }
+    };
+
+    class Console : public Device {
+        public:
+            /**
+             * @brief Constructor.
+             * @param output The stream the written characters go to.
+             * @param input The characters returned by the reads.
+             */
+            Console(std::ostream & output, const std::string input = "") noexcept : output(output), input(input) {
+                this->position = 0;
+            }
+
+            /**
+             * @brief Reads the next input character (offset 0, 0x00 once exhausted) or whether there is one (offset 1).
+             * @param address The address.
+             * @return The byte.
+             */
+            std::uint8_t read(const std::uint16_t address) override {
+                bool is_available = this->position < this->input.size();
+
+                if(address & 0x01) {
+                    return is_available;
+                }
+
+                return is_available ? this->input[this->position++] : 0x00;
+            }
+
+            /**
+             * @brief Writes a character (offset 0), the other offsets are ignored.
+             * @param address The address.
+             * @param value The byte.
+             */
+            void write(const std::uint16_t address, const std::uint8_t value) override {
+                if(!(address & 0x01)) {
+                    this->output.put(value);
+                }
+            }
+
+            /**
+             * @brief Appends the position (8 bytes) and the input characters.
+             * @param state Where to append it.
+             */
+            void save_state(std::string & state) const override {
+                for(std::uint8_t byte = 0; byte < 8; byte++) {
+                    state.push_back(static_cast<char> ((static_cast<std::uint64_t> (this->position) >> (byte * 8)) & 0xFF));
+                }
+
+                state += this->input;
+            }
+
+            /**
+             * @brief Restores the position and the input characters.
+             * @param state The state.
+             * @return Whether or not the state is valid for this device.
+             */
+            bool load_state(const std::string & state) override {
+                std::uint64_t position = 0;
+
+                if(state.size() < 8) {
+                    return false;
+                }
+
+                for(std::uint8_t byte = 0; byte < 8; byte++) {
+                    position |= static_cast<std::uint64_t> (static_cast<std::uint8_t> (state[byte])) << (byte * 8);
+                }
+
+                if(position > state.size() - 8) {
+                    return false;
+                }
+
+                this->input = state.substr(8);
+                this->position = position;
+
+                return true;
+            }
+
+        private:
+            /**
+             * @brief The stream the written characters go to.
+             */
+            std::ostream & output;
+
+            /**
+             * @brief The characters returned by the reads.
+             */
+            std::string input;
+
+            /**
+             * @brief Position of the next input character.
+             */
+            std::size_t position;
+    };
+
+    class Random : public Device {
+        public:
+            /**
+             * @brief Constructor.
+             * @param seed The initial state, must not be 0.
+             */
+            Random(const std::uint32_t seed = 0x2545F491) noexcept {
+                this->state = seed;
+            }
+
+            /**
+             * @brief Reads the next pseudo-random byte (xorshift32).
+             * @param address The address.
+             * @return The byte.
+             */
+            std::uint8_t read(const std::uint16_t) override {
+                this->state ^= this->state << 13;
+                this->state ^= this->state >> 17;
+                this->state ^= this->state << 5;
+
+                return this->state & 0xFF;
+            }
+
+            /**
+             * @brief Reseeds the generator with the written byte.
+             * @param address The address.
+             * @param value The byte.
+             */
+            void write(const std::uint16_t, const std::uint8_t value) override {
+                this->state = 0x2545F491 ^ value;
+            }
+
+            /**
+             * @brief Appends the state of the generator (4 bytes).
+             * @param state Where to append it.
+             */
+            void save_state(std::string & state) const override {
+                for(std::uint8_t byte = 0; byte < 4; byte++) {
+                    state.push_back(static_cast<char> ((this->state >> (byte * 8)) & 0xFF));
+                }
+            }
+
+            /**
+             * @brief Restores the state of the generator.
+             * @param state The state.
+             * @return Whether or not the state is valid for this device.
+             */
+            bool load_state(const std::string & state) override {
+                std::uint32_t value = 0;
+
+                if(state.size() != 4) {
+                    return false;
+                }
+
+                for(std::uint8_t byte = 0; byte < 4; byte++) {
+                    value |= static_cast<std::uint32_t> (static_cast<std::uint8_t> (state[byte])) << (byte * 8);
+                }
+
+                if(value == 0) {
+                    return false;
+                }
+
+                this->state = value;
+
+                return true;
+            }
+
+        private:
+            /**
+             * @brief State of the generator.
+             */
+            std::uint32_t state;
+    };
+
+    class Metrics {
+        public:
+            /**
+             * @brief Cycles a metered run goes between two updates of the counters, so they move during long runs.
+             */
+            static constexpr std::uint64_t slice = 0x100000;
+
+            /**
+             * @brief Constructor.
+             */
+            Metrics() noexcept {
+                this->is_stopping = false;
+                this->clear();
+            }
+
+            /**
+             * @brief Destructor.
+             */
+            ~Metrics() noexcept {
+                this->stop();
+            }
+
+            Metrics(const Metrics &) = delete;
+            Metrics & operator=(const Metrics &) = delete;
+
+            /**
+             * @brief Counts a run, or a slice of it. Called once per slice, never per instruction.
+             * @param executed The number of instructions.
+             * @param cycles The number of cycles.
+             * @param nanoseconds The host time, 0 if it wasn't measured.
+             */
+            void count_run(const std::uint64_t executed, const std::uint64_t cycles, const std::uint64_t nanoseconds = 0) noexcept {
+                this->instructions.value.fetch_add(executed, std::memory_order_relaxed);
+                this->cycles.value.fetch_add(cycles, std::memory_order_relaxed);
+                this->nanoseconds.value.fetch_add(nanoseconds, std::memory_order_relaxed);
+            }
+
+            void count_interrupt(const bool is_nmi) noexcept {
+                (is_nmi ? this->nmis : this->irqs).value.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            void count_read(const std::uint8_t page) noexcept {
+                this->pages[page].reads.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            void count_write(const std::uint8_t page) noexcept {
+                this->pages[page].writes.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            std::uint64_t get_instructions() const noexcept {
+                return this->instructions.value.load(std::memory_order_relaxed);
+            }
+
+            std::uint64_t get_cycles() const noexcept {
+                return this->cycles.value.load(std::memory_order_relaxed);
+            }
+
+            /**
+             * @brief Gets the host time spent in metered runs, the debugged ones (breakpoints, watchpoints, tracing,
+             *        profiling) aside.
+             * @return The nanoseconds.
+             */
+            std::uint64_t get_nanoseconds() const noexcept {
+                return this->nanoseconds.value.load(std::memory_order_relaxed);
+            }
+
+            std::uint64_t get_irqs() const noexcept {
+                return this->irqs.value.load(std::memory_order_relaxed);
+            }
+
+            std::uint64_t get_nmis() const noexcept {
+                return this->nmis.value.load(std::memory_order_relaxed);
+            }
+
+            std::uint64_t get_reads(const std::uint8_t page) const noexcept {
+                return this->pages[page].reads.load(std::memory_order_relaxed);
+            }
+
+            std::uint64_t get_writes(const std::uint8_t page) const noexcept {
+                return this->pages[page].writes.load(std::memory_order_relaxed);
+            }
+
+            /**
+             * @brief Sets every counter back to 0.
+             */
+            void clear() noexcept {
+                for(Counter * counter : { &this->instructions, &this->cycles, &this->nanoseconds, &this->irqs, &this->nmis }) {
+                    counter->value.store(0, std::memory_order_relaxed);
+                }
+
+                for(std::uint16_t page = 0x00; page < 0x100; page++) {
+                    this->pages[page].reads.store(0, std::memory_order_relaxed);
+                    this->pages[page].writes.store(0, std::memory_order_relaxed);
+                }
+            }
+
+            /**
+             * @brief Appends the counters to a string in the Prometheus text format. The pages are only listed once
+             *        they were read or written.
+             * @param text The string.
+             * @param rate Instructions per second over the last interval.
+             */
+            void format(std::string & text, const double rate) const {
+                auto append = [&text](const std::string name, const std::string type, const std::string help) {
+                    text += "# HELP rhea_" + name + " " + help + "\n";
+                    text += "# TYPE rhea_" + name + " " + type + "\n";
+                };
+
+                append("instructions_total", "counter", "Instructions executed.");
+                text += "rhea_instructions_total " + std::to_string(this->get_instructions()) + "\n";
+                append("cycles_total", "counter", "Cycles emulated.");
+                text += "rhea_cycles_total " + std::to_string(this->get_cycles()) + "\n";
+                append("run_seconds_total", "counter", "Host time spent running.");
+                text += "rhea_run_seconds_total " + std::to_string(this->get_nanoseconds() / 1e9) + "\n";
+                append("interrupts_total", "counter", "Interrupts taken.");
+                text += "rhea_interrupts_total{kind=\"irq\"} " + std::to_string(this->get_irqs()) + "\n";
+                text += "rhea_interrupts_total{kind=\"nmi\"} " + std::to_string(this->get_nmis()) + "\n";
+                append("instructions_per_second", "gauge", "Instructions executed per second over the last interval.");
+                text += "rhea_instructions_per_second " + std::to_string(rate) + "\n";
+                append("page_reads_total", "counter", "Reads through the bus per page, while they're counted.");
+
+                for(std::uint16_t page = 0x00; page < 0x100; page++) {
+                    if(this->get_reads(page) > 0) {
+                        text += "rhea_page_reads_total{page=\"" + format_hex(page, 2) + "\"} " + std::to_string(this->get_reads(page)) + "\n";
+                    }
+                }
+
+                append("page_writes_total", "counter", "Writes through the bus per page, while they're counted.");
+
+                for(std::uint16_t page = 0x00; page < 0x100; page++) {
+                    if(this->get_writes(page) > 0) {
+                        text += "rhea_page_writes_total{page=\"" + format_hex(page, 2) + "\"} " + std::to_string(this->get_writes(page)) + "\n";
+                    }
+                }
+            }
+
+            /**
+             * @brief Starts publishing the counters from a background thread. Into a file, rewritten whole every
+             *        interval (through a temporary file, so readers never see it half written); or, for paths like
+             *        "unix:<path>", to every client connecting to a Unix socket there, like a scrape.
+             * @param path The path.
+             * @param interval Milliseconds between two updates.
+             * @return If the operation was successful.
+             */
+            bool publish(const std::string path, const std::uint32_t interval) {
+                int listener = -1;
+
+                this->stop();
+
+                if(path.compare(0, 5, "unix:") == 0) {
+                    #if __RHEA_SOCKETS__
+                        struct sockaddr_un address = {};
+                        std::string socket_path = path.substr(5);
+
+                        if(socket_path.empty() || socket_path.size() >= sizeof(address.sun_path)) {
+                            std::cerr << "\tSocket path \"" << socket_path << "\" is empty or too long." << std::endl;
+                            return false;
+                        }
+
+                        address.sun_family = AF_UNIX;
+                        std::memcpy(address.sun_path, socket_path.c_str(), socket_path.size() + 1);
+                        unlink(socket_path.c_str()); // Left by a previous run.
+                        listener = socket(AF_UNIX, SOCK_STREAM, 0);
+
+                        if(listener < 0 || bind(listener, reinterpret_cast<struct sockaddr *> (&address), sizeof(address)) != 0 || listen(listener, 8) != 0) {
+                            std::cerr << "\tSocket at \"" << socket_path << "\" can't be opened." << std::endl;
+
+                            if(listener >= 0) {
+                                close(listener);
+                            }
+
+                            return false;
+                        }
+                    #else
+                        std::cerr << "\tUnix sockets are not supported on this host." << std::endl;
+                        return false;
+                    #endif
+                } else if(!std::ofstream(path, std::ios::binary).is_open()) {
+                    std::cerr << "\tFile at \"" << path << "\" not found." << std::endl;
+                    return false;
+                }
+
+                this->is_stopping = false;
+                this->published = path;
+                this->publisher = std::thread([this, path, listener, interval]() {
+                    this->run_publisher(path, listener, interval);
+                });
+
+                return true;
+            }
+
+            /**
+             * @brief Stops publishing, removing the socket if there's one.
+             */
+            void stop() noexcept {
+                if(!this->publisher.joinable()) {
+                    return;
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock = std::lock_guard<std::mutex>(this->lock);
+                    this->is_stopping = true;
+                }
+
+                this->wake.notify_all();
+                this->publisher.join();
+                this->published.clear();
+            }
+
+            bool is_publishing() const noexcept {
+                return this->publisher.joinable();
+            }
+
+            /**
+             * @brief Gets where the counters are published.
+             * @return The path, empty if they aren't.
+             */
+            const std::string & get_published() const noexcept {
+                return this->published;
+            }
+
+        private:
+            /**
+             * @brief Counter alone in its cache line, so the machine updating one doesn't invalidate the line of
+             *        another the publisher reads.
+             */
+            struct alignas(64) Counter {
+                std::atomic<std::uint64_t> value;
+            };
+
+            /**
+             * @brief Reads and writes of one page, alone in their cache line. Packed, the counters of eight pages
+             *        would share a line, and machines counting on separate threads would take it from each other on
+             *        every access to neighboring pages. The padding makes them 16 KB instead of 4 KB.
+             */
+            struct alignas(64) Page {
+                std::atomic<std::uint64_t> reads;
+                std::atomic<std::uint64_t> writes;
+            };
+
+            Counter instructions;
+            Counter cycles;
+            Counter nanoseconds;
+            Counter irqs;
+            Counter nmis;
+            std::array<Page, 0x100> pages;
+
+            /**
+             * @brief Thread publishing the counters, where to, and how it's told to stop.
+             */
+            std::thread publisher;
+            std::string published;
+            std::mutex lock;
+            std::condition_variable wake;
+            bool is_stopping;
+
+            /**
+             * @brief Publishes the counters until told to stop.
+             * @param path The path of the file, or of the socket after "unix:".
+             * @param listener The listening socket, -1 to write the file instead.
+             * @param interval Milliseconds between two updates.
+             */
+            void run_publisher(const std::string path, const int listener, const std::uint32_t interval) {
+                auto last = std::chrono::steady_clock::now();
+                std::uint64_t last_instructions = this->get_instructions();
+                double rate = 0;
+                std::string text;
+
+                while(true) {
+                    #if __RHEA_SOCKETS__
+                        if(listener >= 0) { // Polled in short waits, to notice the stop soon.
+                            struct pollfd descriptor = { listener, POLLIN, 0 };
+                            bool is_connected = poll(&descriptor, 1, std::min<std::uint32_t>(interval, 100)) > 0 && (descriptor.revents & POLLIN);
+
+                            {
+                                std::lock_guard<std::mutex> lock = std::lock_guard<std::mutex>(this->lock);
+
+                                if(this->is_stopping) {
+                                    break;
+                                }
+                            }
+
+                            auto now = std::chrono::steady_clock::now();
+                            double seconds = std::chrono::duration<double>(now - last).count();
+
+                            if(seconds * 1e3 >= interval) {
+                                std::uint64_t executed = this->get_instructions();
+
+                                rate = (executed - last_instructions) / seconds;
+                                last_instructions = executed;
+                                last = now;
+                            }
+
+                            if(is_connected) {
+                                int client = accept(listener, nullptr, nullptr);
+
+                                if(client >= 0) {
+                                    text.clear();
+                                    this->format(text, rate);
+
+                                    for(std::size_t sent = 0; sent < text.size();) {
+                                        #ifdef MSG_NOSIGNAL
+                                            ssize_t count = send(client, &text[sent], text.size() - sent, MSG_NOSIGNAL); // A client gone doesn't kill the process.
+                                        #else
+                                            ssize_t count = send(client, &text[sent], text.size() - sent, 0);
+                                        #endif
+
+                                        if(count <= 0) {
+                                            break;
+                                        }
+
+                                        sent += count;
+                                    }
+
+                                    close(client);
+                                }
+                            }
+
+                            continue;
+                        }
+                    #endif
+
+                    auto now = std::chrono::steady_clock::now();
+                    std::uint64_t executed = this->get_instructions();
+                    std::ofstream file = std::ofstream(path + ".tmp", std::ios::binary);
+
+                    double seconds = std::chrono::duration<double>(now - last).count();
+
+                    if(seconds > 0) { // Written once right away, the rate follows from the next interval.
+                        rate = (executed - last_instructions) / seconds;
+                    }
+
+                    last_instructions = executed;
+                    last = now;
+                    text.clear();
+                    this->format(text, rate);
+                    file.write(text.data(), text.size());
+                    file.close();
+                    std::rename((path + ".tmp").c_str(), path.c_str());
+
+                    {
+                        std::unique_lock<std::mutex> lock = std::unique_lock<std::mutex>(this->lock);
+
+                        if(this->wake.wait_for(lock, std::chrono::milliseconds(interval), [this]() { return this->is_stopping; })) {
+                            break;
+                        }
+                    }
+                }
+
+                #if __RHEA_SOCKETS__
+                    if(listener >= 0) {
+                        close(listener);
+                        unlink(path.substr(5).c_str());
+                    }
+                #endif
+            }
+    };
+
+    class Memory {
+        public:
+            /**
+             * @brief Flags of the pages of the bus.
+             */
+            enum Page : std::uint8_t {
+                Attached = 0x01, // Reads and writes go to an attached device.
+                ReadOnly = 0x02, // Writes are ignored.
+                Code = 0x04,     // Holds translated code, writes are queued for the translation cache.
+                Clean = 0x08,    // Not written since the last load or save, the next write marks it dirty.
+                Pristine = 0x10, // Still holds zeros or the loaded ROM image, snapshots don't need to copy it.
+                Snapped = 0x20,  // Not written since the last snapshot, the next write marks it changed.
+                Traced = 0x40,   // Writes are logged for the trace recorder.
+                Watched = 0x80   // Reads and writes are checked against the watchpoints.
+            };
+
+            /**
+             * @brief Address range whose reads and/or writes stop the execution.
+             */
+            struct Watch {
+                std::uint16_t first;
+                std::uint16_t last;
+                bool is_read;
+                bool is_write;
+            };
+
+            /**
+             * @brief Access through the bus that hit a watchpoint.
+             */
+            struct Access {
+                std::uint16_t address;
+                std::uint8_t value;
+                bool is_write;
+            };
+
+            /**
+             * @brief ROM image file the pristine ROM pages come from.
+             */
+            struct Image {
+                /**
+                 * @brief Path to the file.
+                 */
+                std::string path;
+
+                /**
+                 * @brief Whether or not the file was saved over, so the pages pristine before can't be read back.
+                 */
+                bool is_stale;
+            };
+
+            /**
+             * @brief File identified by its device and inode, whatever the path it's reached through.
+             */
+            using FileId = std::pair<std::uint64_t, std::uint64_t>;
+
+            /**
+             * @brief Constructor.
+             */
+            Memory() {
+                this->data = allocate();
+                this->traced_writes = nullptr;
+                this->metrics = nullptr;
+                this->is_watch_hit = false;
+                this->page_flags.fill(Page::Clean | Page::Pristine);
+                this->update_pages();
+            }
+
+            /**
+             * @brief Copy constructor.
+             * @param other The memory to copy.
+             */
+            Memory(const Memory & other) {
+                this->data = allocate();
+                this->traced_writes = nullptr;
+                this->metrics = nullptr; // The copy isn't counted.
+                this->is_watch_hit = false;
+                *this = other;
+            }
+
+            /**
+             * @brief Copy assignment. The copy doesn't share the mapped ROM image, only its contents, but it does share
+             *        the attached devices (see Machine::detach).
+             * @param other The memory to copy.
+             * @return Self-reference.
+             */
+            Memory & operator=(const Memory & other) {
+                if(this != &other) {
+                    this->page_flags = other.page_flags;
+                    this->devices = other.devices;
+                    this->code_writes = other.code_writes;
+                    this->path = other.path;
+                    this->image = other.image;
+                    this->mapping = nullptr; // Every page is overwritten, none of the file stays mapped.
+                    this->watches = other.watches;
+                    std::memcpy(this->data, other.data, 0x10000);
+
+                    for(std::uint8_t & flags : this->page_flags) { // The copy isn't being traced.
+                        flags &= ~Page::Traced;
+                    }
+
+                    this->update_pages();
+                }
+
+                return *this;
+            }
+
+            /**
+             * @brief Destructor.
+             */
+            ~Memory() noexcept {
+                #if __RHEA_MAPPED__
+                    munmap(this->data, 0x10000);
+                #else
+                    delete[] this->data;
+                #endif
+            }
+
+            /**
+             * @brief Compares the whole contents with another memory.
+             * @param other The other memory.
+             * @return Whether or not both memories hold the same bytes.
+             */
+            bool operator==(const Memory & other) const noexcept {
+                return std::memcmp(this->data, other.data, 0x10000) == 0;
+            }
+
+            /**
+             * @brief Get a byte from a specific address.
+             * @param address The address of the byte.
+             * @return The byte
+             */
+            std::uint8_t get(const std::uint16_t address) const noexcept {
+                const std::uint8_t * page = this->read_pages[address >> 8];
+
+                if(page != nullptr) {
+                    return page[address & 0xFF];
+                }
+
+                return this->read_flagged(address);
+            }
+
+            /**
+             * @brief Get an instruction byte from a specific address. Instruction fetches skip the bus and read the
+             *        backing memory directly, so code can't be executed from the device pages.
+             * @param address The address of the byte.
+             * @return The byte
+             */
+            std::uint8_t fetch(const std::uint16_t address) const noexcept {
+                return this->data[address];
+            }
+
+            /**
+             * @brief Set a byte from a specific address to a specific value.
+             * @param address The address
+             * @param value The value.
+             * @return Self-reference.
+             */
+            Memory & set(const std::uint16_t address, const std::uint8_t value) noexcept {
+                std::uint8_t * page = this->write_pages[address >> 8];
+
+                if(page != nullptr) {
+                    page[address & 0xFF] = value;
+                    return *this;
+                }
+
+                this->write_flagged(address, value);
+
+                return *this;
+            }
+
+            /**
+             * @brief Set a byte from a specific address to a specific value, bypassing the devices and the write
+             *        protection. Meant for debuggers and loaders.
+             * @param address The address
+             * @param value The value.
+             * @return Self-reference.
+             */
+            Memory & patch(const std::uint16_t address, const std::uint8_t value) noexcept {
+                std::uint8_t flags = this->page_flags[address >> 8];
+
+                this->data[address] = value;
+
+                if(flags & Page::Code) { // Writes into translated code are queued for the translation cache.
+                    this->code_writes.push_back(address);
+                }
+
+                if(flags & (Page::Clean | Page::Pristine | Page::Snapped)) { // First write since the last load, save or snapshot.
+                    this->set_flags(address >> 8, address >> 8, Page::Clean | Page::Pristine | Page::Snapped, false);
+                }
+
+                return *this;
+            }
+
+            /**
+             * @brief Attaches a device to a range of pages, or detaches whatever device is there if it's null.
+             * @param first_page The first page.
+             * @param last_page The last page.
+             * @param device The device.
+             */
+            void attach(const std::uint8_t first_page, const std::uint8_t last_page, const std::shared_ptr<Device> device) noexcept {
+                for(std::uint16_t page = first_page; page <= last_page; page++) {
+                    this->devices[page] = device;
+                }
+
+                this->set_flags(first_page, last_page, Page::Attached, device != nullptr);
+            }
+
+            /**
+             * @brief Makes a range of pages reject or accept writes.
+             * @param first_page The first page.
+             * @param last_page The last page.
+             * @param is_protected Whether or not the pages reject writes.
+             */
+            void protect(const std::uint8_t first_page, const std::uint8_t last_page, const bool is_protected) noexcept {
+                this->set_flags(first_page, last_page, Page::ReadOnly, is_protected);
+            }
+
+            /**
+             * @brief Checks if a page was written since the last load or save.
+             * @param page The page.
+             * @return Whether or not the page is dirty.
+             */
+            bool is_dirty(const std::uint8_t page) const noexcept {
+                return !(this->page_flags[page] & Page::Clean);
+            }
+
+            /**
+             * @brief Checks if a page was written since the last snapshot.
+             * @param page The page.
+             * @return Whether or not the page changed.
+             */
+            bool is_changed(const std::uint8_t page) const noexcept {
+                return !(this->page_flags[page] & Page::Snapped);
+            }
+
+            /**
+             * @brief Checks if a page still holds what it was loaded with: zeros, or the ROM image for the ROM pages.
+             * @param page The page.
+             * @return Whether or not the page is pristine.
+             */
+            bool is_pristine(const std::uint8_t page) const noexcept {
+                return this->page_flags[page] & Page::Pristine;
+            }
+
+            /**
+             * @brief Marks every page as not changed since now, the next write into each one takes the slow path once.
+             */
+            void mark_snapped() noexcept {
+                this->set_flags(0x00, 0xFF, Page::Snapped, true);
+            }
+
+            /**
+             * @brief Rewrites pages with the contents of a snapshot and marks every page as not changed since then.
+             * @param pages Contents of every page in the snapshot, null for the pristine ones.
+             * @param rewrite Pages to rewrite, the others must already hold the snapshot contents.
+             * @param image ROM image the pristine ROM pages of the snapshot come from, null for zeros.
+             * @param errors Where the errors go.
+             * @return If the operation was successful.
+             */
+            bool restore(const std::array<const std::uint8_t *, 0x100> & pages, const std::bitset<0x100> & rewrite, const std::shared_ptr<Image> image, std::ostream & errors = std::cerr) {
+                std::ifstream file;
+
+                if(image != nullptr && image->is_stale) {
+                    errors << "\tFile at \"" << image->path << "\" was saved over since the snapshot was taken." << std::endl;
+                    return false;
+                }
+
+                if(image != this->image) { // Another ROM is loaded, map the right one so its pristine pages match again.
+                    if(image != nullptr && !this->load(image->path, true)) {
+                        return false;
+                    }
+
+                    if(image == nullptr) {
+                        this->set_flags(0x80, 0xFF, Page::Pristine, false);
+                    }
+
+                    this->image = image;
+                }
+
+                for(std::uint16_t page = 0x00; page < 0x100; page++) {
+                    std::uint8_t * direct = &this->data[page << 8];
+
+                    if(!rewrite[page] || (pages[page] == nullptr && this->is_pristine(page))) {
+                        continue;
+                    }
+
+                    if(pages[page] != nullptr) {
+                        std::memcpy(direct, pages[page], 0x100);
+                        this->page_flags[page] &= ~Page::Pristine;
+                    } else if(page < 0x80 || image == nullptr) {
+                        std::memset(direct, 0x00, 0x100);
+                        this->page_flags[page] |= Page::Pristine;
+                    } else {
+                        if(!file.is_open()) {
+                            file.open(image->path, std::ios::binary);
+                        }
+
+                        if(!file.seekg((page - 0x80) << 8) || !file.read(reinterpret_cast<char *> (direct), 0x100)) {
+                            errors << "\tFile at \"" << image->path << "\" can't be loaded." << std::endl;
+                            this->update_pages();
+                            return false;
+                        }
+
+                        this->page_flags[page] |= Page::Pristine;
+                    }
+
+                    if(this->page_flags[page] & Page::Code) {
+                        for(std::uint16_t offset = 0x00; offset < 0x100; offset++) {
+                            this->code_writes.push_back((page << 8) | offset);
+                        }
+                    }
+
+                    this->page_flags[page] &= ~Page::Clean;
+                }
+
+                this->mark_snapped();
+
+                return true;
+            }
+
+            /**
+             * @brief Starts or stops logging the writes through the bus, for the trace recorder.
+             * @param log Where to append the address and value of every write, null to stop.
+             */
+            void set_tracing(std::vector<std::pair<std::uint16_t, std::uint8_t>> * log) noexcept {
+                this->set_flags(0x00, 0xFF, Page::Traced, log != nullptr);
+                this->traced_writes = log;
+            }
+
+            /**
+             * @brief Adds a watchpoint. Only the pages of the range leave the fast path, and only until cleared.
+             * @param watch The watchpoint.
+             */
+            void watch(const Watch watch) {
+                this->watches.push_back(watch);
+                this->set_flags(watch.first >> 8, watch.last >> 8, Page::Watched, true);
+            }
+
+            /**
+             * @brief Removes all the watchpoints and any access hitting them.
+             */
+            void clear_watches() noexcept {
+                this->watches.clear();
+                this->set_flags(0x00, 0xFF, Page::Watched, false);
+                this->is_watch_hit = false;
+            }
+
+            const std::vector<Watch> & get_watches() const noexcept {
+                return this->watches;
+            }
+
+            /**
+             * @brief Counts the reads and writes through the bus per page. Every access then takes the slow path and
+             *        an atomic add, so they're only counted when asked and the fast path has no counting at all.
+             * @param metrics The metrics, null to stop counting.
+             */
+            void set_metrics(Metrics * metrics) noexcept {
+                this->metrics = metrics;
+                this->update_pages();
+            }
+
+            bool is_counting() const noexcept {
+                return this->metrics != nullptr;
+            }
+
+            bool is_watching() const noexcept {
+                return !this->watches.empty();
+            }
+
+            bool has_watch_hit() const noexcept {
+                return this->is_watch_hit;
+            }
+
+            /**
+             * @brief Takes the access that hit a watchpoint, so the next one can be recorded.
+             * @return The access.
+             */
+            Access take_watch_hit() noexcept {
+                this->is_watch_hit = false;
+
+                return this->watch_hit;
+            }
+
+            const std::uint8_t * get_page(const std::uint8_t page) const noexcept {
+                return &this->data[page << 8];
+            }
+
+            std::shared_ptr<Image> get_image() const noexcept {
+                return this->image;
+            }
+
+            std::shared_ptr<Device> get_device(const std::uint8_t page) const noexcept {
+                return this->devices[page];
+            }
+
+            std::uint8_t get_flags(const std::uint8_t page) const noexcept {
+                return this->page_flags[page];
+            }
+
+            /**
+             * @brief Flags the pages of a range as holding translated code, so writes into them are queued.
+             * @param start The first address of the range.
+             * @param end The address past the end of the range.
+             */
+            void mark_code(const std::uint16_t start, const std::uint32_t end) noexcept {
+                this->set_flags(start >> 8, (end - 1) >> 8, Page::Code, true);
+            }
+
+            /**
+             * @brief Clears all the code page flags and the queued writes.
+             */
+            void clear_code() noexcept {
+                this->set_flags(0x00, 0xFF, Page::Code, false);
+                this->code_writes.clear();
+            }
+
+            std::vector<std::uint16_t> & reference_code_writes() noexcept {
+                return this->code_writes;
+            }
+
+            /**
+             * @brief Loads the contents of a binary file into the ROM.
+             * @param path The path to the file.
+             * @param is_mapped Whether to map the file copy-on-write instead of copying it. Mapped images are shared
+             *                  by every memory mapping the same file, only the pages written to become private.
+             * @param errors Where the errors go, a stream of its own when loading on a worker thread.
+             * @return If the operation was successful.
+             */
+            bool load(const std::string path, const bool is_mapped = false, std::ostream & errors = std::cerr) {
+                if(is_mapped) {
+                    #if __RHEA_MAPPED__
+                        int descriptor = open(path.c_str(), O_RDONLY);
+                        struct stat status;
+
+                        if(descriptor < 0) {
+                            errors << "\tFile at \"" << path << "\" not found." << std::endl;
+                            return false;
+                        }
+
+                        if(fstat(descriptor, &status) != 0 || status.st_size < 0x8000 || 0x8000 % sysconf(_SC_PAGESIZE) != 0 ||
+                           mmap(&this->data[0x8000], 0x8000, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, descriptor, 0) == MAP_FAILED) {
+                            errors << "\tFile at \"" << path << "\" can't be mapped." << std::endl;
+                            close(descriptor);
+                            return false;
+                        }
+
+                        close(descriptor); // The mapping keeps the file alive.
+
+                        this->set_flags(0x80, 0xFF, Page::Clean | Page::Pristine, true);
+                        this->set_flags(0x80, 0xFF, Page::Snapped, false);
+                        this->path = path;
+                        this->image = std::make_shared<Image>(Image { path, false });
+                        this->mapping = track_mapping({ status.st_dev, status.st_ino }, true);
+
+                        return true;
+                    #else
+                        errors << "\tMapping files is not supported on this host, copying it instead." << std::endl;
+                    #endif
+                }
+
+                std::ifstream file = std::ifstream(path, std::ios::binary);
+
+                if(!file.is_open()) {
+                    errors << "\tFile at \"" << path << "\" not found." << std::endl;
+                    return false;
+                }
+
+                if(!file.read(reinterpret_cast<char *> (&this->data[0x8000]), 0x8000)) {
+                    errors << "\tFile at \"" << path << "\" can't be loaded." << std::endl;
+                    return false;
+                }
+
+                file.close();
+
+                this->set_flags(0x80, 0xFF, Page::Clean | Page::Pristine, true);
+                this->set_flags(0x80, 0xFF, Page::Snapped, false);
+                this->path = path;
+                this->image = std::make_shared<Image>(Image { path, false });
+                this->mapping = nullptr;
+
+                return true;
+            }
+
+            /**
+             * @brief Loads an image from the host into the ROM, the rest of the ROM is cleared. There is no file to
+             *        read the pages back from, so they're written pages instead of pristine ones.
+             * @param bytes The image.
+             * @param size The size of the image, up to 32 KB.
+             * @param errors Where the errors go.
+             * @return If the operation was successful.
+             */
+            bool load(const std::uint8_t * bytes, const std::size_t size, std::ostream & errors = std::cerr) {
+                if(size > 0x8000) {
+                    errors << "\tImage of " << size << " byte(s) doesn't fit the 32 KB of the ROM." << std::endl;
+                    return false;
+                }
+
+                std::memcpy(&this->data[0x8000], bytes, size);
+                std::memset(&this->data[0x8000 + size], 0x00, 0x8000 - size);
+                this->mark_patched(0x8000, 0xFFFF);
+                this->path.clear();
+                this->image = nullptr;
+                this->mapping = nullptr;
+
+                return true;
+            }
+
+            /**
+             * @brief Loads the contents of a binary file at an address, bypassing the devices and the write
+             *        protection like Memory::patch. Whatever doesn't fit below 0x10000 is ignored.
+             * @param path The path to the file.
+             * @param address The address.
+             * @param errors Where the errors go.
+             * @return The number of bytes loaded, 0 if the file couldn't be read.
+             */
+            std::uint32_t load_at(const std::string path, const std::uint16_t address, std::ostream & errors = std::cerr) {
+                std::ifstream file = std::ifstream(path, std::ios::binary);
+
+                if(!file.is_open()) {
+                    errors << "\tFile at \"" << path << "\" not found." << std::endl;
+                    return 0;
+                }
+
+                file.read(reinterpret_cast<char *> (&this->data[address]), 0x10000 - address);
+
+                if(file.gcount() > 0) {
+                    this->mark_patched(address, address + file.gcount() - 1);
+                }
+
+                return file.gcount();
+            }
+
+            /**
+             * @brief Copies bytes from the host, bypassing the devices and the write protection.
+             * @param address The first address.
+             * @param bytes The bytes.
+             * @param count The number of bytes, the range can't go past 0xFFFF.
+             */
+            void load_bytes(const std::uint16_t address, const std::uint8_t * bytes, const std::uint32_t count) {
+                if(count == 0) {
+                    return;
+                }
+
+                std::memcpy(&this->data[address], bytes, count);
+                this->mark_patched(address, address + count - 1);
+            }
+
+            /**
+             * @brief Loads every page straight into the memory, bypassing the devices and the write protection like
+             *        Memory::load_bytes, then sets the protection of every page, with the direct pointers updated once
+             *        at the end. The zero pages are cleared and stay pristine, the ones still pristine zeros are left
+             *        as they are.
+             * @param zeros The zero pages.
+             * @param read_only The pages that reject writes.
+             * @param writer Writes one of the other pages, given its number and its contents.
+             */
+            template<typename Writer> void load_pages(const std::array<bool, 0x100> & zeros, const std::array<bool, 0x100> & read_only, Writer writer) {
+                bool is_image = this->image != nullptr;
+
+                for(std::uint16_t page = 0x00; page < 0x100; page++) {
+                    std::uint8_t flags = this->page_flags[page] & ~Page::ReadOnly;
+                    bool is_zeros = zeros[page] && (page < 0x80 || !is_image); // What a pristine page holds.
+
+                    if(!is_zeros || !(flags & Page::Pristine)) {
+                        if(flags & Page::Code) {
+                            for(std::uint16_t offset = 0x00; offset < 0x100; offset++) {
+                                this->code_writes.push_back((page << 8) | offset);
+                            }
+                        }
+
+                        if(zeros[page]) {
+                            std::memset(&this->data[page << 8], 0x00, 0x100);
+                        } else {
+                            writer(page, &this->data[page << 8]);
+                        }
+
+                        flags = (flags & ~(Page::Clean | Page::Pristine | Page::Snapped)) | (is_zeros ? Page::Pristine : 0);
+                    }
+
+                    this->page_flags[page] = flags | (read_only[page] ? Page::ReadOnly : 0);
+                }
+
+                this->update_pages();
+            }
+
+            /**
+             * @brief Sets a range of bytes to a value, bypassing the devices and the write protection.
+             * @param first The first address.
+             * @param last The last address.
+             * @param value The value.
+             */
+            void fill(const std::uint16_t first, const std::uint16_t last, const std::uint8_t value) noexcept {
+                std::memset(&this->data[first], value, last - first + 1);
+                this->mark_patched(first, last);
+            }
+
+            /**
+             * @brief Copies a range of bytes, which may overlap, bypassing the devices and the write protection.
+             * @param source The first address to copy from.
+             * @param destination The first address to copy to.
+             * @param count The number of bytes, neither range can go past 0xFFFF.
+             */
+            void copy(const std::uint16_t source, const std::uint16_t destination, const std::uint32_t count) noexcept {
+                if(count == 0) {
+                    return;
+                }
+
+                std::memmove(&this->data[destination], &this->data[source], count);
+                this->mark_patched(destination, destination + count - 1);
+            }
+
+            /**
+             * @brief Finds the next occurrence of a byte pattern, using memchr to skip to each candidate first byte.
+             * @param first The first address to look at.
+             * @param last The last address the pattern can end at.
+             * @param pattern The pattern.
+             * @return The address of the occurrence, -1 if there is none.
+             */
+            std::int32_t find(const std::uint16_t first, const std::uint16_t last, const std::vector<std::uint8_t> & pattern) const noexcept {
+                const std::uint8_t * start = &this->data[first], * end = &this->data[last] + 1;
+
+                if(pattern.empty() || last < first || static_cast<std::size_t> (end - start) < pattern.size()) {
+                    return -1;
+                }
+
+                const std::uint8_t * limit = end - pattern.size() + 1; // Last place a match can start at, plus one.
+
+                while(start < limit) {
+                    start = static_cast<const std::uint8_t *> (std::memchr(start, pattern[0], limit - start));
+
+                    if(start == nullptr) {
+                        return -1;
+                    }
+
+                    if(std::memcmp(start, pattern.data(), pattern.size()) == 0) {
+                        return start - this->data;
+                    }
+
+                    start++;
+                }
+
+                return -1;
+            }
+
+            /**
+             * @brief Compares a range of bytes against a buffer, skipping the equal blocks with memcmp.
+             * @param address The first address.
+             * @param bytes The buffer, it can't go past 0xFFFF.
+             * @param count The number of bytes.
+             * @return The first and last address of each run of different bytes.
+             */
+            std::vector<std::pair<std::uint16_t, std::uint16_t>> diff(const std::uint16_t address, const std::uint8_t * bytes, const std::uint32_t count) const {
+                std::vector<std::pair<std::uint16_t, std::uint16_t>> runs;
+                const std::uint8_t * memory = &this->data[address];
+
+                for(std::uint32_t block = 0; block < count; block += 0x40) {
+                    std::uint32_t size = std::min<std::uint32_t>(0x40, count - block);
+
+                    if(std::memcmp(&memory[block], &bytes[block], size) == 0) {
+                        continue;
+                    }
+
+                    for(std::uint32_t offset = block; offset < block + size; offset++) {
+                        if(memory[offset] == bytes[offset]) {
+                            continue;
+                        }
+
+                        if(!runs.empty() && runs.back().second == address + offset - 1) { // Extends the previous run.
+                            runs.back().second = address + offset;
+                        } else {
+                            runs.emplace_back(address + offset, address + offset);
+                        }
+                    }
+                }
+
+                return runs;
+            }
+
+            /**
+             * @brief Saves the contents of the ROM into a binary file. If the file is the one the ROM was copied from
+             *        (or last saved to) and no memory of the process maps it, only the pages written since then are
+             *        written back. Otherwise the file is written whole under a temporary name and renamed over, so the
+             *        memories mapping the old file keep reading its old contents.
+             * @param path The path to the file.
+             * @param errors Where the errors go.
+             * @return If the operation was successful.
+             */
+            bool save(const std::string path, std::ostream & errors = std::cerr) {
+                bool is_mapped = false;
+
+                #if __RHEA_MAPPED__
+                    struct stat status;
+
+                    is_mapped = stat(path.c_str(), &status) == 0 && track_mapping({ status.st_dev, status.st_ino }, false) != nullptr;
+                #endif
+
+                if(this->image != nullptr && path == this->image->path) { // The snapshots relying on the old contents can't be restored anymore.
+                    this->image->is_stale = true;
+                    this->image = std::make_shared<Image>(Image { path, false });
+                }
+
+                if(path == this->path && !is_mapped) {
+                    std::fstream file = std::fstream(path, std::ios::binary | std::ios::in | std::ios::out);
+
+                    if(file.is_open()) {
+                        for(std::uint16_t page = 0x80; page < 0x100; page++) {
+                            if(!this->is_dirty(page)) {
+                                continue;
+                            }
+
+                            if(!file.seekp((page - 0x80) << 8) || !file.write(reinterpret_cast<char *> (&this->data[page << 8]), 0x100)) {
+                                errors << "\tFile at \"" << path << "\" can't be saved." << std::endl;
+                                return false;
+                            }
+
+                            this->set_flags(page, page, Page::Clean, true);
+                        }
+
+                        return true;
+                    }
+                }
+
+                std::ofstream file = std::ofstream(path + ".tmp", std::ios::binary);
+
+                if(!file.is_open()) {
+                    errors << "\tFile at \"" << path << "\" not found." << std::endl;
+                    return false;
+                }
+
+                bool is_written = static_cast<bool> (file.write(reinterpret_cast<char *> (&this->data[0x8000]), 0x8000));
+
+                file.close();
+
+                if(!is_written || file.fail() || std::rename((path + ".tmp").c_str(), path.c_str()) != 0) {
+                    errors << "\tFile at \"" << path << "\" can't be saved." << std::endl;
+                    std::remove((path + ".tmp").c_str());
+                    return false;
+                }
+
+                this->set_flags(0x80, 0xFF, Page::Clean, true);
+                this->path = path;
+
+                return true;
+            }
+
+        private:
+            /**
+             * @brief Internal representation of the memory.
+             */
+            std::uint8_t * data;
+
+            /**
+             * @brief Pages reads go straight to, null for the device pages.
+             */
+            std::array<std::uint8_t *, 0x100> read_pages;
+
+            /**
+             * @brief Pages writes go straight to, null for the pages needing any of the flag checks.
+             */
+            std::array<std::uint8_t *, 0x100> write_pages;
+
+            /**
+             * @brief Flags of each page.
+             */
+            std::array<std::uint8_t, 0x100> page_flags;
+
+            /**
+             * @brief Device attached to each page.
+             */
+            std::array<std::shared_ptr<Device>, 0x100> devices;
+
+            /**
+             * @brief Path of the file the ROM was last loaded from or saved to.
+             */
+            std::string path;
+
+            /**
+             * @brief ROM image the ROM was last loaded from, null if none was.
+             */
+            std::shared_ptr<Image> image;
+
+            /**
+             * @brief Keeps the file mapped over the ROM registered while the memory maps it, null if none is.
+             */
+            std::shared_ptr<const FileId> mapping;
+
+            /**
+             * @brief Registers a file mapped by a memory, or checks if any memory of the process maps it. A file
+             *        stays registered as long as one of the memories mapping it holds the returned token.
+             * @param file The file.
+             * @param is_mapping Whether the caller maps the file, or only checks it.
+             * @return The token, null if only checking and no memory maps the file.
+             */
+            static std::shared_ptr<const FileId> track_mapping(const FileId file, const bool is_mapping) {
+                static std::mutex mutex;
+                static std::map<FileId, std::weak_ptr<const FileId>> mappings;
+                std::lock_guard<std::mutex> lock = std::lock_guard<std::mutex>(mutex);
+                auto entry = mappings.find(file);
+                std::shared_ptr<const FileId> token = entry != mappings.end() ? entry->second.lock() : nullptr;
+
+                if(token == nullptr && is_mapping) {
+                    token = std::make_shared<const FileId>(file);
+                    mappings[file] = token;
+                }
+
+                return token;
+            }
+
+            /**
+             * @brief Allocates the zeroed 64 KB of a memory. Anonymous mappings only take host memory once touched.
+             * @return The memory.
+             */
+            static std::uint8_t * allocate() {
+                #if __RHEA_MAPPED__
+                    void * data = mmap(nullptr, 0x10000, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+                    if(data == MAP_FAILED) {
+                        throw std::bad_alloc();
+                    }
+
+                    return static_cast<std::uint8_t *> (data);
+                #else
+                    return new std::uint8_t[0x10000]();
+                #endif
+            }
+
+            /**
+             * @brief Slow path of Memory::get, reads from the device attached to the page or checks the watchpoints.
+             * @param address The address.
+             * @return The byte.
+             */
+            [[gnu::noinline, gnu::cold]] std::uint8_t read_flagged(const std::uint16_t address) const noexcept {
+                std::uint8_t flags = this->page_flags[address >> 8];
+                std::uint8_t value = (flags & Page::Attached) ? this->devices[address >> 8]->read(address) : this->data[address];
+
+                if(this->metrics != nullptr) {
+                    this->metrics->count_read(address >> 8);
+                }
+
+                if(flags & Page::Watched) {
+                    this->check_watches(address, value, false);
+                }
+
+                return value;
+            }
+
+            /**
+             * @brief Records the first access hitting a watchpoint since the last one was taken.
+             * @param address The address.
+             * @param value The value read or written.
+             * @param is_write Whether or not the access is a write.
+             */
+            void check_watches(const std::uint16_t address, const std::uint8_t value, const bool is_write) const noexcept {
+                for(const Watch & watch : this->watches) {
+                    if(!this->is_watch_hit && address >= watch.first && address <= watch.last && (is_write ? watch.is_write : watch.is_read)) {
+                        this->watch_hit = { address, value, is_write };
+                        this->is_watch_hit = true;
+                    }
+                }
+            }
+
+            /**
+             * @brief Slow path of Memory::set, for the pages with any flag.
+             * @param address The address.
+             * @param value The value.
+             */
+            [[gnu::noinline]] void write_flagged(const std::uint16_t address, const std::uint8_t value) noexcept {
+                std::uint8_t flags = this->page_flags[address >> 8];
+
+                if(this->metrics != nullptr) {
+                    this->metrics->count_write(address >> 8);
+                }
+
+                if(flags & Page::Watched) {
+                    this->check_watches(address, value, true);
+                }
+
+                if(flags & Page::Traced) {
+                    this->traced_writes->emplace_back(address, value);
+                }
+
+                if(flags & Page::Attached) {
+                    this->devices[address >> 8]->write(address, value);
+                    return;
+                }
+
+                if(flags & Page::ReadOnly) {
+                    return;
+                }
+
+                this->patch(address, value);
+            }
+
+            /**
+             * @brief Does the bookkeeping of Memory::patch for a whole range: queues the writes into translated
+             *        code and marks the pages as written.
+             * @param first The first address.
+             * @param last The last address.
+             */
+            void mark_patched(const std::uint16_t first, const std::uint16_t last) {
+                for(std::uint32_t address = first; address <= last; address++) {
+                    if(this->page_flags[address >> 8] & Page::Code) {
+                        this->code_writes.push_back(address);
+                    } else {
+                        address |= 0xFF; // Skip the rest of the page.
+                    }
+                }
+
+                this->set_flags(first >> 8, last >> 8, Page::Clean | Page::Pristine | Page::Snapped, false);
+            }
+
+            /**
+             * @brief Sets or clears a flag on a range of pages and updates their direct pointers.
+             * @param first_page The first page.
+             * @param last_page The last page.
+             * @param flag The flag.
+             * @param value Whether to set or clear the flag.
+             */
+            void set_flags(const std::uint8_t first_page, const std::uint8_t last_page, const std::uint8_t flag, const bool value) noexcept {
+                for(std::uint16_t page = first_page; page <= last_page; page++) {
+                    this->page_flags[page] = value ? (this->page_flags[page] | flag) : (this->page_flags[page] & ~flag);
+                }
+
+                this->update_pages();
+            }
+
+            /**
+             * @brief Rebuilds the direct pointers of every page from its flags.
+             */
+            void update_pages() noexcept {
+                bool is_counted = this->metrics != nullptr;
+
+                for(std::uint16_t page = 0x00; page < 0x100; page++) {
+                    std::uint8_t flags = this->page_flags[page], * direct = is_counted ? nullptr : &this->data[page << 8];
+
+                    this->read_pages[page] = flags & (Page::Attached | Page::Watched) ? nullptr : direct;
+                    this->write_pages[page] = flags ? nullptr : direct;
+                }
+            }
+
+            /**
+             * @brief Writes into the code pages not yet seen by the translation cache.
+             */
+            std::vector<std::uint16_t> code_writes;
+
+            /**
+             * @brief Log of the trace recorder the writes through the bus go to, null if it's not tracing.
+             */
+            std::vector<std::pair<std::uint16_t, std::uint8_t>> * traced_writes;
+
+            /**
+             * @brief Metrics the accesses through the bus are counted into per page, null if they aren't.
+             */
+            Metrics * metrics;
+
+            /**
+             * @brief Watchpoints, and the first access that hit one since it was last taken. Reads can hit them, so
+             *        the hit is mutable.
+             */
+            std::vector<Watch> watches;
+            mutable Access watch_hit;
+            mutable bool is_watch_hit;
+    };
+
+    class Tracer;
+    class Verifier;
+    class Journal;
+    class Profiler;
+    class Analysis;
+
+    class Machine {
+        public:
+            /**
+             * @brief Addressing modes of the instructions.
+             */
+            enum class Mode : std::uint8_t {
+                Implied,
+                Accumulator,
+                Immediate,
+                ZeroPage,
+                ZeroPageX,
+                ZeroPageY,
+                Absolute,
+                AbsoluteX,
+                AbsoluteY,
+                Indirect,
+                IndirectX,
+                IndirectY,
+                Relative
+            };
+
+            /**
+             * @brief Bits of the S (Status) Register.
+             */
+            enum Flag : std::uint8_t {
+                Carry = 0x01,
+                Zero = 0x02,
+                Interrupt = 0x04,
+                Decimal = 0x08,
+                Break = 0x10,
+                Unused = 0x20,
+                Overflow = 0x40,
+                Negative = 0x80
+            };
+
+            /**
+             * @brief Dispatch strategies of the execution loop.
+             */
+            enum class Dispatch : std::uint8_t {
+                Switch,
+                Threaded,
+                Cached
+            };
+
+            /**
+             * @brief IRQ lines, the request holds while any of them is asserted.
+             */
+            enum Line : std::uint8_t {
+                Devices = 0x7F,  // One line per device, released by the device itself.
+                Requested = 0x80 // Single requests, released when taken.
+            };
+
+            /**
+             * @brief Why Machine::run stopped before the cycle limit, besides an illegal opcode.
+             */
+            enum class Event : std::uint8_t {
+                None,
+                Breakpoint,
+                Watchpoint
+            };
+
+            /**
+             * @brief Register compared by a conditional breakpoint.
+             */
+            enum class Target : std::uint8_t {
+                ARegister,
+                XRegister,
+                YRegister,
+                SRegister,
+                SPointer
+            };
+
+            /**
+             * @brief Comparison of a conditional breakpoint, Always for the unconditional ones.
+             */
+            enum class Comparison : std::uint8_t {
+                Always,
+                Equal,
+                NotEqual,
+                Less,
+                Greater,
+                LessEqual,
+                GreaterEqual
+            };
+
+            /**
+             * @brief Address that stops the execution before running its instruction, if the condition holds.
+             */
+            struct Breakpoint {
+                std::uint16_t address;
+                Target target;
+                Comparison comparison;
+                std::uint8_t value;
+            };
+
+            /**
+             * @brief Dispatch strategy selected for this build.
+             */
+            static constexpr Dispatch dispatch = __RHEA_THREADED__ ? Dispatch::Threaded : Dispatch::Switch;
+
+            /**
+             * @brief Entry of the opcode dispatch table.
+             */
+            struct Instruction {
+                /**
+                 * @brief Mnemonic of the instruction, "???" for the illegal opcodes.
+                 */
+                const char * mnemonic;
+
+                /**
+                 * @brief Executes the whole instruction (IP, operand, cycles), null for the illegal opcodes.
+                 */
+                void (*execute)(Machine &);
+
+                /**
+                 * @brief Addressing mode of the operand.
+                 */
+                Mode mode;
+
+                /**
+                 * @brief Base cycles, without the page crossing and branch penalties.
+                 */
+                std::uint8_t cycles;
+
+                /**
+                 * @brief Whether or not the instruction can move IP somewhere else than the next instruction.
+                 */
+                bool is_branch;
+            };
+
+            /**
+             * @brief Entry of the opcode metadata table, what the assembler and the disassembler know of an opcode.
+             */
+            struct Opcode {
+                /**
+                 * @brief Mnemonic of the instruction, null for the illegal opcodes.
+                 */
+                const char * mnemonic;
+
+                /**
+                 * @brief Addressing mode of the operand.
+                 */
+                Mode mode;
+
+                /**
+                 * @brief Base cycles, without the page crossing and branch penalties.
+                 */
+                std::uint8_t cycles;
+            };
+
+            /**
+             * @brief Instruction decoded for a listing.
+             */
+            struct Decoded {
+                /**
+                 * @brief Length in bytes, 1 for the illegal opcodes.
+                 */
+                std::uint8_t length;
+
+                /**
+                 * @brief Number of characters of the text.
+                 */
+                std::uint8_t size;
+
+                /**
+                 * @brief Text of the instruction, like "LDA ($10),Y" or ".byte $02", not null terminated.
+                 */
+                char text[14];
+            };
+
+            /**
+             * @brief Straight-line run of pre-decoded instructions, ending at the first branch.
+             */
+            struct Block {
+                /**
+                 * @brief Maximum number of instructions of a block.
+                 */
+                static constexpr std::uint8_t capacity = 32;
+
+                /**
+                 * @brief First address of the block.
+                 */
+                std::uint16_t start;
+
+                /**
+                 * @brief Address past the last byte of the block.
+                 */
+                std::uint32_t end;
+
+                /**
+                 * @brief Cycles of the block if every instruction pays the maximum penalty.
+                 */
+                std::uint32_t worst_cycles;
+
+                /**
+                 * @brief Number of instructions, 0 if the block starts with an illegal opcode.
+                 */
+                std::uint8_t count;
+
+                /**
+                 * @brief Whether or not the block is still in sync with the memory.
+                 */
+                bool is_valid;
+
+                /**
+                 * @brief The instructions.
+                 */
+                void (*operations[capacity])(Machine &);
+            };
+
+            /**
+             * @brief Saved state of a machine. Only the pages changed since the parent snapshot are copied, the
+             *        others are shared with the ancestors.
+             */
+            struct Snapshot {
+                /**
+                 * @brief Snapshot taken before this one, null for the first one of a ROM image.
+                 */
+                mutable std::shared_ptr<const Snapshot> parent;
+
+                /**
+                 * @brief Number of ancestors.
+                 */
+                std::size_t depth;
+
+                /**
+                 * @brief Registers, pointers and cycles.
+                 */
+                std::uint8_t a_register;
+                std::uint8_t x_register;
+                std::uint8_t y_register;
+                std::uint8_t s_register;
+                std::uint16_t i_pointer;
+                std::uint8_t s_pointer;
+                std::uint64_t cycles;
+
+                /**
+                 * @brief ROM image the pristine pages come from.
+                 */
+                std::shared_ptr<Memory::Image> image;
+
+                /**
+                 * @brief Pages copied by this snapshot, in the same order as their contents.
+                 */
+                std::vector<std::uint8_t> changed;
+
+                /**
+                 * @brief Contents of the copied pages.
+                 */
+                std::vector<std::uint8_t> contents;
+
+                /**
+                 * @brief Contents of every page, owned by this snapshot or an ancestor, null for the pristine ones.
+                 */
+                std::array<const std::uint8_t *, 0x100> pages;
+
+                /**
+                 * @brief Destructor. Releases the ancestors nobody else holds one by one, as recursively destroying a
+                 *        long chain of snapshots would overflow the stack.
+                 */
+                ~Snapshot() noexcept {
+                    std::shared_ptr<const Snapshot> ancestor = std::move(this->parent);
+
+                    while(ancestor != nullptr && ancestor.use_count() == 1) {
+                        ancestor = std::move(ancestor->parent);
+                    }
+                }
+            };
+
+            /**
+             * @brief Opcode dispatch table, indexed by the opcode.
+             */
+            static const std::array<Instruction, 0x100> instructions;
+
+            /**
+             * @brief Opcode metadata table, indexed by the opcode and built at compile time.
+             */
+            static const std::array<Opcode, 0x100> opcodes;
+
+            /**
+             * @brief Gets the length in bytes of an instruction from its addressing mode.
+             * @param mode The addressing mode.
+             * @return The length.
+             */
+            static constexpr std::uint8_t length(const Mode mode) noexcept {
+                switch(mode) {
+                    case Mode::Implied:
+                    case Mode::Accumulator:
+                        return 1;
+
+                    case Mode::Absolute:
+                    case Mode::AbsoluteX:
+                    case Mode::AbsoluteY:
+                    case Mode::Indirect:
+                        return 3;
+
+                    default:
+                        return 2;
+                }
+            }
+
+            /**
+             * @brief Decodes the instruction at an address. The memory is read as stored, so the devices aren't read and
+             *        the watchpoints aren't hit.
+             * @param memory The memory.
+             * @param address The address.
+             * @return The decoded instruction.
+             */
+            static Decoded decode(const Memory & memory, const std::uint16_t address) noexcept {
+                auto peek = [&memory](const std::uint16_t at) { return memory.get_page(at >> 8)[at & 0xFF]; };
+                std::uint8_t opcode = peek(address), low = peek(address + 1), high = peek(address + 2);
+                const Opcode & entry = opcodes[opcode];
+                Decoded decoded;
+                char * cursor = decoded.text;
+                auto append = [&cursor](const char * characters) {
+                    std::size_t size = std::strlen(characters);
+
+                    std::memcpy(cursor, characters, size);
+                    cursor += size;
+                };
+
+                if(entry.mnemonic == nullptr) { // Illegal opcodes are listed as data.
+                    append(".byte $");
+                    cursor = encode_hex(cursor, opcode, 2);
+                    decoded.length = 1;
+                    decoded.size = cursor - decoded.text;
+
+                    return decoded;
+                }
+
+                append(entry.mnemonic);
+                decoded.length = length(entry.mode);
+
+                switch(entry.mode) {
+                    case Mode::Implied:
+                        break;
+
+                    case Mode::Accumulator:
+                        append(" A");
+                        break;
+
+                    case Mode::Immediate:
+                        append(" #$");
+                        cursor = encode_hex(cursor, low, 2);
+                        break;
+
+                    case Mode::ZeroPage:
+                    case Mode::ZeroPageX:
+                    case Mode::ZeroPageY:
+                        append(" $");
+                        cursor = encode_hex(cursor, low, 2);
+                        append(entry.mode == Mode::ZeroPage ? "" : entry.mode == Mode::ZeroPageX ? ",X" : ",Y");
+                        break;
+
+                    case Mode::Absolute:
+                    case Mode::AbsoluteX:
+                    case Mode::AbsoluteY:
+                        append(" $");
+                        cursor = encode_hex(cursor, low | (high << 8));
+                        append(entry.mode == Mode::Absolute ? "" : entry.mode == Mode::AbsoluteX ? ",X" : ",Y");
+                        break;
+
+                    case Mode::Indirect:
+                        append(" ($");
+                        cursor = encode_hex(cursor, low | (high << 8));
+                        append(")");
+                        break;
+
+                    case Mode::IndirectX:
+                        append(" ($");
+                        cursor = encode_hex(cursor, low, 2);
+                        append(",X)");
+                        break;
+
+                    case Mode::IndirectY:
+                        append(" ($");
+                        cursor = encode_hex(cursor, low, 2);
+                        append("),Y");
+                        break;
+
+                    case Mode::Relative: // The target is shown instead of the offset.
+                        append(" $");
+                        cursor = encode_hex(cursor, address + 2 + static_cast<std::int8_t>(low));
+                        break;
+                }
+
+                decoded.size = cursor - decoded.text;
+
+                return decoded;
+            }
+
+            /**
+             * @brief Appends the line of a decoded instruction to a listing, like "8000  A9 01     LDA #$01".
+             * @param text The listing.
+             * @param memory The memory the instruction was decoded from.
+             * @param address The address of the instruction.
+             * @param decoded The decoded instruction.
+             */
+            static void format_decoded(std::string & text, const Memory & memory, const std::uint16_t address, const Decoded & decoded) {
+                char line[32]; // "XXXX  ", 3 "XX " and ' ' before the text, and '\n'.
+                char * cursor = encode_hex(line, address);
+
+                std::memcpy(cursor, "  ", 2);
+                cursor += 2;
+
+                for(std::uint8_t index = 0; index < 3; index++, cursor += 3) {
+                    std::uint16_t at = address + index;
+
+                    if(index < decoded.length) {
+                        std::memcpy(cursor, hex_table.pairs[memory.get_page(at >> 8)[at & 0xFF]], 2);
+                    } else {
+                        std::memcpy(cursor, "  ", 2);
+                    }
+
+                    cursor[2] = ' ';
+                }
+
+                *cursor++ = ' ';
+                std::memcpy(cursor, decoded.text, decoded.size);
+                cursor += decoded.size;
+                *cursor++ = '\n';
+                text.append(line, cursor - line);
+            }
+
+            /**
+             * @brief Adds with carry as ADC does, in binary or, with the Decimal flag, in NMOS BCD (Z comes from the
+             *        binary sum, N and V from the adjusted high nibble).
+             * @param status The S register, its C, Z, V and N flags are updated.
+             * @param accumulator The AR.
+             * @param operand The operand.
+             * @return The new AR.
+             */
+            static std::uint8_t add(std::uint8_t & status, const std::uint8_t accumulator, const std::uint8_t operand) noexcept {
+                std::uint16_t carry = status & Flag::Carry;
+                std::uint16_t result = accumulator + operand + carry;
+
+                status &= ~(Flag::Carry | Flag::Zero | Flag::Overflow | Flag::Negative);
+                status |= ((result & 0xFF) == 0) ? Flag::Zero : 0;
+
+                if(status & Flag::Decimal) {
+                    std::uint16_t low = (accumulator & 0x0F) + (operand & 0x0F) + carry;
+
+                    if(low > 0x09) {
+                        low += 0x06;
+                    }
+
+                    std::uint16_t adjusted = (accumulator & 0xF0) + (operand & 0xF0) + (low > 0x0F ? 0x10 : 0x00) + (low & 0x0F);
+
+                    status |= (adjusted & Flag::Negative) | ((~(accumulator ^ operand) & (accumulator ^ adjusted) & 0x80) ? Flag::Overflow : 0);
+
+                    if((adjusted & 0x1F0) > 0x90) {
+                        adjusted += 0x60;
+                    }
+
+                    status |= ((adjusted & 0xFF0) > 0xF0) ? Flag::Carry : 0;
+
+                    return adjusted & 0xFF;
+                }
+
+                status |= (result & Flag::Negative) | (result > 0xFF ? Flag::Carry : 0) | ((~(accumulator ^ operand) & (accumulator ^ result) & 0x80) ? Flag::Overflow : 0);
+
+                return result & 0xFF;
+            }
+
+            /**
+             * @brief Subtracts with borrow as SBC does, in binary or, with the Decimal flag, in NMOS BCD (the flags
+             *        come from the binary difference).
+             * @param status The S register, its C, Z, V and N flags are updated.
+             * @param accumulator The AR.
+             * @param operand The operand.
+             * @return The new AR.
+             */
+            static std::uint8_t subtract(std::uint8_t & status, const std::uint8_t accumulator, const std::uint8_t operand) noexcept {
+                std::uint16_t borrow = (status & Flag::Carry) ? 0 : 1;
+                std::uint16_t result = accumulator - operand - borrow;
+
+                status &= ~(Flag::Carry | Flag::Zero | Flag::Overflow | Flag::Negative);
+                status |= (result < 0x100 ? Flag::Carry : 0) | (((accumulator ^ operand) & (accumulator ^ result) & 0x80) ? Flag::Overflow : 0);
+                status |= (result & Flag::Negative) | ((result & 0xFF) == 0 ? Flag::Zero : 0);
+
+                if(status & Flag::Decimal) {
+                    std::int16_t low = (accumulator & 0x0F) - (operand & 0x0F) - borrow;
+                    std::int16_t high = (accumulator >> 4) - (operand >> 4);
+
+                    if(low < 0) {
+                        low -= 0x06;
+                        high--;
+                    }
+
+                    if(high < 0) {
+                        high -= 0x06;
+                    }
+
+                    return ((high << 4) | (low & 0x0F)) & 0xFF;
+                }
+
+                return result & 0xFF;
+            }
+
+            /**
+             * @brief Constructor. The machine starts as after a reset, see Machine::reset.
+             */
+            Machine() noexcept {
+                this->a_register = 0x00;
+                this->x_register = 0x00;
+                this->y_register = 0x00;
+                this->s_register = 0x00;
+                this->i_pointer = 0x0000;
+                this->s_pointer = 0x00;
+                this->cycles = 0;
+                this->penalty = 0;
+                this->is_caching = false;
+                this->cache_hits = 0;
+                this->cache_misses = 0;
+                this->cache_invalidations = 0;
+                this->irq_lines = 0;
+                this->is_nmi_pending = false;
+                this->next_event = std::numeric_limits<std::uint64_t>::max();
+                this->stop_cycle = std::numeric_limits<std::uint64_t>::max();
+                this->timed_order = 0;
+                this->journal = nullptr;
+                this->analysis = nullptr;
+                this->metrics = nullptr;
+                this->metered = nullptr;
+                this->reset();
+            }
+
+            /**
+             * @brief Loads the contents of a binary file into the ROM.
+             * @param path The path to the file.
+             * @param is_mapped Whether to map the file copy-on-write instead of copying it.
+             * @param errors Where the errors go.
+             * @return If the operation was successful.
+             */
+            bool load(const std::string path, const bool is_mapped = false, std::ostream & errors = std::cerr) {
+                bool is_loaded = this->memory.load(path, is_mapped, errors);
+
+                this->set_caching(this->is_caching); // The file bypasses Memory::set, so every block may be stale.
+
+                if(is_loaded) {
+                    this->reset();
+                }
+
+                return is_loaded;
+            }
+
+            /**
+             * @brief Loads an image from the host into the ROM.
+             * @param bytes The image.
+             * @param size The size of the image, up to 32 KB.
+             * @param errors Where the errors go.
+             * @return If the operation was successful.
+             */
+            bool load(const std::uint8_t * bytes, const std::size_t size, std::ostream & errors = std::cerr) {
+                bool is_loaded = this->memory.load(bytes, size, errors);
+
+                this->set_caching(this->is_caching);
+
+                if(is_loaded) {
+                    this->reset();
+                }
+
+                return is_loaded;
+            }
+
+            /**
+             * @brief Resets the machine: IP is read from the reset vector at FFFC, interrupts are disabled and the
+             *        pending ones dropped, SP is left at FD as after power-on and the sequence takes 7 cycles. Images
+             *        without a reset vector (0000) start at 8000, the start of the ROM. The timed events are kept.
+             */
+            void reset() noexcept {
+                std::uint16_t vector = this->memory.get(0xFFFC) | (this->memory.get(0xFFFD) << 8);
+
+                this->s_register |= Flag::Interrupt | Flag::Unused;
+                this->s_pointer = 0xFD;
+                this->i_pointer = vector != 0x0000 ? vector : 0x8000;
+                this->cycles += 7;
+                this->irq_lines = 0;
+                this->is_nmi_pending = false;
+                this->update_next_event();
+            }
+
+            /**
+             * @brief Asserts or releases an IRQ line. The request holds while any line is asserted, and is taken
+             *        between instructions whenever interrupts are enabled.
+             * @param line The line, a bit of Line::Devices.
+             * @param is_asserted Whether to assert or release it.
+             */
+            void set_irq(const std::uint8_t line, const bool is_asserted) noexcept {
+                if(this->journal != nullptr) {
+                    this->record_interrupt(line, is_asserted, false);
+                }
+
+                this->irq_lines = is_asserted ? (this->irq_lines | line) : (this->irq_lines & ~line);
+                this->update_next_event();
+            }
+
+            /**
+             * @brief Requests a single IRQ, dropped once it's taken (unlike the device lines).
+             */
+            void request_irq() noexcept {
+                this->set_irq(Line::Requested, true);
+            }
+
+            /**
+             * @brief Triggers an NMI, taken before the next instruction even with interrupts disabled.
+             */
+            void trigger_nmi() noexcept {
+                if(this->journal != nullptr) {
+                    this->record_interrupt(0x00, true, true);
+                }
+
+                this->is_nmi_pending = true;
+                this->update_next_event();
+            }
+
+            /**
+             * @brief Sets the input journal the interrupt requests are recorded into.
+             * @param journal The journal, null to stop recording.
+             */
+            void set_journal(Journal * journal) noexcept {
+                this->journal = journal;
+            }
+
+            /**
+             * @brief Detaches a copy from what it shares with the machine it was copied from: the devices, the IRQ lines
+             *        they hold and the journal. The copy then runs without reading from or advancing them.
+             */
+            void detach() noexcept {
+                this->journal = nullptr;
+                this->memory.attach(0x00, 0xFF, nullptr);
+                this->set_irq(Line::Devices, false);
+            }
+
+            /**
+             * @brief Sets the metrics the runs, their instructions and cycles, and the interrupts taken are counted
+             *        into. Only this machine counts, not its copies.
+             * @param metrics The metrics, null to stop counting.
+             */
+            void set_metrics(Metrics * metrics) noexcept {
+                this->metrics = metrics;
+                this->metered = this;
+            }
+
+            Metrics * get_metrics() const noexcept {
+                return this->is_metered() ? this->metrics : nullptr;
+            }
+
+            /**
+             * @brief Sets the static analysis of the memory, shown in the dumps. It isn't updated by the writes.
+             * @param analysis The analysis, null to drop it.
+             */
+            void set_analysis(const std::shared_ptr<const Analysis> analysis) noexcept {
+                this->analysis = analysis;
+            }
+
+            const std::shared_ptr<const Analysis> & get_analysis() const noexcept {
+                return this->analysis;
+            }
+
+            /**
+             * @brief Schedules an action at a cycle. Actions run between instructions, the ones due at the same cycle
+             *        in the order they were scheduled.
+             * @param cycle The cycle.
+             * @param action The action.
+             * @param period Cycles until the action repeats, 0 to run it once.
+             */
+            void schedule(const std::uint64_t cycle, const std::function<void(Machine &)> action, const std::uint64_t period = 0) {
+                this->timed.push(Timed { cycle, this->timed_order++, period, action });
+                this->update_next_event();
+            }
+
+            /**
+             * @brief Drops every scheduled action.
+             */
+            void clear_schedule() noexcept {
+                this->timed = std::priority_queue<Timed, std::vector<Timed>, Timed::Later>();
+                this->update_next_event();
+            }
+
+            std::size_t count_scheduled() const noexcept {
+                return this->timed.size();
+            }
+
+            /**
+             * @brief Gets the cycle the next scheduled action or pending interrupt is due at.
+             * @return The cycle, the maximum value if there is none.
+             */
+            std::uint64_t get_next_event() const noexcept {
+                return this->next_event;
+            }
+
+
+            /**
+             * @brief Saves the contents of the ROM into a binary file.
+             * @param path The path to the file.
+             * @param errors Where the errors go.
+             * @return If the operation was successful.
+             */
+            bool save(const std::string path, std::ostream & errors = std::cerr) {
+                return this->memory.save(path, errors);
+            }
+
+            /**
+             * @brief Saves the whole state into a binary file: registers, pointers, cycles, pending interrupts, the
+             *        write protection, the state of the attached devices and the full memory. The header holds a
+             *        magic with the version, the flags and a checksum of the rest. Zero pages take one byte, and
+             *        with compression the others are LZ compressed when it makes them smaller. The scheduled actions
+             *        aren't saved.
+             * @param path The path to the file.
+             * @param is_compressed Whether or not to compress the pages.
+             * @param errors Where the errors go.
+             * @return If the operation was successful.
+             */
+            bool save_state(const std::string path, const bool is_compressed = true, std::ostream & errors = std::cerr) const {
+                std::ofstream file = std::ofstream(path, std::ios::binary);
+                std::vector<std::uint8_t> bytes;
+
+                if(!file.is_open()) {
+                    errors << "\tFile at \"" << path << "\" not found." << std::endl;
+                    return false;
+                }
+
+                this->encode_state(bytes, is_compressed);
+                file.write(reinterpret_cast<const char *> (bytes.data()), bytes.size());
+
+                if(!file) {
+                    errors << "\tFile at \"" << path << "\" can't be written." << std::endl;
+                    return false;
+                }
+
+                return true;
+            }
+
+            /**
+             * @brief Encodes the whole state as Machine::save_state writes it into its file.
+             * @param bytes Where to write it, replacing what's there.
+             * @param is_compressed Whether or not to compress the pages.
+             */
+            void encode_state(std::vector<std::uint8_t> & bytes, const bool is_compressed = true) const {
+                std::vector<std::uint8_t> body;
+                std::uint8_t header[sizeof(state_magic) + 9];
+                std::uint8_t compressed[0x180];
+
+                body.reserve(0x1000);
+                body.insert(body.end(), { this->a_register, this->x_register, this->y_register, this->s_register, this->s_pointer });
+                append_le(body, this->i_pointer, 2);
+                append_le(body, this->cycles, 8);
+                body.push_back(this->irq_lines);
+                body.push_back(this->is_nmi_pending);
+
+                for(std::uint16_t page = 0x00; page < 0x100; page += 8) { // Bitmap of the write protected pages.
+                    std::uint8_t bits = 0;
+
+                    for(std::uint8_t bit = 0; bit < 8; bit++) {
+                        bits |= ((this->memory.get_flags(page + bit) & Memory::Page::ReadOnly) ? 1 : 0) << bit;
+                    }
+
+                    body.push_back(bits);
+                }
+
+                for(std::uint16_t page = 0x00; page < 0x100; page++) { // Each device once, at the first page it's attached to.
+                    std::shared_ptr<Device> device = this->memory.get_device(page);
+                    std::string state;
+
+                    if(device == nullptr || (page > 0x00 && this->memory.get_device(page - 1) == device)) {
+                        continue;
+                    }
+
+                    device->save_state(state);
+                    body.push_back(0x01);
+                    body.push_back(page);
+                    append_le(body, state.size(), 4);
+                    body.insert(body.end(), state.begin(), state.end());
+                }
+
+                body.push_back(0x00); // No more devices.
+
+                for(std::uint16_t page = 0x00; page < 0x100; page++) {
+                    const std::uint8_t * contents = this->memory.get_page(page);
+                    std::size_t size = is_compressed ? compress_page(contents, compressed) : 0x100;
+
+                    if(std::all_of(contents, contents + 0x100, [](std::uint8_t value) { return value == 0x00; })) {
+                        body.push_back(Encoding::ZeroPage);
+                    } else if(size < 0x100) {
+                        body.push_back(Encoding::CompressedPage);
+                        append_le(body, size, 2);
+                        body.insert(body.end(), compressed, compressed + size);
+                    } else {
+                        body.push_back(Encoding::RawPage);
+                        body.insert(body.end(), contents, contents + 0x100);
+                    }
+                }
+
+                std::uint64_t sum = checksum(body.data(), body.size());
+
+                std::memcpy(header, state_magic, sizeof(state_magic));
+                header[sizeof(state_magic)] = is_compressed;
+
+                for(std::uint8_t byte = 0; byte < 8; byte++) {
+                    header[sizeof(state_magic) + 1 + byte] = (sum >> (byte * 8)) & 0xFF;
+                }
+
+                bytes.assign(header, header + sizeof(header));
+                bytes.insert(bytes.end(), body.begin(), body.end());
+            }
+
+            /**
+             * @brief Loads a state saved by Machine::save_state. The file is checked entirely before anything changes.
+             *        Device states go to the devices attached at the same pages, the ones without a device there are
+             *        skipped.
+             * @param path The path to the file.
+             * @param errors Where the errors go.
+             * @return If the operation was successful.
+             */
+            bool load_state(const std::string path, std::ostream & errors = std::cerr) {
+                std::vector<std::uint8_t> bytes;
+
+                #if __RHEA_MAPPED__ // Straight from the descriptor, without the stream's seeks and buffering.
+                    int descriptor = open(path.c_str(), O_RDONLY);
+                    struct stat status;
+                    bool is_read = descriptor >= 0 && fstat(descriptor, &status) == 0;
+
+                    if(descriptor < 0) {
+                        errors << "\tFile at \"" << path << "\" not found." << std::endl;
+                        return false;
+                    }
+
+                    bytes.resize(is_read ? status.st_size : 0);
+
+                    for(std::size_t offset = 0; is_read && offset < bytes.size();) {
+                        ssize_t count = read(descriptor, &bytes[offset], bytes.size() - offset);
+
+                        is_read = count > 0;
+                        offset += is_read ? count : 0;
+                    }
+
+                    close(descriptor);
+                #else
+                    std::ifstream file = std::ifstream(path, std::ios::binary | std::ios::ate);
+
+                    if(!file.is_open()) {
+                        errors << "\tFile at \"" << path << "\" not found." << std::endl;
+                        return false;
+                    }
+
+                    bytes.resize(file.tellg());
+                    file.seekg(0);
+
+                    bool is_read = static_cast<bool> (file.read(reinterpret_cast<char *> (bytes.data()), bytes.size()));
+                #endif
+
+                if(!is_read) {
+                    errors << "\tFile at \"" << path << "\" can't be read." << std::endl;
+                    return false;
+                }
+
+                return this->decode_state(bytes, "File at \"" + path + "\"", errors);
+            }
+
+            /**
+             * @brief Decodes a state encoded by Machine::encode_state, checked entirely before anything changes.
+             * @param bytes The encoded state.
+             * @param name What the errors call the state, like "File at "state.bin"".
+             * @param errors Where the errors go.
+             * @return If the operation was successful.
+             */
+            bool decode_state(const std::vector<std::uint8_t> & bytes, const std::string name, std::ostream & errors = std::cerr) {
+                std::vector<std::pair<std::uint8_t, std::string>> device_states;
+                std::array<bool, 0x100> zeros = {}, read_only;
+                std::array<std::pair<const std::uint8_t *, std::uint16_t>, 0x100> pages; // Raw ones are 0x100 bytes long.
+                std::size_t header = sizeof(state_magic) + 9, offset = header;
+
+                if(bytes.size() < header || std::memcmp(bytes.data(), state_magic, sizeof(state_magic) - 1) != 0) {
+                    errors << "\t" << name << " is not a save state." << std::endl;
+                    return false;
+                }
+
+                if(bytes[sizeof(state_magic) - 1] != state_magic[sizeof(state_magic) - 1]) {
+                    errors << "\t" << name << " is a save state of version " << +bytes[sizeof(state_magic) - 1] << ", only version " << +state_magic[sizeof(state_magic) - 1] << " is supported." << std::endl;
+                    return false;
+                }
+
+                if(read_le(&bytes[sizeof(state_magic) + 1], 8) != checksum(&bytes[header], bytes.size() - header)) {
+                    errors << "\t" << name << " is corrupted, the checksum doesn't match." << std::endl;
+                    return false;
+                }
+
+                auto take = [&](const std::size_t count) -> const std::uint8_t * { // Null once past the end.
+                    offset += count;
+                    return offset <= bytes.size() ? &bytes[offset - count] : nullptr;
+                };
+
+                const std::uint8_t * registers = take(5 + 2 + 8 + 2 + 32);
+
+                for(const std::uint8_t * marker = take(1); registers != nullptr && marker != nullptr && *marker == 0x01; marker = take(1)) {
+                    const std::uint8_t * page = take(1), * size = take(4);
+                    const std::uint8_t * state = size != nullptr ? take(read_le(size, 4)) : nullptr;
+
+                    if(state == nullptr) {
+                        registers = nullptr;
+                        break;
+                    }
+
+                    device_states.push_back({ *page, std::string(reinterpret_cast<const char *> (state), read_le(size, 4)) });
+                }
+
+                for(std::uint16_t page = 0x00; page < 0x100 && registers != nullptr; page++) { // Only checked, decoded once nothing can fail.
+                    const std::uint8_t * encoding = take(1), * size = nullptr, * data = nullptr;
+
+                    if(encoding != nullptr && *encoding == Encoding::RawPage && (data = take(0x100)) != nullptr) {
+                        pages[page] = { data, 0x100 };
+                    } else if(encoding != nullptr && *encoding == Encoding::CompressedPage && (size = take(2)) != nullptr && (data = take(read_le(size, 2))) != nullptr) {
+                        pages[page] = { data, read_le(size, 2) };
+                        registers = read_le(size, 2) < 0x100 && decompress_page(data, read_le(size, 2), nullptr) ? registers : nullptr;
+                    } else if(encoding != nullptr && *encoding == Encoding::ZeroPage) {
+                        zeros[page] = true;
+                    } else {
+                        registers = nullptr;
+                    }
+                }
+
+                if(registers == nullptr || offset != bytes.size()) {
+                    errors << "\t" << name << " is truncated or malformed." << std::endl;
+                    return false;
+                }
+
+                this->a_register = registers[0];
+                this->x_register = registers[1];
+                this->y_register = registers[2];
+                this->s_register = registers[3];
+                this->s_pointer = registers[4];
+                this->i_pointer = read_le(&registers[5], 2);
+                this->cycles = read_le(&registers[7], 8);
+                this->irq_lines = registers[15];
+                this->is_nmi_pending = registers[16];
+
+                for(std::uint16_t page = 0x00; page < 0x100; page++) {
+                    read_only[page] = (registers[17 + (page >> 3)] >> (page & 0x07)) & 1;
+                }
+
+                this->memory.load_pages(zeros, read_only, [&](const std::uint8_t page, std::uint8_t * contents) { // Straight into the memory.
+                    if(pages[page].second == 0x100) {
+                        std::memcpy(contents, pages[page].first, 0x100);
+                    } else {
+                        decompress_page(pages[page].first, pages[page].second, contents);
+                    }
+                });
+
+                for(const std::pair<std::uint8_t, std::string> & device_state : device_states) {
+                    std::shared_ptr<Device> device = this->memory.get_device(device_state.first);
+
+                    if(device == nullptr || !device->load_state(device_state.second)) {
+                        errors << "\tThe state of the device at the \"" << format_hex(device_state.first << 8) << "\" page was skipped, the device attached there doesn't match." << std::endl;
+                    }
+                }
+
+                this->update_next_event();
+
+                return true;
+            }
+
+            /**
+             * @brief Takes a snapshot of the state, copying only the pages written since the last snapshot (or
+             *        restore). The first snapshot after loading a ROM copies all the non pristine pages.
+             * @return The snapshot.
+             */
+            std::shared_ptr<const Snapshot> snapshot() {
+                std::shared_ptr<Snapshot> snapshot = std::make_shared<Snapshot>();
+                bool is_first = this->last_snapshot == nullptr || this->last_snapshot->image != this->memory.get_image();
+
+                snapshot->parent = is_first ? nullptr : this->last_snapshot;
+                snapshot->depth = is_first ? 0 : this->last_snapshot->depth + 1;
+                snapshot->a_register = this->a_register;
+                snapshot->x_register = this->x_register;
+                snapshot->y_register = this->y_register;
+                snapshot->s_register = this->s_register;
+                snapshot->i_pointer = this->i_pointer;
+                snapshot->s_pointer = this->s_pointer;
+                snapshot->cycles = this->cycles;
+                snapshot->image = this->memory.get_image();
+
+                if(is_first) {
+                    snapshot->pages.fill(nullptr);
+                } else {
+                    snapshot->pages = this->last_snapshot->pages;
+                }
+
+                for(std::uint16_t page = 0x00; page < 0x100; page++) {
+                    if(is_first ? !this->memory.is_pristine(page) : this->memory.is_changed(page)) {
+                        snapshot->changed.push_back(page);
+                    }
+                }
+
+                snapshot->contents.resize(snapshot->changed.size() << 8);
+
+                for(std::size_t index = 0; index < snapshot->changed.size(); index++) {
+                    std::memcpy(&snapshot->contents[index << 8], this->memory.get_page(snapshot->changed[index]), 0x100);
+                    snapshot->pages[snapshot->changed[index]] = &snapshot->contents[index << 8];
+                }
+
+                this->memory.mark_snapped();
+                this->last_snapshot = snapshot;
+
+                return snapshot;
+            }
+
+            /**
+             * @brief Restores the state of a snapshot. Only the pages written since the last snapshot and the ones
+             *        recorded between both snapshots are rewritten, unless they don't share an ancestor.
+             * @param snapshot The snapshot.
+             * @param errors Where the errors go.
+             * @return If the operation was successful.
+             */
+            bool restore(const std::shared_ptr<const Snapshot> snapshot, std::ostream & errors = std::cerr) {
+                std::bitset<0x100> rewrite;
+                const Snapshot * current = this->last_snapshot.get();
+                const Snapshot * target = snapshot.get();
+                bool is_reloaded = snapshot->image != this->memory.get_image();
+
+                for(std::uint16_t page = 0x00; page < 0x100; page++) {
+                    rewrite[page] = this->memory.is_changed(page);
+                }
+
+                while(current != target) { // Walk both up to their common ancestor.
+                    if(current == nullptr || target == nullptr) {
+                        rewrite.set();
+                        break;
+                    }
+
+                    const Snapshot * & deeper = current->depth >= target->depth ? current : target;
+
+                    for(std::uint8_t page : deeper->changed) {
+                        rewrite.set(page);
+                    }
+
+                    deeper = deeper->parent.get();
+                }
+
+                if(!this->memory.restore(snapshot->pages, rewrite, snapshot->image, errors)) {
+                    return false;
+                }
+
+                if(is_reloaded) {
+                    this->set_caching(this->is_caching); // The ROM was mapped again, bypassing Memory::set.
+                }
+
+                this->a_register = snapshot->a_register;
+                this->x_register = snapshot->x_register;
+                this->y_register = snapshot->y_register;
+                this->s_register = snapshot->s_register;
+                this->i_pointer = snapshot->i_pointer;
+                this->s_pointer = snapshot->s_pointer;
+                this->cycles = snapshot->cycles;
+                this->last_snapshot = snapshot;
+
+                return true;
+            }
+
+            /**
+             * @brief Creates a machine in the state of a snapshot. The ROM image is mapped and only the non pristine
+             *        pages are copied. Devices and write protection aren't part of the snapshot.
+             * @param snapshot The snapshot.
+             * @param errors Where the errors go.
+             * @return The machine, null if the snapshot can't be restored.
+             */
+            static std::unique_ptr<Machine> fork(const std::shared_ptr<const Snapshot> snapshot, std::ostream & errors = std::cerr) {
+                std::unique_ptr<Machine> machine = std::make_unique<Machine>();
+
+                if(!machine->restore(snapshot, errors)) {
+                    return nullptr;
+                }
+
+                return machine;
+            }
+
+            /**
+             * @brief Dumps the state of the machine into a text file. This is useful when some kind of error occurs.
+             * @param path The path to the file.
+             * @param is_full Whether to dump the whole memory instead of the 256 bytes from IP.
+             * @param errors Where the errors go.
+             * @return If the operation was successful.
+             */
+            bool dump(const std::string path, const bool is_full = false, std::ostream & errors = std::cerr) const {
+                std::ofstream file = std::ofstream(path, std::ios::binary);
+
+                if(!file.is_open()) {
+                    errors << "\tFile at \"" << path << "\" not found." << std::endl;
+                    return false;
+                }
+
+                std::string text;
+
+                this->format_dump(text, is_full);
+
+                file.write(text.data(), text.size()); // A single write, even for the whole memory.
+
+                return true;
+            }
+
+            /**
+             * @brief Appends the text of a dump to a string. The memory is read as stored, so the devices aren't read
+             *        and the watchpoints aren't hit.
+             * @param text The string.
+             * @param is_full Whether to dump the whole memory, one addressed line per 16 bytes, instead of the 256
+             *        bytes from IP.
+             */
+            void format_dump(std::string & text, const bool is_full) const {
+                text += "Registers\n";
+                text += "----------------------------------------------------------------------\n";
+                text += "AR: " + format_hex(this->a_register);
+                text += "  ";
+                text += "XR: " + format_hex(this->x_register);
+                text += "  ";
+                text += "YR: " + format_hex(this->y_register);
+                text += "  ";
+                text += "SR: " + format_hex(this->s_register);
+                text += "\n";
+                text += "\n";
+                text += "Pointers\n";
+                text += "----------------------------------------------------------------------\n";
+                text += "IP: " + format_hex(this->i_pointer) + " -> (" + format_hex(this->memory.get_page(this->i_pointer >> 8)[this->i_pointer & 0xFF], 2) + ")";
+                text += "  ";
+                text += "SP: " + format_hex(this->s_pointer) + " -> (" + format_hex(this->memory.get_page(0x01)[this->s_pointer], 2) + ")";
+                text += "\n";
+                text += "\n";
+                text += "Disassembly (Near IP):\n";
+                text += "----------------------------------------------------------------------\n";
+
+                for(std::uint16_t address = this->i_pointer, index = 0; index < 0x10; index++) {
+                    Decoded decoded = decode(this->memory, address);
+
+                    format_decoded(text, this->memory, address, decoded);
+                    address += decoded.length;
+                }
+
+                text += "\n";
+
+                if(this->analysis != nullptr) {
+                    this->format_analysis(text);
+                }
+                text += (is_full ? "Memory Contents (Full):\n" : "Memory Contents (Near IP):\n");
+                text += "----------------------------------------------------------------------\n";
+
+                std::uint32_t first = is_full ? 0x0000 : this->i_pointer;
+                std::uint32_t lines = is_full ? 0x1000 : 0x10;
+                std::size_t offset = text.size();
+
+                text.resize(offset + lines * 72); // "XXXX  " (full only), 16 "XX ", '\t', 16 characters and '\n'.
+
+                char * cursor = &text[offset];
+
+                for(std::uint32_t address = first; address <= 0xFFFF && address < first + (lines << 4); address += 0x10) {
+                    if(is_full) {
+                        cursor = encode_hex(cursor, address);
+                        *cursor++ = ' ';
+                        *cursor++ = ' ';
+                    }
+
+                    char * char_view = cursor + 0x31; // Right after the hexadecimal view and the tab.
+
+                    for(std::uint32_t scan_address = address; scan_address <= (address + 0xF); scan_address++, cursor += 3) {
+                        if(scan_address > 0xFFFF) { // If the currently scanned address is greater than 0xFFFF,
+                            std::memcpy(cursor, "   ", 3);                  // display
+                            char_view[scan_address - address] = ' ';        // spaces.
+                            continue;
+                        }
+
+                        std::uint8_t value = this->memory.get_page(scan_address >> 8)[scan_address & 0xFF];
+
+                        std::memcpy(cursor, hex_table.pairs[value], 2);
+                        cursor[2] = ' ';
+                        char_view[scan_address - address] = std::isprint(value) ? value : '.'; // Non displayable values are a '.'.
+                    }
+
+                    *cursor = '\t';
+                    cursor += 0x11;
+                    *cursor++ = '\n';
+                }
+
+                text.resize(cursor - text.data());
+            }
+
+            /**
+             * @brief Executes the instruction IP is pointing to, after the due events and interrupts.
+             * @return The cycles the instruction took (and the interrupt before it), 0 if IP points to an illegal opcode
+             *         (the machine is halted).
+             */
+            std::uint8_t step() noexcept {
+                std::uint8_t cycles = this->execute_next();
+
+                if(cycles > 0) {
+                    this->meter(1, cycles);
+                }
+
+                return cycles;
+            }
+
+            /**
+             * @brief Executes instructions until a number of cycles has elapsed or the machine halts, through the
+             *        translation cache if it's enabled or else through the dispatch strategy of this build.
+             * @param max_cycles The maximum number of cycles.
+             * @return The number of instructions executed.
+             */
+            std::uint64_t run(const std::uint64_t max_cycles) noexcept {
+                if(!this->breakpoints.empty() || this->memory.is_watching()) { // Only then pay for the checks.
+                    std::uint64_t start = this->cycles, executed = this->run_debugged(max_cycles);
+
+                    return this->meter(executed, this->cycles - start);
+                }
+
+                if(this->is_metered()) {
+                    return this->run_metered(max_cycles);
+                }
+
+                return this->is_caching ? this->run<Dispatch::Cached>(max_cycles) : this->run<dispatch>(max_cycles);
+            }
+
+            /**
+             * @brief Adds a breakpoint.
+             * @param breakpoint The breakpoint.
+             */
+            void add_breakpoint(const Breakpoint breakpoint) {
+                if(this->breakpoint_map.empty()) {
+                    this->breakpoint_map.assign(0x10000 / 64, 0);
+                }
+
+                this->breakpoints.push_back(breakpoint);
+                this->breakpoint_map[breakpoint.address >> 6] |= static_cast<std::uint64_t>(1) << (breakpoint.address & 0x3F);
+            }
+
+            /**
+             * @brief Removes all the breakpoints.
+             */
+            void clear_breakpoints() noexcept {
+                this->breakpoints.clear();
+                this->breakpoint_map.clear();
+            }
+
+            const std::vector<Breakpoint> & get_breakpoints() const noexcept {
+                return this->breakpoints;
+            }
+
+            /**
+             * @brief Gets why the last Machine::run stopped.
+             * @return The event, None if it reached the cycle limit or halted.
+             */
+            Event get_event() const noexcept {
+                return this->event;
+            }
+
+            /**
+             * @brief Gets the access that stopped the last Machine::run on a watchpoint.
+             * @return The access.
+             */
+            const Memory::Access & get_watch_hit() const noexcept {
+                return this->watch_hit;
+            }
+
+            /**
+             * @brief Executes instructions until a number of cycles has elapsed or the machine halts, recording each
+             *        one into a trace. Always goes through the switch dispatch, one instruction at a time.
+             * @param max_cycles The maximum number of cycles.
+             * @param tracer The trace recorder, already started on this machine.
+             * @return The number of instructions executed.
+             */
+            std::uint64_t run(const std::uint64_t max_cycles, Tracer & tracer) noexcept;
+
+            /**
+             * @brief Executes instructions until a number of cycles has elapsed, the machine halts or it diverges from
+             *        a reference trace, checking each one against it. Always goes through the switch dispatch, one
+             *        instruction at a time.
+             * @param max_cycles The maximum number of cycles.
+             * @param verifier The verifier, already started on this machine.
+             * @return The number of instructions executed.
+             */
+            std::uint64_t run(const std::uint64_t max_cycles, Verifier & verifier) noexcept;
+
+            /**
+             * @brief Executes instructions until a number of cycles has elapsed or the machine halts, counting each
+             *        one into a profile. Always goes through the switch dispatch, one instruction at a time. Without
+             *        the profiler built in this is just Machine::run.
+             * @param max_cycles The maximum number of cycles.
+             * @param profiler The profiler, already started.
+             * @return The number of instructions executed.
+             */
+            std::uint64_t run(const std::uint64_t max_cycles, Profiler & profiler) noexcept;
+
+            /**
+             * @brief Executes instructions until a number of cycles has elapsed or the machine halts. Runs in slices
+             *        that end at the next event, so the dispatch loops only compare the cycles with one integer.
+             * @tparam strategy The dispatch strategy, all of them leave the machine in the same state.
+             * @param max_cycles The maximum number of cycles.
+             * @return The number of instructions executed.
+             */
+            template<Dispatch strategy> std::uint64_t run(const std::uint64_t max_cycles) noexcept {
+                std::uint64_t limit = this->cycles + max_cycles, executed = 0;
+
+                while(this->cycles < limit) {
+                    if(this->cycles >= this->next_event) {
+                        this->dispatch_events();
+                    }
+
+                    this->stop_cycle = std::min(limit, this->next_event);
+                    executed += this->run_slice<strategy>();
+
+                    if(this->cycles < this->stop_cycle) { // Halted on an illegal opcode.
+                        break;
+                    }
+                }
+
+                return executed;
+            }
+
+            /**
+             * @brief Executes instructions until the stop cycle, which events arising meanwhile can bring closer.
+             * @tparam strategy The dispatch strategy.
+             * @return The number of instructions executed.
+             */
+            template<Dispatch strategy> std::uint64_t run_slice() noexcept {
+                std::uint64_t executed = 0;
+
+                if constexpr(strategy == Dispatch::Cached) {
+                    if(this->block_entries.empty()) {
+                        this->block_entries.assign(0x10000, -1);
+                        this->block_coverage.assign(0x10000 / 8, 0);
+                    }
+
+                    while(this->cycles < this->stop_cycle) {
+                        if(!this->memory.reference_code_writes().empty()) {
+                            this->invalidate_code_writes();
+                        }
+
+                        std::int32_t index = this->block_entries[this->i_pointer];
+
+                        if(index < 0) {
+                            index = this->translate(this->i_pointer);
+                            this->cache_misses++;
+                        } else {
+                            this->cache_hits++;
+                        }
+
+                        const Block & block = this->blocks[index];
+
+                        if(block.count == 0 || this->cycles + block.worst_cycles >= this->stop_cycle) { // Untranslatable or the limit may fall inside of the block.
+                            if(this->execute_next() == 0) { // Counted with the rest of the run.
+                                return executed;
+                            }
+
+                            executed++;
+                            continue;
+                        }
+
+                        for(std::uint8_t operation = 0; operation < block.count; operation++) {
+                            block.operations[operation](*this);
+                            executed++;
+
+                            if(!this->memory.reference_code_writes().empty()) { // Self-modifying code, the block may be gone.
+                                this->invalidate_code_writes();
+
+                                if(!block.is_valid) {
+                                    break;
+                                }
+                            }
+
+                            if(this->cycles >= this->stop_cycle) { // An interrupt became pending.
+                                break;
+                            }
+                        }
+                    }
+                } else if constexpr(strategy == Dispatch::Threaded) {
+                    #if __RHEA_THREADED__
+                        static void * labels[0x100];
+                        static std::atomic<bool> is_initialized = false;
+                        static std::mutex initialization;
+
+                        if(!is_initialized.load(std::memory_order_acquire)) { // Labels can't be taken outside of this function, so the table is filled on the first call.
+                            std::lock_guard<std::mutex> lock = std::lock_guard<std::mutex>(initialization);
+
+                            if(!is_initialized.load(std::memory_order_relaxed)) {
+                                std::fill(std::begin(labels), std::end(labels), &&label_illegal);
+
+                                #define X(opcode, mnemonic, handler, mode, timing) labels[opcode] = &&label_##opcode;
+                                __RHEA_INSTRUCTIONS__(X)
+                                #undef X
+
+                                is_initialized.store(true, std::memory_order_release);
+                            }
+                        }
+
+                        if(this->cycles >= this->stop_cycle) {
+                            return executed;
+                        }
+
+                        goto *labels[this->memory.fetch(this->i_pointer)];
+
+                        #define X(opcode, mnemonic, handler, mode, timing) \
+                            label_##opcode: \
+                                this->i_pointer++; \
+                                this->penalty = 0; \
+                                this->execute_##handler<Mode::mode>(); \
+                                this->cycles += timing + this->penalty; \
+                                executed++; \
+                                \
+                                if(this->cycles >= this->stop_cycle) { \
+                                    return executed; \
+                                } \
+                                \
+                                goto *labels[this->memory.fetch(this->i_pointer)];
+                        __RHEA_INSTRUCTIONS__(X)
+                        #undef X
+
+                        label_illegal:
+                            return executed;
+                    #else
+                        static_assert(strategy != Dispatch::Threaded, "Threaded dispatch requires labels as values.");
+                    #endif
+                } else {
+                    while(this->cycles < this->stop_cycle) {
+                        switch(this->memory.fetch(this->i_pointer)) {
+                            #define X(opcode, mnemonic, handler, mode, timing) \
+                                case opcode: \
+                                    this->i_pointer++; \
+                                    this->penalty = 0; \
+                                    this->execute_##handler<Mode::mode>(); \
+                                    this->cycles += timing + this->penalty; \
+                                    break;
+                            __RHEA_INSTRUCTIONS__(X)
+                            #undef X
+
+                            default:
+                                return executed;
+                        }
+
+                        executed++;
+                    }
+                }
+
+                return executed;
+            }
+
+            /**
+             * @brief Compares the architectural state (registers, pointers, cycles and memory) with another machine.
+             * @param other The other machine.
+             * @return Whether or not both machines are in the same state.
+             */
+            bool is_identical(const Machine & other) const noexcept {
+                return this->a_register == other.a_register && this->x_register == other.x_register && this->y_register == other.y_register && this->s_register == other.s_register &&
+                       this->i_pointer == other.i_pointer && this->s_pointer == other.s_pointer && this->cycles == other.cycles && this->memory == other.memory;
+            }
+
+            /**
+             * @brief Checks if the machine is halted on an illegal opcode.
+             * @return Whether or not is the machine halted.
+             */
+            bool is_halted() const noexcept {
+                return instructions[this->memory.fetch(this->i_pointer)].execute == nullptr;
+            }
+
+            Memory & reference_memory() noexcept {
+                return this->memory;
+            }
+
+            std::uint8_t & reference_a_register() noexcept {
+                return this->a_register;
+            }
+
+            std::uint8_t & reference_x_register() noexcept {
+                return this->x_register;
+            }
+
+            std::uint8_t & reference_y_register() noexcept {
+                return this->y_register;
+            }
+
+            std::uint8_t & reference_s_register() noexcept {
+                return this->s_register;
+            }
+
+            std::uint16_t & reference_i_pointer() noexcept {
+                return this->i_pointer;
+            }
+
+            std::uint8_t & reference_s_pointer() noexcept{
+                return this->s_pointer;
+            }
+
+            std::uint64_t & reference_cycles() noexcept {
+                return this->cycles;
+            }
+
+            /**
+             * @brief Enables or disables the translation cache, dropping all the translated blocks.
+             * @param enabled Whether or not to use the translation cache.
+             */
+            void set_caching(const bool enabled) noexcept {
+                this->is_caching = enabled;
+                this->blocks.clear();
+                this->free_blocks.clear();
+                this->block_entries.clear();
+                this->block_coverage.clear();
+                this->memory.clear_code();
+            }
+
+            bool is_caching_enabled() const noexcept {
+                return this->is_caching;
+            }
+
+            std::size_t count_blocks() const noexcept {
+                return this->blocks.size() - this->free_blocks.size();
+            }
+
+            std::uint64_t count_cache_hits() const noexcept {
+                return this->cache_hits;
+            }
+
+            std::uint64_t count_cache_misses() const noexcept {
+                return this->cache_misses;
+            }
+
+            std::uint64_t count_cache_invalidations() const noexcept {
+                return this->cache_invalidations;
+            }
+
+        private:
+            //--------------------------------------------------//
+            // Helpers
+            //--------------------------------------------------//
+
+            /**
+             * @brief Compresses a page. Each token is either a control byte under 0x80 followed by that many plus one
+             *        literal bytes, or a control byte with the high bit set for a match of its low bits plus three bytes,
+             *        followed by the distance back minus one. Matches are found through a hash of the next three bytes,
+             *        and a distance of one covers runs of the same byte.
+             * @param page The page.
+             * @param output Where to write the compressed bytes, with room for 0x180.
+             * @return The compressed size, 0x100 or more if it's not worth it.
+             */
+            static std::size_t compress_page(const std::uint8_t * page, std::uint8_t * output) noexcept {
+                std::int16_t last[0x400];
+                std::size_t size = 0, literals = 0, position = 0;
+
+                std::fill(std::begin(last), std::end(last), -1);
+
+                auto flush = [&](const std::size_t end) { // Writes the pending literals before a match or the end.
+                    while(literals > 0) {
+                        std::size_t count = std::min<std::size_t>(literals, 0x80);
+
+                        output[size++] = count - 1;
+                        std::memcpy(&output[size], &page[end - literals], count);
+                        size += count;
+                        literals -= count;
+                    }
+                };
+
+                while(position < 0x100 && size < 0x100) {
+                    std::size_t length = 0, distance = 0;
+
+                    if(position + 3 <= 0x100) {
+                        std::uint16_t hash = ((page[position] << 6) ^ (page[position + 1] << 3) ^ page[position + 2]) & 0x3FF;
+                        std::int16_t candidates[2] = { static_cast<std::int16_t> (position - 1), last[hash] }; // Runs first, they decompress fastest.
+
+                        last[hash] = position;
+
+                        for(std::int16_t candidate : candidates) {
+                            std::size_t match = 0;
+
+                            if(candidate < 0) {
+                                continue;
+                            }
+
+                            while(position + match < 0x100 && match < 0x82 && page[candidate + match] == page[position + match]) {
+                                match++;
+                            }
+
+                            if(match >= 3 && match > length) {
+                                length = match;
+                                distance = position - candidate;
+                            }
+                        }
+                    }
+
+                    if(length == 0) {
+                        literals++;
+                        position++;
+                        continue;
+                    }
+
+                    flush(position);
+                    output[size++] = 0x80 | (length - 3);
+                    output[size++] = distance - 1;
+                    position += length;
+                }
+
+                flush(position);
+
+                return position < 0x100 ? 0x100 : size;
+            }
+
+            /**
+             * @brief Decompresses a page compressed by Machine::compress_page.
+             * @param input The compressed bytes.
+             * @param size The compressed size.
+             * @param page Where to write the page, null to only check the bytes.
+             * @return Whether or not the bytes decompress into exactly one page.
+             */
+            static bool decompress_page(const std::uint8_t * input, const std::size_t size, std::uint8_t * page) noexcept {
+                std::size_t offset = 0, position = 0;
+
+                while(offset < size) {
+                    std::uint8_t control = input[offset++];
+
+                    if(!(control & 0x80)) {
+                        std::size_t count = control + 1;
+
+                        if(offset + count > size || position + count > 0x100) {
+                            return false;
+                        }
+
+                        if(page != nullptr) {
+                            std::memcpy(&page[position], &input[offset], count);
+                        }
+
+                        offset += count;
+                        position += count;
+                    } else {
+                        std::size_t count = (control & 0x7F) + 3;
+
+                        if(offset >= size || position + count > 0x100 || input[offset] >= position) {
+                            return false;
+                        }
+
+                        std::size_t distance = input[offset++] + 1;
+
+                        if(page == nullptr) {
+                            position += count;
+                            continue;
+                        }
+
+                        if(distance == 1) { // A run of the same byte.
+                            std::memset(&page[position], page[position - 1], count);
+                        } else {
+                            for(std::size_t done = 0; done < count; done += distance + done) { // The copied part repeats, so it doubles each time without overlapping.
+                                std::memcpy(&page[position + done], &page[position - distance], std::min(distance + done, count - done));
+                            }
+                        }
+
+                        position += count;
+                    }
+                }
+
+                return position == 0x100;
+            }
+
+            /**
+             * @brief Appends a value in little endian.
+             * @param bytes Where to append it.
+             * @param value The value.
+             * @param count The number of bytes.
+             */
+            static void append_le(std::vector<std::uint8_t> & bytes, const std::uint64_t value, const std::uint8_t count) {
+                for(std::uint8_t byte = 0; byte < count; byte++) {
+                    bytes.push_back((value >> (byte * 8)) & 0xFF);
+                }
+            }
+
+            /**
+             * @brief Reads a value in little endian.
+             * @param bytes The bytes.
+             * @param count The number of bytes.
+             * @return The value.
+             */
+            static std::uint64_t read_le(const std::uint8_t * bytes, const std::uint8_t count) noexcept {
+                std::uint64_t value = 0;
+
+                for(std::uint8_t byte = 0; byte < count; byte++) {
+                    value |= static_cast<std::uint64_t> (bytes[byte]) << (byte * 8);
+                }
+
+                return value;
+            }
+
+            /**
+             * @brief Runs the scheduled actions that are due, then takes the pending NMI or, if interrupts are
+             *        enabled, the IRQ.
+             */
+            void dispatch_events() {
+                while(!this->timed.empty() && this->timed.top().cycle <= this->cycles) {
+                    Timed timed = this->timed.top();
+
+                    this->timed.pop();
+
+                    if(timed.period > 0) {
+                        this->timed.push(Timed { timed.cycle + timed.period, this->timed_order++, timed.period, timed.action });
+                    }
+
+                    timed.action(*this);
+                }
+
+                if(this->is_nmi_pending) {
+                    this->is_nmi_pending = false;
+                    this->interrupt(0xFFFA);
+                } else if(this->irq_lines != 0 && !(this->s_register & Flag::Interrupt)) {
+                    this->irq_lines &= ~Line::Requested;
+                    this->interrupt(0xFFFE);
+                }
+
+                this->update_next_event();
+            }
+
+            /**
+             * @brief Recomputes the next event cycle: now if an interrupt can be taken, else the first scheduled action.
+             *        Brings the stop cycle of the running slice closer if needed.
+             */
+            void update_next_event() noexcept {
+                this->next_event = this->timed.empty() ? std::numeric_limits<std::uint64_t>::max() : this->timed.top().cycle;
+
+                if(this->is_nmi_pending || (this->irq_lines != 0 && !(this->s_register & Flag::Interrupt))) {
+                    this->next_event = this->cycles;
+                }
+
+                this->stop_cycle = std::min(this->stop_cycle, this->next_event);
+            }
+
+            /**
+             * @brief Checks for a held IRQ after an instruction that may have enabled interrupts.
+             */
+            void unmask_irq() noexcept {
+                if(this->irq_lines != 0 && !(this->s_register & Flag::Interrupt)) {
+                    this->update_next_event();
+                }
+            }
+
+            /**
+             * @brief Enters an interrupt handler like BRK does, but with the break flag clear on the stack.
+             * @param vector The address of the handler address.
+             */
+            void interrupt(const std::uint16_t vector) noexcept {
+                this->push(this->i_pointer >> 8);
+                this->push(this->i_pointer & 0xFF);
+                this->push((this->s_register & ~Flag::Break) | Flag::Unused);
+                this->set_flag(Flag::Interrupt, true);
+                this->i_pointer = this->memory.get(vector) | (this->memory.get(vector + 1) << 8);
+                this->cycles += 7;
+
+                if(this->is_metered()) {
+                    this->metrics->count_interrupt(vector == 0xFFFA);
+                }
+            }
+
+            /**
+             * @brief Executes instructions like Machine::run, stopping on the breakpoints and watchpoints. The first
+             *        instruction is never checked, so a stopped run can be resumed.
+             * @param max_cycles The maximum number of cycles.
+             * @return The number of instructions executed.
+             */
+            std::uint64_t run_debugged(const std::uint64_t max_cycles) noexcept {
+                std::uint64_t limit = this->cycles + max_cycles, executed = 0;
+
+                this->event = Event::None;
+                this->memory.take_watch_hit(); // Accesses from outside of the execution don't count.
+
+                while(this->cycles < limit) {
+                    if(this->cycles >= this->next_event) {
+                        this->dispatch_events();
+                    }
+
+                    if(executed != 0 && !this->breakpoint_map.empty() && ((this->breakpoint_map[this->i_pointer >> 6] >> (this->i_pointer & 0x3F)) & 1) && this->is_breaking()) {
+                        this->event = Event::Breakpoint;
+                        return executed;
+                    }
+
+                    switch(this->memory.fetch(this->i_pointer)) {
+                        #define X(opcode, mnemonic, handler, mode, timing) \
+                            case opcode: \
+                                this->i_pointer++; \
+                                this->penalty = 0; \
+                                this->execute_##handler<Mode::mode>(); \
+                                this->cycles += timing + this->penalty; \
+                                break;
+                        __RHEA_INSTRUCTIONS__(X)
+                        #undef X
+
+                        default:
+                            return executed;
+                    }
+
+                    executed++;
+
+                    if(this->memory.has_watch_hit()) {
+                        this->event = Event::Watchpoint;
+                        this->watch_hit = this->memory.take_watch_hit();
+                        return executed;
+                    }
+                }
+
+                return executed;
+            }
+
+            /**
+             * @brief Checks if any breakpoint at IP holds.
+             * @return Whether or not to stop.
+             */
+            bool is_breaking() const noexcept {
+                for(const Breakpoint & breakpoint : this->breakpoints) {
+                    if(breakpoint.address != this->i_pointer) {
+                        continue;
+                    }
+
+                    std::uint8_t registers[] = { this->a_register, this->x_register, this->y_register, this->s_register, this->s_pointer };
+                    std::uint8_t value = registers[static_cast<std::uint8_t> (breakpoint.target)];
+
+                    bool is_holding = true;
+
+                    switch(breakpoint.comparison) {
+                        case Comparison::Equal:
+                            is_holding = value == breakpoint.value;
+                            break;
+
+                        case Comparison::NotEqual:
+                            is_holding = value != breakpoint.value;
+                            break;
+
+                        case Comparison::Less:
+                            is_holding = value < breakpoint.value;
+                            break;
+
+                        case Comparison::Greater:
+                            is_holding = value > breakpoint.value;
+                            break;
+
+                        case Comparison::LessEqual:
+                            is_holding = value <= breakpoint.value;
+                            break;
+
+                        case Comparison::GreaterEqual:
+                            is_holding = value >= breakpoint.value;
+                            break;
+
+                        default:
+                            break;
+                    }
+
+                    if(is_holding) {
+                        return true;
+                    }
+                }
+
+                return false;
+            }
+
+            /**
+             * @brief Fetches the byte IP is pointing to and advances IP.
+             * @return The byte.
+             */
+            std::uint8_t fetch_byte() noexcept {
+                return this->memory.fetch(this->i_pointer++);
+            }
+
+            /**
+             * @brief Fetches the little endian word IP is pointing to and advances IP.
+             * @return The word.
+             */
+            std::uint16_t fetch_word() noexcept {
+                std::uint16_t low = this->memory.fetch(this->i_pointer++);
+
+                return low | (this->memory.fetch(this->i_pointer++) << 8);
+            }
+
+            /**
+             * @brief Reads a little endian word from the zero page, wrapping around inside it.
+             * @param address The address on the zero page.
+             * @return The word.
+             */
+            std::uint16_t zero_page_word(const std::uint8_t address) const noexcept {
+                return this->memory.get(address) | (this->memory.get(static_cast<std::uint8_t>(address + 1)) << 8);
+            }
+
+            /**
+             * @brief Resolves the effective address of the operand, fetching it from IP.
+             * @tparam mode The addressing mode.
+             * @tparam penalize Whether or not crossing a page costs an extra cycle (reads only).
+             * @return The effective address.
+             */
+            template<Mode mode, bool penalize = false> std::uint16_t address() noexcept {
+                if constexpr(mode == Mode::ZeroPage) {
+                    return this->fetch_byte();
+                } else if constexpr(mode == Mode::ZeroPageX) {
+                    return static_cast<std::uint8_t>(this->fetch_byte() + this->x_register);
+                } else if constexpr(mode == Mode::ZeroPageY) {
+                    return static_cast<std::uint8_t>(this->fetch_byte() + this->y_register);
+                } else if constexpr(mode == Mode::Absolute) {
+                    return this->fetch_word();
+                } else if constexpr(mode == Mode::Indirect) { // The NMOS 6502 doesn't carry into the high byte of the pointer.
+                    std::uint16_t base = this->fetch_word();
+
+                    return this->memory.get(base) | (this->memory.get((base & 0xFF00) | static_cast<std::uint8_t>(base + 1)) << 8);
+                } else if constexpr(mode == Mode::IndirectX) {
+                    return this->zero_page_word(this->fetch_byte() + this->x_register);
+                } else if constexpr(mode == Mode::AbsoluteX || mode == Mode::AbsoluteY || mode == Mode::IndirectY) {
+                    std::uint16_t base = (mode == Mode::IndirectY) ? this->zero_page_word(this->fetch_byte()) : this->fetch_word();
+                    std::uint16_t effective = base + ((mode == Mode::AbsoluteX) ? this->x_register : this->y_register);
+
+                    if(penalize && ((base ^ effective) & 0xFF00)) {
+                        this->penalty++;
+                    }
+
+                    return effective;
+                } else { // Immediate, the operand is the next byte.
+                    return this->i_pointer++;
+                }
+            }
+
+            /**
+             * @brief Reads the operand of a read instruction.
+             * @tparam mode The addressing mode.
+             * @return The operand.
+             */
+            template<Mode mode> std::uint8_t operand() noexcept {
+                return this->memory.get(this->address<mode, true>());
+            }
+
+            /**
+             * @brief Sets or clears a flag of the S register.
+             * @param flag The flag.
+             * @param value Whether to set or clear the flag.
+             */
+            void set_flag(const Flag flag, const bool value) noexcept {
+                this->s_register = value ? (this->s_register | flag) : (this->s_register & ~flag);
+            }
+
+            /**
+             * @brief Updates the Zero and Negative flags according to a value.
+             * @param value The value.
+             * @return The same value.
+             */
+            std::uint8_t update_zn(const std::uint8_t value) noexcept {
+                this->s_register = (this->s_register & ~(Flag::Zero | Flag::Negative)) | (value & Flag::Negative) | (value == 0 ? Flag::Zero : 0);
+                return value;
+            }
+
+            /**
+             * @brief Pushes a byte onto the stack.
+             * @param value The byte.
+             */
+            void push(const std::uint8_t value) noexcept {
+                this->memory.set(0x0100 + this->s_pointer--, value);
+            }
+
+            /**
+             * @brief Pulls a byte from the stack.
+             * @return The byte.
+             */
+            std::uint8_t pull() noexcept {
+                return this->memory.get(0x0100 + ++this->s_pointer);
+            }
+
+            /**
+             * @brief Applies a read-modify-write operation on the accumulator or on the memory.
+             * @tparam mode The addressing mode.
+             * @param operation The operation.
+             */
+            template<Mode mode, typename Operation> void modify(Operation operation) noexcept {
+                if constexpr(mode == Mode::Accumulator) {
+                    this->a_register = this->update_zn(operation(this->a_register));
+                } else {
+                    std::uint16_t effective = this->address<mode>();
+
+                    this->memory.set(effective, this->update_zn(operation(this->memory.get(effective))));
+                }
+            }
+
+            /**
+             * @brief Takes a relative branch if a condition holds, with the taken and page crossing penalties.
+             * @param condition The condition.
+             */
+            void branch(const bool condition) noexcept {
+                std::int8_t offset = static_cast<std::int8_t>(this->fetch_byte());
+
+                if(!condition) {
+                    return;
+                }
+
+                std::uint16_t target = this->i_pointer + offset;
+
+                this->penalty += ((this->i_pointer ^ target) & 0xFF00) ? 2 : 1;
+                this->i_pointer = target;
+            }
+
+            /**
+             * @brief Compares a register against the operand.
+             * @tparam mode The addressing mode.
+             * @param value The register.
+             */
+            template<Mode mode> void compare(const std::uint8_t value) noexcept {
+                std::uint8_t operand = this->operand<mode>();
+
+                this->set_flag(Flag::Carry, value >= operand);
+                this->update_zn(value - operand);
+            }
+
+            /**
+             * @brief Decodes the block starting at an address and adds it to the translation cache.
+             * @param start The address.
+             * @return The index of the block.
+             */
+            std::int32_t translate(const std::uint16_t start) noexcept {
+                std::int32_t index;
+
+                if(this->free_blocks.empty()) {
+                    index = this->blocks.size();
+                    this->blocks.emplace_back();
+                } else {
+                    index = this->free_blocks.back();
+                    this->free_blocks.pop_back();
+                }
+
+                Block & block = this->blocks[index];
+                std::uint32_t address = start;
+
+                block.start = start;
+                block.worst_cycles = 0;
+                block.count = 0;
+                block.is_valid = true;
+
+                while(block.count < Block::capacity) {
+                    const Instruction & instruction = instructions[this->memory.fetch(address)];
+                    std::uint32_t next = address + length(instruction.mode);
+
+                    if(instruction.execute == nullptr || next > 0x10000) { // Illegal opcodes and wrapping instructions are left to the interpreter.
+                        break;
+                    }
+
+                    block.operations[block.count++] = instruction.execute;
+                    block.worst_cycles += instruction.cycles + 2;
+                    address = next;
+
+                    if(instruction.is_branch) {
+                        break;
+                    }
+                }
+
+                block.end = (address == start) ? start + 1 : address;
+
+                for(std::uint32_t covered = start; covered < block.end; covered++) {
+                    this->block_coverage[covered >> 3] |= 1 << (covered & 7);
+                }
+
+                this->memory.mark_code(start, block.end);
+                this->block_entries[start] = index;
+
+                return index;
+            }
+
+            /**
+             * @brief Drops the blocks overlapping the queued writes into code pages.
+             */
+            void invalidate_code_writes() noexcept {
+                std::vector<std::uint16_t> & writes = this->memory.reference_code_writes();
+
+                for(std::uint16_t address : writes) {
+                    if(!(this->block_coverage[address >> 3] & (1 << (address & 7)))) { // Data sharing a page with code.
+                        continue;
+                    }
+
+                    std::int32_t first = std::max<std::int32_t>(0, address - (Block::capacity * 3 - 1));
+
+                    for(std::int32_t start = first; start <= address; start++) {
+                        std::int32_t index = this->block_entries[start];
+
+                        if(index >= 0 && address < this->blocks[index].end) {
+                            this->blocks[index].is_valid = false;
+                            this->block_entries[start] = -1;
+                            this->free_blocks.push_back(index);
+                            this->cache_invalidations++;
+                        }
+                    }
+                }
+
+                writes.clear();
+            }
+
+            //--------------------------------------------------//
+            // Instructions
+            //--------------------------------------------------//
+
+            template<Mode mode> void execute_adc() noexcept {
+                this->a_register = add(this->s_register, this->a_register, this->operand<mode>());
+            }
+
+            template<Mode mode> void execute_and() noexcept {
+                this->a_register = this->update_zn(this->a_register & this->operand<mode>());
+            }
+
+            template<Mode mode> void execute_asl() noexcept {
+                this->modify<mode>([this](std::uint8_t value) {
+                    this->set_flag(Flag::Carry, value & 0x80);
+                    return static_cast<std::uint8_t>(value << 1);
+                });
+            }
+
+            template<Mode> void execute_bcc() noexcept {
+                this->branch(!(this->s_register & Flag::Carry));
+            }
+
+            template<Mode> void execute_bcs() noexcept {
+                this->branch(this->s_register & Flag::Carry);
+            }
+
+            template<Mode> void execute_beq() noexcept {
+                this->branch(this->s_register & Flag::Zero);
+            }
+
+            template<Mode mode> void execute_bit() noexcept {
+                std::uint8_t operand = this->operand<mode>();
+
+                this->set_flag(Flag::Zero, (this->a_register & operand) == 0);
+                this->s_register = (this->s_register & ~(Flag::Negative | Flag::Overflow)) | (operand & (Flag::Negative | Flag::Overflow));
+            }
+
+            template<Mode> void execute_bmi() noexcept {
+                this->branch(this->s_register & Flag::Negative);
+            }
+
+            template<Mode> void execute_bne() noexcept {
+                this->branch(!(this->s_register & Flag::Zero));
+            }
+
+            template<Mode> void execute_bpl() noexcept {
+                this->branch(!(this->s_register & Flag::Negative));
+            }
+
+            template<Mode> void execute_brk() noexcept {
+                this->i_pointer++; // BRK skips a padding byte.
+                this->push(this->i_pointer >> 8);
+                this->push(this->i_pointer & 0xFF);
+                this->push(this->s_register | Flag::Break | Flag::Unused);
+                this->set_flag(Flag::Interrupt, true);
+                this->i_pointer = this->memory.get(0xFFFE) | (this->memory.get(0xFFFF) << 8);
+            }
+
+            template<Mode> void execute_bvc() noexcept {
+                this->branch(!(this->s_register & Flag::Overflow));
+            }
+
+            template<Mode> void execute_bvs() noexcept {
+                this->branch(this->s_register & Flag::Overflow);
+            }
+
+            template<Mode> void execute_clc() noexcept {
+                this->set_flag(Flag::Carry, false);
+            }
+
+            template<Mode> void execute_cld() noexcept {
+                this->set_flag(Flag::Decimal, false);
+            }
+
+            template<Mode> void execute_cli() noexcept {
+                this->set_flag(Flag::Interrupt, false);
+                this->unmask_irq();
+            }
+
+            template<Mode> void execute_clv() noexcept {
+                this->set_flag(Flag::Overflow, false);
+            }
+
+            template<Mode mode> void execute_cmp() noexcept {
+                this->compare<mode>(this->a_register);
+            }
+
+            template<Mode mode> void execute_cpx() noexcept {
+                this->compare<mode>(this->x_register);
+            }
+
+            template<Mode mode> void execute_cpy() noexcept {
+                this->compare<mode>(this->y_register);
+            }
+
+            template<Mode mode> void execute_dec() noexcept {
+                this->modify<mode>([](std::uint8_t value) {
+                    return static_cast<std::uint8_t>(value - 1);
+                });
+            }
+
+            template<Mode> void execute_dex() noexcept {
+                this->x_register = this->update_zn(this->x_register - 1);
+            }
+
+            template<Mode> void execute_dey() noexcept {
+                this->y_register = this->update_zn(this->y_register - 1);
+            }
+
+            template<Mode mode> void execute_eor() noexcept {
+                this->a_register = this->update_zn(this->a_register ^ this->operand<mode>());
+            }
+
+            template<Mode mode> void execute_inc() noexcept {
+                this->modify<mode>([](std::uint8_t value) {
+                    return static_cast<std::uint8_t>(value + 1);
+                });
+            }
+
+            template<Mode> void execute_inx() noexcept {
+                this->x_register = this->update_zn(this->x_register + 1);
+            }
+
+            template<Mode> void execute_iny() noexcept {
+                this->y_register = this->update_zn(this->y_register + 1);
+            }
+
+            template<Mode mode> void execute_jmp() noexcept {
+                this->i_pointer = this->address<mode>();
+            }
+
+            template<Mode> void execute_jsr() noexcept {
+                std::uint16_t target = this->fetch_word();
+
+                this->i_pointer--; // JSR pushes the address of its last byte.
+                this->push(this->i_pointer >> 8);
+                this->push(this->i_pointer & 0xFF);
+                this->i_pointer = target;
+            }
+
+            template<Mode mode> void execute_lda() noexcept {
+                this->a_register = this->update_zn(this->operand<mode>());
+            }
+
+            template<Mode mode> void execute_ldx() noexcept {
+                this->x_register = this->update_zn(this->operand<mode>());
+            }
+
+            template<Mode mode> void execute_ldy() noexcept {
+                this->y_register = this->update_zn(this->operand<mode>());
+            }
+
+            template<Mode mode> void execute_lsr() noexcept {
+                this->modify<mode>([this](std::uint8_t value) {
+                    this->set_flag(Flag::Carry, value & 0x01);
+                    return static_cast<std::uint8_t>(value >> 1);
+                });
+            }
+
+            template<Mode> void execute_nop() noexcept {
+            }
+
+            template<Mode mode> void execute_ora() noexcept {
+                this->a_register = this->update_zn(this->a_register | this->operand<mode>());
+            }
+
+            template<Mode> void execute_pha() noexcept {
+                this->push(this->a_register);
+            }
+
+            template<Mode> void execute_php() noexcept {
+                this->push(this->s_register | Flag::Break | Flag::Unused);
+            }
+
+            template<Mode> void execute_pla() noexcept {
+                this->a_register = this->update_zn(this->pull());
+            }
+
+            template<Mode> void execute_plp() noexcept {
+                this->s_register = (this->pull() & ~Flag::Break) | Flag::Unused;
+                this->unmask_irq();
+            }
+
+            template<Mode mode> void execute_rol() noexcept {
+                this->modify<mode>([this](std::uint8_t value) {
+                    std::uint8_t carry = this->s_register & Flag::Carry;
+
+                    this->set_flag(Flag::Carry, value & 0x80);
+                    return static_cast<std::uint8_t>((value << 1) | carry);
+                });
+            }
+
+            template<Mode mode> void execute_ror() noexcept {
+                this->modify<mode>([this](std::uint8_t value) {
+                    std::uint8_t carry = this->s_register & Flag::Carry;
+
+                    this->set_flag(Flag::Carry, value & 0x01);
+                    return static_cast<std::uint8_t>((value >> 1) | (carry << 7));
+                });
+            }
+
+            template<Mode> void execute_rti() noexcept {
+                this->s_register = (this->pull() & ~Flag::Break) | Flag::Unused;
+                this->i_pointer = this->pull();
+                this->i_pointer |= this->pull() << 8;
+                this->unmask_irq();
+            }
+
+            template<Mode> void execute_rts() noexcept {
+                this->i_pointer = this->pull();
+                this->i_pointer |= this->pull() << 8;
+                this->i_pointer++;
+            }
+
+            template<Mode mode> void execute_sbc() noexcept {
+                this->a_register = subtract(this->s_register, this->a_register, this->operand<mode>());
+            }
+
+            template<Mode> void execute_sec() noexcept {
+                this->set_flag(Flag::Carry, true);
+            }
+
+            template<Mode> void execute_sed() noexcept {
+                this->set_flag(Flag::Decimal, true);
+            }
+
+            template<Mode> void execute_sei() noexcept {
+                this->set_flag(Flag::Interrupt, true);
+            }
+
+            template<Mode mode> void execute_sta() noexcept {
+                this->memory.set(this->address<mode>(), this->a_register);
+            }
+
+            template<Mode mode> void execute_stx() noexcept {
+                this->memory.set(this->address<mode>(), this->x_register);
+            }
+
+            template<Mode mode> void execute_sty() noexcept {
+                this->memory.set(this->address<mode>(), this->y_register);
+            }
+
+            template<Mode> void execute_tax() noexcept {
+                this->x_register = this->update_zn(this->a_register);
+            }
+
+            template<Mode> void execute_tay() noexcept {
+                this->y_register = this->update_zn(this->a_register);
+            }
+
+            template<Mode> void execute_tsx() noexcept {
+                this->x_register = this->update_zn(this->s_pointer);
+            }
+
+            template<Mode> void execute_txa() noexcept {
+                this->a_register = this->update_zn(this->x_register);
+            }
+
+            template<Mode> void execute_txs() noexcept {
+                this->s_pointer = this->x_register;
+            }
+
+            template<Mode> void execute_tya() noexcept {
+                this->a_register = this->update_zn(this->y_register);
+            }
+
+            /**
+             * @brief Builds the opcode dispatch table.
+             * @return The table.
+             */
+            static std::array<Instruction, 0x100> build_instructions() noexcept;
+
+            //--------------------------------------------------//
+            // Registers
+            //--------------------------------------------------//
+
+            /**
+             * @brief A (Accumulator) Register: The accumulator, one of the most used registers.
+             */
+            std::uint8_t a_register;
+
+            /**
+             * @brief X Register: General purpose register.
+             */
+            std::uint8_t x_register;
+
+            /**
+             * @brief Y Register: General purpose register.
+             */
+            std::uint8_t y_register;
+
+            /**
+             * @brief S (Status) Register: The status, holds the current status of the machine.
+             */
+            std::uint8_t s_register;
+
+            //--------------------------------------------------//
+            // Pointers
+            //--------------------------------------------------//
+
+            /**
+             * @brief Instruction Pointer: Points to the location of the current instruction in the memory.
+             */
+            std::uint16_t i_pointer;
+
+            /**
+             * @brief Stack Pointer: Points to the location of the current stack value.
+             */
+            std::uint8_t s_pointer;
+
+            //--------------------------------------------------//
+            // Storage
+            //--------------------------------------------------//
+
+            /**
+             * @brief Memory : Holds all the data, this includes the ROM and the RAM.
+             */
+            Memory memory;
+
+            //--------------------------------------------------//
+            // Execution
+            //--------------------------------------------------//
+
+            /**
+             * @brief Cycles: Total number of cycles elapsed since the machine was created.
+             */
+            std::uint64_t cycles;
+
+            /**
+             * @brief Penalty: Extra cycles of the current instruction (page crossings and taken branches).
+             */
+            std::uint8_t penalty;
+
+            /**
+             * @brief Last snapshot taken or restored, the parent of the next one.
+             */
+            std::shared_ptr<const Snapshot> last_snapshot;
+
+            //--------------------------------------------------//
+            // Save States
+            //--------------------------------------------------//
+
+            /**
+             * @brief First bytes of a save state, the last one is the version of the format.
+             */
+            static constexpr std::uint8_t state_magic[8] = { 'R', 'H', 'E', 'A', 'S', 'A', 'V', 0x01 };
+
+            /**
+             * @brief How a page is stored in a save state.
+             */
+            enum Encoding : std::uint8_t {
+                ZeroPage = 0x00,      // All zeros, nothing follows.
+                RawPage = 0x01,       // The 256 bytes follow.
+                CompressedPage = 0x02 // The compressed size (2 bytes) and the compressed bytes follow.
+            };
+
+            //--------------------------------------------------//
+            // Interrupts
+            //--------------------------------------------------//
+
+            /**
+             * @brief Action scheduled at a cycle.
+             */
+            struct Timed {
+                std::uint64_t cycle;
+                std::uint64_t order;  // Keeps the actions due at the same cycle in the order they were scheduled.
+                std::uint64_t period; // Cycles until it repeats, 0 if it doesn't.
+                std::function<void(Machine &)> action;
+
+                /**
+                 * @brief Orders the queue so the earliest action is on top.
+                 */
+                struct Later {
+                    bool operator()(const Timed & left, const Timed & right) const noexcept {
+                        return left.cycle != right.cycle ? left.cycle > right.cycle : left.order > right.order;
+                    }
+                };
+            };
+
+            /**
+             * @brief Scheduled actions, the earliest on top.
+             */
+            std::priority_queue<Timed, std::vector<Timed>, Timed::Later> timed;
+            std::uint64_t timed_order;
+
+            /**
+             * @brief Asserted IRQ lines and whether an NMI is waiting to be taken.
+             */
+            std::uint8_t irq_lines;
+            bool is_nmi_pending;
+
+            /**
+             * @brief Cycle of the next scheduled action or pending interrupt, the only thing checked between
+             *        instructions. The maximum value if there is none.
+             */
+            std::uint64_t next_event;
+
+            /**
+             * @brief Cycle the running slice of Machine::run stops at, the limit or the next event if it's earlier.
+             */
+            std::uint64_t stop_cycle;
+
+            //--------------------------------------------------//
+            // Debugging
+            //--------------------------------------------------//
+
+            /**
+             * @brief Breakpoints, and a bitmap of their addresses (empty if there are none).
+             */
+            std::vector<Breakpoint> breakpoints;
+            std::vector<std::uint64_t> breakpoint_map;
+
+            /**
+             * @brief Why the last Machine::run stopped, and the access if it was a watchpoint.
+             */
+            Event event = Event::None;
+            Memory::Access watch_hit;
+
+            //--------------------------------------------------//
+            // Translation
+            //--------------------------------------------------//
+
+            /**
+             * @brief Whether or not Machine::run goes through the translation cache.
+             */
+            bool is_caching;
+
+            /**
+             * @brief Translated blocks, including the invalidated ones waiting to be reused.
+             */
+            std::vector<Block> blocks;
+
+            /**
+             * @brief Indexes of the invalidated blocks.
+             */
+            std::vector<std::int32_t> free_blocks;
+
+            /**
+             * @brief Index of the block starting at each address, -1 if there is none.
+             */
+            std::vector<std::int32_t> block_entries;
+
+            /**
+             * @brief Bitmap of the addresses covered by at least one block.
+             */
+            std::vector<std::uint8_t> block_coverage;
+
+            /**
+             * @brief Lookups that found a translated block.
+             */
+            std::uint64_t cache_hits;
+
+            /**
+             * @brief Lookups that had to translate a block.
+             */
+            std::uint64_t cache_misses;
+
+            /**
+             * @brief Blocks dropped because of writes into their range.
+             */
+            std::uint64_t cache_invalidations;
+
+            /**
+             * @brief Input journal recording the interrupt requests, null if none is.
+             */
+            Journal * journal;
+
+            /**
+             * @brief Records an interrupt request into the journal.
+             * @param lines The IRQ lines.
+             * @param is_asserted Whether the lines are asserted or released.
+             * @param is_nmi Whether it's an NMI instead, without lines.
+             */
+            void record_interrupt(const std::uint8_t lines, const bool is_asserted, const bool is_nmi) noexcept;
+
+            /**
+             * @brief Metrics the runs and interrupts are counted into, and the machine they were set on: copies keep
+             *        the pointers but don't count.
+             */
+            Metrics * metrics;
+            const Machine * metered;
+
+            bool is_metered() const noexcept {
+                return this->metrics != nullptr && this->metered == this;
+            }
+
+            /**
+             * @brief Counts a run into the metrics, if the machine is metered.
+             * @param executed The number of instructions.
+             * @param cycles The number of cycles.
+             * @return The number of instructions.
+             */
+            std::uint64_t meter(const std::uint64_t executed, const std::uint64_t cycles) noexcept {
+                if(this->is_metered()) {
+                    this->metrics->count_run(executed, cycles);
+                }
+
+                return executed;
+            }
+
+            /**
+             * @brief Executes the instruction IP is pointing to like Machine::step, without counting it into the
+             *        metrics, for the runs that count their instructions as a whole.
+             * @return The cycles the instruction took (and the interrupt before it), 0 if IP points to an illegal opcode.
+             */
+            std::uint8_t execute_next() noexcept {
+                std::uint64_t start = this->cycles;
+
+                if(this->cycles >= this->next_event) {
+                    this->dispatch_events();
+                }
+
+                const Instruction & instruction = instructions[this->memory.fetch(this->i_pointer)];
+
+                if(instruction.execute == nullptr) { // Illegal opcodes halt the machine, IP keeps pointing to them.
+                    return 0;
+                }
+
+                instruction.execute(*this);
+
+                return this->cycles - start;
+            }
+
+            /**
+             * @brief Executes instructions like Machine::run, in slices of Metrics::slice cycles counted into the
+             *        metrics with the host time they took, so the counters move during long runs.
+             * @param max_cycles The maximum number of cycles.
+             * @return The number of instructions executed.
+             */
+            std::uint64_t run_metered(const std::uint64_t max_cycles) noexcept {
+                std::uint64_t limit = this->cycles + max_cycles, executed = 0;
+
+                while(this->cycles < limit) {
+                    std::uint64_t start = this->cycles, cycles = std::min(limit - start, Metrics::slice);
+                    auto started = std::chrono::steady_clock::now();
+                    std::uint64_t sliced = this->is_caching ? this->run<Dispatch::Cached>(cycles) : this->run<dispatch>(cycles);
+
+                    this->metrics->count_run(sliced, this->cycles - start, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - started).count());
+                    executed += sliced;
+
+                    if(this->cycles < start + cycles) { // Halted.
+                        break;
+                    }
+                }
+
+                return executed;
+            }
+
+            /**
+             * @brief Static analysis of the memory the dumps show, null if none was made.
+             */
+            std::shared_ptr<const Analysis> analysis;
+
+            /**
+             * @brief Appends the block IP is in and a summary of the analysis to the text of a dump.
+             * @param text The string.
+             */
+            void format_analysis(std::string & text) const;
+    };
+
+    inline std::array<Machine::Instruction, 0x100> Machine::build_instructions() noexcept {
+        std::array<Instruction, 0x100> table;
+
+        table.fill({ "???", nullptr, Mode::Implied, 0, false });
+
+        #define X(opcode, mnemonic, handler, mode, timing) \
+            table[opcode] = { #mnemonic, [](Machine & machine) { \
+                machine.i_pointer++; \
+                machine.penalty = 0; \
+                machine.execute_##handler<Mode::mode>(); \
+                machine.cycles += timing + machine.penalty; \
+            }, Mode::mode, timing, Mode::mode == Mode::Relative };
+        __RHEA_INSTRUCTIONS__(X)
+        #undef X
+
+        for(std::uint8_t opcode : { 0x00, 0x20, 0x40, 0x4C, 0x60, 0x6C }) { // BRK, JSR, RTI, JMP, RTS and JMP (indirect).
+            table[opcode].is_branch = true;
+        }
+
+        return table;
+    }
+
+    inline const std::array<Machine::Instruction, 0x100> Machine::instructions = Machine::build_instructions();
+
+    inline constexpr std::array<Machine::Opcode, 0x100> Machine::opcodes = []() {
+        std::array<Opcode, 0x100> table = {};
+
+        #define X(opcode, mnemonic, handler, mode, timing) \
+            table[opcode] = { #mnemonic, Mode::mode, timing };
+        __RHEA_INSTRUCTIONS__(X)
+        #undef X
+
+        return table;
+    }();
+
+    class Disassembler {
+        public:
+            /**
+             * @brief Appends a listing of instructions to a string, reusing what was decoded before while the bytes
+             *        of its page are unchanged.
+             * @param text The string.
+             * @param memory The memory, read as stored.
+             * @param address The address of the first instruction.
+             * @param count The number of instructions.
+             * @return The address after the last listed instruction.
+             */
+            std::uint16_t format_listing(std::string & text, const Memory & memory, std::uint16_t address, const std::uint32_t count) {
+                Page * page = nullptr;
+
+                for(std::uint32_t index = 0; index < count; index++) {
+                    if(page == nullptr || page->number != (address >> 8)) { // Checked once per page and listing.
+                        page = &this->validate(memory, address >> 8);
+                    }
+
+                    Line & line = page->lines[address & 0xFF];
+
+                    if(!page->is_decoded[address & 0xFF]) { // Formatted once, then copied as it is.
+                        std::size_t start = text.size();
+                        Machine::Decoded decoded = Machine::decode(memory, address);
+
+                        Machine::format_decoded(text, memory, address, decoded);
+                        line.length = decoded.length;
+                        line.size = text.size() - start;
+                        std::memcpy(line.text, &text[start], line.size);
+                        page->is_decoded[address & 0xFF] = true;
+                    } else {
+                        text.append(line.text, line.size);
+                    }
+
+                    address += line.length;
+                }
+
+                return address;
+            }
+
+        private:
+            /**
+             * @brief Line of a decoded instruction.
+             */
+            struct Line {
+                /**
+                 * @brief Length in bytes of the instruction.
+                 */
+                std::uint8_t length;
+
+                /**
+                 * @brief Number of characters of the text.
+                 */
+                std::uint8_t size;
+
+                /**
+                 * @brief Text of the line, as Machine::format_decoded appends it.
+                 */
+                char text[32];
+            };
+
+            /**
+             * @brief Instructions decoded in a page, with the bytes they were decoded from.
+             */
+            struct Page {
+                /**
+                 * @brief Number of the page.
+                 */
+                std::uint8_t number;
+
+                /**
+                 * @brief Bytes of the page and the first 2 of the next one, where its last instructions end.
+                 */
+                std::array<std::uint8_t, 0x102> bytes;
+
+                /**
+                 * @brief Whether or not the instruction at each offset was decoded.
+                 */
+                std::bitset<0x100> is_decoded;
+
+                /**
+                 * @brief Line of the instruction at each offset.
+                 */
+                std::array<Line, 0x100> lines;
+            };
+
+            /**
+             * @brief Decoded pages, allocated when first listed.
+             */
+            std::array<std::unique_ptr<Page>, 0x100> pages;
+
+            /**
+             * @brief Gets the decoded page, dropped first if its bytes changed since it was decoded. The bytes are
+             *        compared instead of tracking the writes, so the bus is left alone.
+             * @param memory The memory.
+             * @param number The number of the page.
+             * @return The page.
+             */
+            Page & validate(const Memory & memory, const std::uint8_t number) {
+                std::unique_ptr<Page> & page = this->pages[number];
+                const std::uint8_t * bytes = memory.get_page(number);
+                const std::uint8_t * next = memory.get_page(number + 1);
+
+                if(page == nullptr) {
+                    page = std::make_unique<Page>();
+                    page->number = number;
+                } else if(std::memcmp(page->bytes.data(), bytes, 0x100) == 0 && std::memcmp(&page->bytes[0x100], next, 2) == 0) {
+                    return *page;
+                }
+
+                std::memcpy(page->bytes.data(), bytes, 0x100);
+                std::memcpy(&page->bytes[0x100], next, 2);
+                page->is_decoded.reset();
+
+                return *page;
+            }
+    };
+
+    class Assembler {
+        public:
+            /**
+             * @brief Assembles a source file into the memory, in two passes so labels can be used before they're
+             *        defined. Nothing is written if any line fails.
+             * @param path The path of the file.
+             * @param memory The memory.
+             * @param size The number of bytes written.
+             * @return If the operation was successful.
+             */
+            bool assemble_file(const std::string path, Memory & memory, std::uint32_t & size) {
+                std::ifstream file = std::ifstream(path, std::ios::binary);
+
+                if(!file.is_open()) {
+                    std::cerr << "\tFile at \"" << path << "\" not found." << std::endl;
+                    return false;
+                }
+
+                std::string source = std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+                std::vector<std::string_view> lines;
+                Context context = Context();
+
+                for(std::size_t offset = 0; offset <= source.size();) {
+                    std::size_t end = std::min(source.find('\n', offset), source.size());
+
+                    lines.push_back(std::string_view(source).substr(offset, end - offset));
+                    offset = end + 1;
+                }
+
+                context.symbols = this->labels;
+
+                for(context.is_final = false;; context.is_final = true) { // Sizes are settled by the first pass.
+                    bool is_successful = true;
+
+                    context.address = 0x0000;
+                    context.chunks.clear();
+
+                    for(context.line = 1; context.line <= lines.size(); context.line++) {
+                        is_successful &= this->assemble(lines[context.line - 1], context);
+                    }
+
+                    if(!is_successful) {
+                        return false;
+                    }
+
+                    if(context.is_final) {
+                        break;
+                    }
+                }
+
+                size = 0;
+
+                for(const Chunk & chunk : context.chunks) {
+                    memory.load_bytes(chunk.address, chunk.bytes.data(), chunk.bytes.size());
+                    size += chunk.bytes.size();
+                }
+
+                for(const std::pair<const std::string, Symbol> & symbol : context.symbols) { // Kept for the next lines.
+                    this->labels[symbol.first] = { symbol.second.value, 0, true };
+                }
+
+                return true;
+            }
+
+            /**
+             * @brief Assembles a single line into the memory. Only labels already defined can be used.
+             * @param line The line.
+             * @param memory The memory.
+             * @param address The address of the line, moved past what it wrote.
+             * @return If the operation was successful.
+             */
+            bool assemble_line(const std::string_view line, Memory & memory, std::uint16_t & address) {
+                Context context = Context();
+
+                context.symbols = std::move(this->labels);
+                context.is_final = true;
+                context.line = 0;
+                context.address = address;
+
+                bool is_successful = this->assemble(line, context);
+
+                this->labels = std::move(context.symbols);
+
+                if(!is_successful) {
+                    return false;
+                }
+
+                for(const Chunk & chunk : context.chunks) {
+                    memory.load_bytes(chunk.address, chunk.bytes.data(), chunk.bytes.size());
+                }
+
+                address = context.address;
+
+                return true;
+            }
+
+        private:
+            /**
+             * @brief Value of a label, with the line defining it (0 outside of the assembled file).
+             */
+            struct Symbol {
+                std::uint16_t value;
+                std::size_t line;
+                bool is_settled; // Its value was known in the first pass, so its uses are sized the same in both.
+            };
+
+            /**
+             * @brief Contiguous bytes to write.
+             */
+            struct Chunk {
+                std::uint16_t address;
+                std::vector<std::uint8_t> bytes;
+            };
+
+            /**
+             * @brief State of a pass.
+             */
+            struct Context {
+                std::unordered_map<std::string, Symbol> symbols;
+                std::vector<Chunk> chunks;
+                std::uint32_t address;
+                std::size_t line;
+                bool is_final; // Unknown labels and out of range values are errors.
+            };
+
+            /**
+             * @brief Labels defined by earlier lines and files.
+             */
+            std::unordered_map<std::string, Symbol> labels;
+
+            /**
+             * @brief Reports an error, prefixed with its line when assembling a file.
+             * @param context The state of the pass.
+             * @param message The message.
+             * @return False.
+             */
+            static bool fail(const Context & context, const std::string message) {
+                std::cerr << "\t" << (context.line > 0 ? "Line " + std::to_string(context.line) + ": " : "") << message << std::endl;
+                return false;
+            }
+
+            /**
+             * @brief Removes the leading and trailing blanks of a text.
+             * @param text The text.
+             * @return The trimmed text.
+             */
+            static std::string_view trim(std::string_view text) noexcept {
+                while(!text.empty() && std::isspace(static_cast<unsigned char>(text.front()))) {
+                    text.remove_prefix(1);
+                }
+
+                while(!text.empty() && std::isspace(static_cast<unsigned char>(text.back()))) {
+                    text.remove_suffix(1);
+                }
+
+                return text;
+            }
+
+            /**
+             * @brief Measures the label name at the start of a text.
+             * @param text The text.
+             * @return The number of characters of the name, 0 if the text doesn't start with one.
+             */
+            static std::size_t measure_name(const std::string_view text) noexcept {
+                std::size_t size = 0;
+
+                if(text.empty() || !(std::isalpha(static_cast<unsigned char>(text.front())) || text.front() == '_')) {
+                    return 0;
+                }
+
+                while(size < text.size() && (std::isalnum(static_cast<unsigned char>(text[size])) || text[size] == '_')) {
+                    size++;
+                }
+
+                return size;
+            }
+
+            /**
+             * @brief Splits a list on the commas outside of quotes.
+             * @param text The list.
+             * @return The trimmed items.
+             */
+            static std::vector<std::string_view> split_list(const std::string_view text) {
+                std::vector<std::string_view> items;
+                bool is_quoted = false;
+                std::size_t start = 0;
+
+                for(std::size_t index = 0; index <= text.size(); index++) {
+                    if(index < text.size() && text[index] == '"') {
+                        is_quoted = !is_quoted;
+                    }
+
+                    if(index == text.size() || (text[index] == ',' && !is_quoted)) {
+                        items.push_back(trim(text.substr(start, index - start)));
+                        start = index + 1;
+                    }
+                }
+
+                return items;
+            }
+
+            /**
+             * @brief Evaluates an expression: numbers ($hexadecimal, %binary, decimal or 'c'), labels and * (the
+             *        current address), added and subtracted, with an optional < (low byte) or > (high byte) in front.
+             * @param text The expression.
+             * @param context The state of the pass.
+             * @param value The value.
+             * @param is_forward Set if a label isn't defined yet at this line, then the value is only final in the
+             *        last pass.
+             * @return If the operation was successful.
+             */
+            static bool evaluate(std::string_view text, const Context & context, std::uint16_t & value, bool & is_forward) {
+                char selector = text.empty() ? '\0' : text.front();
+                std::uint32_t total = 0;
+                bool is_negative = false;
+
+                is_forward = false;
+
+                if(selector == '<' || selector == '>') {
+                    text = trim(text.substr(1));
+                }
+
+                if(!text.empty() && text.front() == '-') {
+                    is_negative = true;
+                    text = trim(text.substr(1));
+                }
+
+                while(true) {
+                    std::uint32_t term = 0;
+                    std::size_t size = measure_name(text);
+
+                    if(text.empty()) {
+                        return fail(context, "Missing value.");
+                    }
+
+                    if(size > 0) {
+                        std::string name = std::string(text.substr(0, size));
+                        auto symbol = context.symbols.find(name);
+
+                        if(symbol == context.symbols.end() || symbol->second.line > context.line || !symbol->second.is_settled) {
+                            if(symbol == context.symbols.end() && context.is_final) {
+                                return fail(context, "Unknown label \"" + name + "\".");
+                            }
+
+                            is_forward = true;
+                        }
+
+                        if(symbol != context.symbols.end()) {
+                            term = symbol->second.value;
+                        }
+                    } else if(text.front() == '*') {
+                        term = context.address;
+                        size = 1;
+                    } else if(text.front() == '\'' && text.size() >= 3 && text[2] == '\'') {
+                        term = static_cast<std::uint8_t>(text[1]);
+                        size = 3;
+                    } else {
+                        int base = text.front() == '$' ? 16 : text.front() == '%' ? 2 : 10;
+                        std::size_t start = base == 10 ? 0 : 1;
+
+                        for(size = start; size < text.size() && std::isxdigit(static_cast<unsigned char>(text[size])); size++) {
+                            int digit = std::isdigit(static_cast<unsigned char>(text[size])) ? text[size] - '0' : (std::toupper(text[size]) - 'A' + 10);
+
+                            if(digit >= base) {
+                                return fail(context, "Can't parse the value \"" + std::string(text) + "\".");
+                            }
+
+                            term = ((term * base) + digit) & 0xFFFF;
+                        }
+
+                        if(size == start) {
+                            return fail(context, "Can't parse the value \"" + std::string(text) + "\".");
+                        }
+                    }
+
+                    total = is_negative ? total - term : total + term;
+                    text = trim(text.substr(size));
+
+                    if(text.empty()) {
+                        break;
+                    }
+
+                    if(text.front() != '+' && text.front() != '-') {
+                        return fail(context, "Can't parse the value \"" + std::string(text) + "\".");
+                    }
+
+                    is_negative = text.front() == '-';
+                    text = trim(text.substr(1));
+                }
+
+                value = selector == '<' ? (total & 0xFF) : selector == '>' ? ((total >> 8) & 0xFF) : (total & 0xFFFF);
+
+                return true;
+            }
+
+            /**
+             * @brief Appends bytes at the current address.
+             * @param context The state of the pass.
+             * @param bytes The bytes.
+             * @param count The number of bytes.
+             * @return If the operation was successful, the bytes can't go past FFFF.
+             */
+            static bool emit(Context & context, const std::uint8_t * bytes, const std::size_t count) {
+                if(context.address + count > 0x10000) {
+                    return fail(context, "Can't write past FFFF.");
+                }
+
+                if(context.chunks.empty() || context.chunks.back().address + context.chunks.back().bytes.size() != context.address) {
+                    context.chunks.push_back({ static_cast<std::uint16_t>(context.address), {} });
+                }
+
+                context.chunks.back().bytes.insert(context.chunks.back().bytes.end(), bytes, bytes + count);
+                context.address += count;
+
+                return true;
+            }
+
+            /**
+             * @brief Finds the opcode of an instruction.
+             * @param mnemonic The mnemonic, in uppercase.
+             * @param mode The addressing mode.
+             * @return The opcode, -1 if the instruction doesn't have that mode.
+             */
+            static int find_opcode(const std::string_view mnemonic, const Machine::Mode mode) noexcept {
+                for(int opcode = 0x00; opcode < 0x100; opcode++) {
+                    const Machine::Opcode & entry = Machine::opcodes[opcode];
+
+                    if(entry.mnemonic != nullptr && entry.mode == mode && mnemonic == entry.mnemonic) {
+                        return opcode;
+                    }
+                }
+
+                return -1;
+            }
+
+            /**
+             * @brief Assembles a line: an optional "label:", then an instruction, a directive (.org, .byte, .word) or
+             *        "label = value", then an optional "; comment".
+             * @param line The line.
+             * @param context The state of the pass.
+             * @return If the operation was successful.
+             */
+            bool assemble(std::string_view line, Context & context) {
+                using Mode = Machine::Mode;
+                bool is_quoted = false;
+
+                for(std::size_t index = 0; index < line.size(); index++) { // Comments end the line, but not in strings.
+                    if(line[index] == '"') {
+                        is_quoted = !is_quoted;
+                    } else if(line[index] == ';' && !is_quoted) {
+                        line = line.substr(0, index);
+                        break;
+                    }
+                }
+
+                line = trim(line);
+
+                std::size_t size = measure_name(line);
+                std::string_view rest = trim(line.substr(size));
+
+                if(size > 0 && !rest.empty() && (rest.front() == ':' || rest.front() == '=')) {
+                    bool is_label = rest.front() == ':';
+                    std::string name = std::string(line.substr(0, size));
+                    std::uint16_t value = context.address;
+                    bool is_forward = false;
+
+                    if(!is_label && !evaluate(trim(rest.substr(1)), context, value, is_forward)) {
+                        return false;
+                    }
+
+                    auto symbol = context.symbols.find(name);
+
+                    if(symbol != context.symbols.end() && context.is_final && context.line > 0) { // Settled by the first pass.
+                        symbol->second.value = value;
+                    } else if(symbol != context.symbols.end() && context.line > 0 && symbol->second.line > 0) {
+                        return fail(context, "Label \"" + name + "\" is already defined.");
+                    } else {
+                        context.symbols[name] = { value, context.line, !is_forward };
+                    }
+
+                    if(!is_label) {
+                        return true;
+                    }
+
+                    line = trim(rest.substr(1));
+                }
+
+                if(line.empty()) {
+                    return true;
+                }
+
+                size = 0;
+
+                while(size < line.size() && !std::isspace(static_cast<unsigned char>(line[size]))) {
+                    size++;
+                }
+
+                std::string mnemonic = std::string(line.substr(0, size));
+                std::string_view operand = trim(line.substr(size));
+                std::uint16_t value = 0;
+                bool is_forward = false;
+
+                std::transform(mnemonic.begin(), mnemonic.end(), mnemonic.begin(), [](unsigned char character) { return std::toupper(character); });
+
+                if(mnemonic == ".ORG" || mnemonic == "*=") {
+                    if(!evaluate(operand, context, value, is_forward)) {
+                        return false;
+                    }
+
+                    if(is_forward) {
+                        return fail(context, "The address of .org can't use labels defined after it.");
+                    }
+
+                    context.address = value;
+
+                    return true;
+                }
+
+                if(mnemonic == ".BYTE" || mnemonic == ".WORD") {
+                    bool is_word = mnemonic == ".WORD";
+
+                    for(std::string_view item : split_list(operand)) {
+                        if(!is_word && item.size() >= 2 && item.front() == '"' && item.back() == '"') {
+                            if(!emit(context, reinterpret_cast<const std::uint8_t *> (item.data() + 1), item.size() - 2)) {
+                                return false;
+                            }
+
+                            continue;
+                        }
+
+                        if(!evaluate(item, context, value, is_forward)) {
+                            return false;
+                        }
+
+                        if(!is_word && value > 0xFF && context.is_final) {
+                            return fail(context, "Value \"" + std::string(item) + "\" doesn't fit in a byte.");
+                        }
+
+                        std::uint8_t bytes[2] = { static_cast<std::uint8_t>(value), static_cast<std::uint8_t>(value >> 8) };
+
+                        if(!emit(context, bytes, is_word ? 2 : 1)) {
+                            return false;
+                        }
+                    }
+
+                    return true;
+                }
+
+                if(std::none_of(Machine::opcodes.begin(), Machine::opcodes.end(), [&mnemonic](const Machine::Opcode & entry) { return entry.mnemonic != nullptr && mnemonic == entry.mnemonic; })) {
+                    return fail(context, "Unknown instruction \"" + mnemonic + "\".");
+                }
+
+                std::string text; // The operand without blanks.
+                Mode mode = Mode::Implied, zero_page = Mode::Implied, absolute = Mode::Implied;
+
+                for(char character : operand) {
+                    if(!std::isspace(static_cast<unsigned char>(character))) {
+                        text += character;
+                    }
+                }
+
+                auto is_ending = [&text](const char * suffix) {
+                    std::size_t size = std::strlen(suffix);
+
+                    return text.size() > size && std::equal(suffix, suffix + size, text.end() - size, [](char left, char right) { return left == std::toupper(right); });
+                };
+                std::string_view expression = text;
+
+                if(text.empty()) {
+                    mode = find_opcode(mnemonic, Mode::Implied) != -1 ? Mode::Implied : Mode::Accumulator;
+                } else if(text == "A" || text == "a") {
+                    mode = Mode::Accumulator;
+                } else if(text.front() == '#') {
+                    mode = Mode::Immediate;
+                    expression.remove_prefix(1);
+                } else if(text.front() == '(' && is_ending(",X)")) {
+                    mode = Mode::IndirectX;
+                    expression = expression.substr(1, expression.size() - 4);
+                } else if(text.front() == '(' && is_ending("),Y")) {
+                    mode = Mode::IndirectY;
+                    expression = expression.substr(1, expression.size() - 4);
+                } else if(text.front() == '(' && text.back() == ')') {
+                    mode = Mode::Indirect;
+                    expression = expression.substr(1, expression.size() - 2);
+                } else if(is_ending(",X")) {
+                    zero_page = Mode::ZeroPageX;
+                    absolute = Mode::AbsoluteX;
+                    expression.remove_suffix(2);
+                } else if(is_ending(",Y")) {
+                    zero_page = Mode::ZeroPageY;
+                    absolute = Mode::AbsoluteY;
+                    expression.remove_suffix(2);
+                } else {
+                    zero_page = find_opcode(mnemonic, Mode::Relative) != -1 ? Mode::Relative : Mode::ZeroPage;
+                    absolute = zero_page == Mode::Relative ? Mode::Relative : Mode::Absolute;
+                }
+
+                if((mode != Mode::Implied && mode != Mode::Accumulator) || zero_page != Mode::Implied) {
+                    if(!evaluate(expression, context, value, is_forward)) {
+                        return false;
+                    }
+                }
+
+                if(zero_page != Mode::Implied) { // Zero page when the value is known to fit, unless only one exists.
+                    bool has_zero_page = find_opcode(mnemonic, zero_page) != -1, has_absolute = find_opcode(mnemonic, absolute) != -1;
+                    bool is_byte = expression.front() == '<' || expression.front() == '>' || (!is_forward && value <= 0xFF);
+
+                    mode = has_zero_page && (!has_absolute || is_byte) ? zero_page : absolute;
+                }
+
+                int opcode = find_opcode(mnemonic, mode);
+
+                if(opcode == -1) {
+                    return fail(context, "Instruction \"" + mnemonic + "\" can't take the operand \"" + std::string(operand) + "\".");
+                }
+
+                std::uint8_t bytes[3] = { static_cast<std::uint8_t>(opcode), static_cast<std::uint8_t>(value), static_cast<std::uint8_t>(value >> 8) };
+                std::uint8_t length = Machine::length(mode);
+
+                if(mode == Mode::Relative) {
+                    std::int32_t offset = static_cast<std::int32_t>(value) - static_cast<std::int32_t>((context.address + 2) & 0xFFFF);
+
+                    if(context.is_final && (offset < -0x80 || offset > 0x7F)) {
+                        return fail(context, "Branch to \"" + format_hex(value) + "\" is out of range.");
+                    }
+
+                    bytes[1] = static_cast<std::uint8_t>(offset);
+                } else if(length == 2 && value > 0xFF && context.is_final) {
+                    return fail(context, "Operand \"" + std::string(operand) + "\" doesn't fit in a byte.");
+                }
+
+                return emit(context, bytes, length);
+            }
+    };
+
+    class Analysis {
+        public:
+            /**
+             * @brief Bits of the flags of each address.
+             */
+            enum Flag : std::uint8_t {
+                Code = 0x01,    // First byte of a reached instruction.
+                Operand = 0x02, // Other byte of a reached instruction.
+                Leader = 0x04,  // First instruction of a block.
+                Entry = 0x08,   // Target of a vector.
+                Target = 0x10,  // Target of a branch or a jump.
+                Called = 0x20,  // Target of a JSR.
+                Written = 0x40, // Reached code a reached instruction writes to.
+                Last = 0x80     // Branch, jump, call or return, the last instruction of its block.
+            };
+
+            /**
+             * @brief Kinds of the edges going out of a block.
+             */
+            enum class Kind : std::uint8_t {
+                Fallthrough, // To the instruction after, also after a JSR returns.
+                Branch,      // Taken branch.
+                Jump,        // JMP.
+                Call,        // JSR.
+                Indirect     // JMP through a pointer, the target is the address of the pointer.
+            };
+
+            /**
+             * @brief Edge going out of a block.
+             */
+            struct Edge {
+                std::uint16_t target;
+                Kind kind;
+            };
+
+            /**
+             * @brief Straight run of instructions, only entered through the first one.
+             */
+            struct Block {
+                /**
+                 * @brief Addresses of the first and the last instruction, and bytes of all of them.
+                 */
+                std::uint16_t first;
+                std::uint16_t last;
+                std::uint16_t size;
+
+                /**
+                 * @brief Number of instructions.
+                 */
+                std::uint16_t instructions;
+
+                /**
+                 * @brief Index of the first edge going out of the block, and number of them.
+                 */
+                std::uint32_t edge;
+                std::uint8_t edges;
+            };
+
+            /**
+             * @brief Vector the analysis starts from.
+             */
+            struct Vector {
+                const char * name;
+                std::uint16_t address;
+                std::uint16_t target;
+
+                /**
+                 * @brief Whether it's set (a 0000 reset vector starts at 8000, like Machine::reset) and its target is
+                 *        a legal instruction.
+                 */
+                bool is_set;
+                bool is_reached;
+            };
+
+            /**
+             * @brief Constructor, analyzes the memory as stored: follows the flow from the NMI, reset and IRQ vectors
+             *        through every branch, jump and call, splitting it into blocks. JMPs through pointers and RTS aren't
+             *        followed, their targets are only known when running.
+             * @param memory The memory.
+             */
+            Analysis(const Memory & memory) {
+                auto peek = [&memory](const std::uint16_t at) { return memory.get_page(at >> 8)[at & 0xFF]; };
+                std::vector<std::uint16_t> pending;
+                std::vector<std::pair<std::uint16_t, std::uint16_t>> stores;
+                const char * names[] = { "NMI", "RESET", "IRQ" };
+
+                this->flags.assign(0x10000, 0x00);
+
+                auto mark = [this, &pending](const std::uint16_t target, const std::uint8_t flag) {
+                    if(!(this->flags[target] & Flag::Code)) {
+                        pending.push_back(target);
+                    }
+
+                    this->flags[target] |= flag | Flag::Leader;
+                };
+
+                for(std::uint8_t index = 0; index < 3; index++) {
+                    Vector & vector = this->vectors[index];
+
+                    vector.name = names[index];
+                    vector.address = 0xFFFA + index * 2;
+                    vector.target = peek(vector.address) | (peek(vector.address + 1) << 8);
+                    vector.is_set = vector.target != 0x0000 || index == 1;
+
+                    if(vector.target == 0x0000 && index == 1) {
+                        vector.target = 0x8000;
+                    }
+
+                    vector.is_reached = vector.is_set && Machine::opcodes[peek(vector.target)].mnemonic != nullptr;
+
+                    if(vector.is_set) {
+                        mark(vector.target, Flag::Entry);
+                    }
+                }
+
+                while(!pending.empty()) {
+                    std::uint16_t address = pending.back();
+
+                    pending.pop_back();
+
+                    while(true) { // Up to the end of the flow or to code already walked.
+                        if(this->flags[address] & Flag::Code) { // A block starts where it joins.
+                            this->flags[address] |= Flag::Leader;
+                            break;
+                        }
+
+                        std::uint8_t opcode = peek(address);
+                        const Machine::Opcode & entry = Machine::opcodes[opcode];
+
+                        if(entry.mnemonic == nullptr) {
+                            this->illegal.push_back(address);
+                            break;
+                        }
+
+                        std::uint8_t length = Machine::length(entry.mode);
+                        std::uint16_t operand = peek(address + 1) | (peek(address + 2) << 8);
+                        std::uint16_t next = address + length;
+
+                        this->flags[address] |= Flag::Code;
+
+                        for(std::uint8_t offset = 1; offset < length; offset++) {
+                            this->flags[static_cast<std::uint16_t>(address + offset)] |= Flag::Operand;
+                        }
+
+                        switch(flows[opcode]) {
+                            case Flow::Branch:
+                                mark(next + static_cast<std::int8_t>(operand & 0xFF), Flag::Target);
+                                this->flags[next] |= Flag::Leader;
+                                break;
+
+                            case Flow::Jump:
+                                mark(operand, Flag::Target);
+                                break;
+
+                            case Flow::Call:
+                                mark(operand, Flag::Called);
+                                this->flags[next] |= Flag::Leader;
+                                break;
+
+                            case Flow::Write:
+                                stores.push_back({ address, entry.mode == Mode::ZeroPage || entry.mode == Mode::ZeroPageX ? operand & 0xFF : operand });
+                                break;
+
+                            default:
+                                break;
+                        }
+
+                        if(flows[opcode] == Flow::Jump || flows[opcode] == Flow::Indirect || flows[opcode] == Flow::Stop) {
+                            this->flags[address] |= Flag::Last;
+                            break;
+                        }
+
+                        if(flows[opcode] == Flow::Branch || flows[opcode] == Flow::Call) {
+                            this->flags[address] |= Flag::Last;
+                        }
+
+                        address = next;
+                    }
+                }
+
+                for(const std::pair<std::uint16_t, std::uint16_t> & store : stores) { // Indexed stores only count their base.
+                    if(this->flags[store.second] & (Flag::Code | Flag::Operand)) {
+                        this->flags[store.second] |= Flag::Written;
+                        this->writes.push_back(store);
+                    }
+                }
+
+                std::sort(this->writes.begin(), this->writes.end());
+                std::sort(this->illegal.begin(), this->illegal.end());
+                this->illegal.erase(std::unique(this->illegal.begin(), this->illegal.end()), this->illegal.end());
+
+                for(std::uint32_t address = 0x0000; address <= 0xFFFF;) { // The blocks, in address order.
+                    if(!(this->flags[address] & Flag::Code)) {
+                        address++;
+                        continue;
+                    }
+
+                    Block block = { static_cast<std::uint16_t>(address), 0x0000, 0, 0, static_cast<std::uint32_t>(this->edges.size()), 0 };
+                    std::uint32_t next;
+
+                    while(true) {
+                        next = address + Machine::length(Machine::opcodes[peek(address)].mode);
+                        block.instructions++;
+
+                        if((this->flags[address] & Flag::Last) || next > 0xFFFF || (this->flags[next] & (Flag::Code | Flag::Leader)) != Flag::Code) {
+                            break;
+                        }
+
+                        address = next;
+                    }
+
+                    block.last = address;
+                    block.size = next - block.first;
+
+                    std::uint8_t opcode = peek(block.last);
+                    std::uint16_t operand = peek(block.last + 1) | (peek(block.last + 2) << 8);
+
+                    switch(flows[opcode]) {
+                        case Flow::Branch:
+                            this->edges.push_back({ static_cast<std::uint16_t>(next + static_cast<std::int8_t>(operand & 0xFF)), Kind::Branch });
+                            break;
+
+                        case Flow::Jump:
+                            this->edges.push_back({ operand, Kind::Jump });
+                            break;
+
+                        case Flow::Call:
+                            this->edges.push_back({ operand, Kind::Call });
+                            break;
+
+                        case Flow::Indirect:
+                            this->edges.push_back({ operand, Kind::Indirect });
+                            break;
+
+                        default:
+                            break;
+                    }
+
+                    if(flows[opcode] != Flow::Jump && flows[opcode] != Flow::Indirect && flows[opcode] != Flow::Stop && next <= 0xFFFF) {
+                        this->edges.push_back({ static_cast<std::uint16_t>(next), Kind::Fallthrough });
+                    }
+
+                    block.edges = this->edges.size() - block.edge;
+                    this->blocks.push_back(block);
+                    address = next;
+                }
+            }
+
+            /**
+             * @brief Gets the flags of an address.
+             * @param address The address.
+             * @return The flags, 0 for data (never reached).
+             */
+            std::uint8_t get_flags(const std::uint16_t address) const noexcept {
+                return this->flags[address];
+            }
+
+            /**
+             * @brief Finds the block an address is in.
+             * @param address The address.
+             * @return The block, null if the address isn't in reached code.
+             */
+            const Block * find_block(const std::uint16_t address) const noexcept {
+                auto block = std::upper_bound(this->blocks.begin(), this->blocks.end(), address, [](const std::uint16_t at, const Block & candidate) { return at < candidate.first; });
+
+                if(block == this->blocks.begin() || address >= (block - 1)->first + (block - 1)->size) {
+                    return nullptr;
+                }
+
+                return &*(block - 1);
+            }
+
+            /**
+             * @brief Counts the edges coming into a block, the vectors aside.
+             * @param block The block.
+             * @return The number of edges.
+             */
+            std::size_t count_incoming(const Block & block) const noexcept {
+                return std::count_if(this->edges.begin(), this->edges.end(), [&block](const Edge & edge) { return edge.target == block.first && edge.kind != Kind::Indirect; });
+            }
+
+            /**
+             * @brief Gets the ranges of the ROM (8000 to FFF9) never reached, leaving out the padding (runs of 8 or more
+             *        equal bytes).
+             * @param memory The memory the analysis was made of.
+             * @return The first and last address of each range.
+             */
+            std::vector<std::pair<std::uint16_t, std::uint16_t>> get_unreached(const Memory & memory) const {
+                std::vector<std::pair<std::uint16_t, std::uint16_t>> ranges;
+                std::uint32_t first = 0, run = 0;
+                bool is_open = false;
+                auto peek = [&memory](const std::uint32_t at) { return memory.get_page(at >> 8)[at & 0xFF]; };
+
+                for(std::uint32_t address = 0x8000; address <= 0xFFFA; address++) {
+                    bool is_unreached = address < 0xFFFA && !(this->flags[address] & (Flag::Code | Flag::Operand));
+
+                    run = is_unreached && run > 0 && peek(address) == peek(address - 1) ? run + 1 : is_unreached;
+
+                    if(is_unreached && !is_open && run < 8) {
+                        first = address;
+                        is_open = true;
+                    }
+
+                    if(is_open && (!is_unreached || run == 8)) { // Ends before the padding, if that's what ended it.
+                        std::uint32_t last = is_unreached ? address - 8 : address - 1;
+
+                        if(last >= first) {
+                            ranges.push_back({ first, last });
+                        }
+
+                        is_open = false;
+                    }
+                }
+
+                return ranges;
+            }
+
+            /**
+             * @brief Counts the bytes of reached instructions.
+             * @return The number of bytes.
+             */
+            std::uint32_t count_code() const noexcept {
+                return std::count_if(this->flags.begin(), this->flags.end(), [](const std::uint8_t flag) { return flag & (Flag::Code | Flag::Operand); });
+            }
+
+            const std::vector<Block> & get_blocks() const noexcept {
+                return this->blocks;
+            }
+
+            const std::vector<Edge> & get_edges() const noexcept {
+                return this->edges;
+            }
+
+            const std::array<Vector, 3> & get_vectors() const noexcept {
+                return this->vectors;
+            }
+
+            /**
+             * @brief Gets the writes of reached instructions into reached code (self-modifying code).
+             * @return The address of each writing instruction and the address written.
+             */
+            const std::vector<std::pair<std::uint16_t, std::uint16_t>> & get_writes() const noexcept {
+                return this->writes;
+            }
+
+            /**
+             * @brief Gets the illegal opcodes the flow reaches, where the machine would halt.
+             * @return The addresses.
+             */
+            const std::vector<std::uint16_t> & get_illegal() const noexcept {
+                return this->illegal;
+            }
+
+            /**
+             * @brief Appends a summary of the analysis to a string, a line per item.
+             * @param text The string.
+             * @param memory The memory the analysis was made of.
+             */
+            void format_summary(std::string & text, const Memory & memory) const {
+                std::vector<std::pair<std::uint16_t, std::uint16_t>> unreached = this->get_unreached(memory);
+                std::uint32_t unreached_bytes = 0;
+
+                for(const std::pair<std::uint16_t, std::uint16_t> & range : unreached) {
+                    unreached_bytes += range.second - range.first + 1;
+                }
+
+                for(const Vector & vector : this->vectors) {
+                    text += vector.name;
+                    text += std::string(6 - std::strlen(vector.name), ' ');
+                    text += vector.is_set ? format_hex(vector.target) + (vector.is_reached ? "" : " (illegal opcode)") : std::string("unset");
+                    text += "\n";
+                }
+
+                text += "Blocks: " + std::to_string(this->blocks.size()) + ", edges: " + std::to_string(this->edges.size()) + ", code: " + std::to_string(this->count_code()) + " byte(s)\n";
+                text += "Unreached ROM: " + std::to_string(unreached_bytes) + " byte(s) in " + std::to_string(unreached.size()) + " range(s), padding aside\n";
+                text += "Self-modifying writes: " + std::to_string(this->writes.size()) + ", illegal opcodes reached: " + std::to_string(this->illegal.size()) + "\n";
+            }
+
+        private:
+            using Mode = Machine::Mode;
+
+            /**
+             * @brief How an instruction goes on, as far as the analysis cares.
+             */
+            enum class Flow : std::uint8_t {
+                None,     // To the next instruction.
+                Branch,   // To the next instruction or to the target.
+                Jump,     // To the target.
+                Call,     // To the target, then back to the next instruction.
+                Indirect, // Unknown.
+                Stop,     // Unknown or nowhere (RTS, RTI, BRK).
+                Write     // To the next instruction, writing to memory.
+            };
+
+            /**
+             * @brief Compares a mnemonic of the opcode table.
+             * @param mnemonic The mnemonic, null for the illegal opcodes.
+             * @param name The name.
+             * @return Whether or not they match.
+             */
+            static constexpr bool is_mnemonic(const char * mnemonic, const char * name) noexcept {
+                return mnemonic != nullptr && mnemonic[0] == name[0] && mnemonic[1] == name[1] && mnemonic[2] == name[2];
+            }
+
+            /**
+             * @brief Flow of each opcode, derived from the opcode table.
+             */
+            static const std::array<Flow, 0x100> flows;
+
+            /**
+             * @brief Flags of each address.
+             */
+            std::vector<std::uint8_t> flags;
+
+            /**
+             * @brief Blocks in address order, and the edges going out of them in the same order.
+             */
+            std::vector<Block> blocks;
+            std::vector<Edge> edges;
+
+            std::array<Vector, 3> vectors;
+            std::vector<std::pair<std::uint16_t, std::uint16_t>> writes;
+            std::vector<std::uint16_t> illegal;
+    };
+
+    inline constexpr std::array<Analysis::Flow, 0x100> Analysis::flows = []() {
+        std::array<Flow, 0x100> table = {};
+        const char * writers[] = { "STA", "STX", "STY", "INC", "DEC", "ASL", "LSR", "ROL", "ROR" };
+
+        for(std::uint16_t opcode = 0x00; opcode < 0x100; opcode++) {
+            const Machine::Opcode & entry = Machine::opcodes[opcode];
+
+            if(entry.mode == Mode::Relative) {
+                table[opcode] = Flow::Branch;
+            } else if(is_mnemonic(entry.mnemonic, "JMP")) {
+                table[opcode] = entry.mode == Mode::Indirect ? Flow::Indirect : Flow::Jump;
+            } else if(is_mnemonic(entry.mnemonic, "JSR")) {
+                table[opcode] = Flow::Call;
+            } else if(is_mnemonic(entry.mnemonic, "RTS") || is_mnemonic(entry.mnemonic, "RTI") || is_mnemonic(entry.mnemonic, "BRK")) {
+                table[opcode] = Flow::Stop;
+            } else if(entry.mode != Mode::Accumulator && entry.mode != Mode::Implied) {
+                for(const char * writer : writers) {
+                    if(is_mnemonic(entry.mnemonic, writer)) {
+                        table[opcode] = Flow::Write;
+                    }
+                }
+            }
+        }
+
+        return table;
+    }();
+
+    inline void Machine::format_analysis(std::string & text) const {
+        const Analysis::Block * block = this->analysis->find_block(this->i_pointer);
+        const char * kinds[] = { "fallthrough", "branch", "jump", "call", "indirect" };
+
+        text += "Control Flow (Near IP):\n";
+        text += "----------------------------------------------------------------------\n";
+
+        if(block == nullptr) {
+            text += "IP isn't in code reached from the vectors.\n";
+        } else {
+            std::uint8_t flags = this->analysis->get_flags(block->first);
+
+            text += "Block " + format_hex(block->first) + "-" + format_hex(block->first + block->size - 1) + ", " + std::to_string(block->instructions) + " instruction(s), ";
+            text += std::to_string(this->analysis->count_incoming(*block)) + " edge(s) in";
+            text += (flags & Analysis::Flag::Entry) ? ", vector target" : "";
+            text += (flags & Analysis::Flag::Called) ? ", subroutine" : "";
+            text += "\n";
+
+            for(std::uint32_t edge = block->edge; edge < block->edge + block->edges; edge++) {
+                const Analysis::Edge & out = this->analysis->get_edges()[edge];
+
+                text += "  -> " + format_hex(out.target) + " " + kinds[static_cast<std::uint8_t>(out.kind)] + "\n";
+            }
+        }
+
+        this->analysis->format_summary(text, this->memory);
+        text += "\n";
+    }
+
+    template<typename Element> class Ring {
+        public:
+            /**
+             * @brief Constructor.
+             * @param capacity The capacity in elements, rounded up to a power of two.
+             */
+            Ring(const std::size_t capacity) {
+                std::size_t size = 1;
+
+                while(size < capacity) {
+                    size <<= 1;
+                }
+
+                this->buffer.resize(size);
+                this->head = 0;
+                this->tail = 0;
+            }
+
+            /**
+             * @brief Appends elements, from the producer thread only.
+             * @param elements The elements.
+             * @param count The number of elements.
+             * @return Whether or not there was room for all of them, nothing is appended otherwise.
+             */
+            bool push(const Element * elements, const std::size_t count) noexcept {
+                std::size_t head = this->head.load(std::memory_order_relaxed);
+                std::size_t tail = this->tail.load(std::memory_order_acquire);
+                std::size_t offset = head & (this->buffer.size() - 1);
+                std::size_t first = std::min(count, this->buffer.size() - offset);
+
+                if(this->buffer.size() - (head - tail) < count) {
+                    return false;
+                }
+
+                std::copy(elements, elements + first, &this->buffer[offset]);
+                std::copy(elements + first, elements + count, &this->buffer[0]);
+                this->head.store(head + count, std::memory_order_release);
+
+                return true;
+            }
+
+            /**
+             * @brief Takes the oldest elements, from the consumer thread only.
+             * @param elements Where to copy the elements.
+             * @param capacity The maximum number of elements.
+             * @return The number of elements taken.
+             */
+            std::size_t pop(Element * elements, const std::size_t capacity) noexcept {
+                std::size_t tail = this->tail.load(std::memory_order_relaxed);
+                std::size_t head = this->head.load(std::memory_order_acquire);
+                std::size_t offset = tail & (this->buffer.size() - 1);
+                std::size_t count = std::min(capacity, head - tail);
+                std::size_t first = std::min(count, this->buffer.size() - offset);
+
+                std::copy(&this->buffer[offset], &this->buffer[offset] + first, elements);
+                std::copy(&this->buffer[0], &this->buffer[0] + (count - first), elements + first);
+                this->tail.store(tail + count, std::memory_order_release);
+
+                return count;
+            }
+
+        private:
+            /**
+             * @brief The elements, the size is a power of two.
+             */
+            std::vector<Element> buffer;
+
+            /**
+             * @brief Total elements pushed and popped. Kept on their own cache lines, as each is written by one thread.
+             */
+            alignas(64) std::atomic<std::size_t> head;
+            alignas(64) std::atomic<std::size_t> tail;
+    };
+
+    class Tracer {
+        public:
+            /**
+             * @brief Fields present in an encoded record besides the flags and the opcode.
+             */
+            enum Field : std::uint8_t {
+                ARegister = 0x01, // New value of the AR.
+                XRegister = 0x02, // New value of the XR.
+                YRegister = 0x04, // New value of the YR.
+                SRegister = 0x08, // New value of the SR.
+                SPointer = 0x10,  // New value of the SP.
+                Jump = 0x20,      // The IP isn't right after the previous instruction, zigzag varint of the difference.
+                Penalty = 0x40,   // Extra cycles over the base ones of the opcode.
+                Writes = 0x80     // Varint count of bus writes, each a zigzag varint address difference and the byte.
+            };
+
+            /**
+             * @brief Executed instruction as captured by the machine, encoded later by the background thread.
+             */
+            struct Record {
+                /**
+                 * @brief Maximum number of writes of an instruction (BRK pushes three bytes, and so does an interrupt
+                 *        taken right before it).
+                 */
+                static constexpr std::uint8_t capacity = 6;
+
+                std::uint16_t address;
+                std::uint8_t opcode;
+                std::uint8_t penalty;
+                std::array<std::uint8_t, 5> registers;
+                std::uint8_t count;
+                std::uint16_t write_addresses[capacity];
+                std::uint8_t write_values[capacity];
+            };
+
+            /**
+             * @brief Constructor.
+             */
+            Tracer() : ring(1 << 16) {
+                for(std::uint16_t opcode = 0x00; opcode < 0x100; opcode++) {
+                    this->lengths[opcode] = Machine::length(Machine::instructions[opcode].mode);
+                }
+
+                this->machine = nullptr;
+                this->is_stopping = false;
+                this->pending_size = 0;
+                this->records = 0;
+                this->bytes = 0;
+            }
+
+            /**
+             * @brief Destructor.
+             */
+            ~Tracer() noexcept {
+                if(this->is_active()) {
+                    this->stop();
+                }
+            }
+
+            /**
+             * @brief Starts recording the instructions a machine executes into a binary file. The machine only copies
+             *        each instruction into a lock-free ring, a background thread encodes and writes them.
+             * @param path The path to the file.
+             * @param machine The machine, its initial state goes into the header.
+             * @return If the operation was successful.
+             */
+            bool start(const std::string path, Machine & machine) {
+                this->file = std::ofstream(path, std::ios::binary);
+
+                if(!this->file.is_open()) {
+                    std::cerr << "\tFile at \"" << path << "\" not found." << std::endl;
+                    return false;
+                }
+
+                std::uint8_t header[sizeof(magic) + 15];
+                std::uint64_t cycles = machine.reference_cycles();
+
+                this->machine = &machine;
+                this->registers = {
+                    machine.reference_a_register(), machine.reference_x_register(), machine.reference_y_register(),
+                    machine.reference_s_register(), machine.reference_s_pointer()
+                };
+                this->expected = machine.reference_i_pointer();
+                this->last_write = 0x0000;
+                this->records = 0;
+                this->bytes = sizeof(header);
+
+                std::memcpy(header, magic, sizeof(magic));
+                std::memcpy(&header[sizeof(magic)], this->registers.data(), 5);
+                header[sizeof(magic) + 5] = this->expected & 0xFF;
+                header[sizeof(magic) + 6] = this->expected >> 8;
+
+                for(std::uint8_t byte = 0; byte < 8; byte++) {
+                    header[sizeof(magic) + 7 + byte] = (cycles >> (byte * 8)) & 0xFF;
+                }
+
+                this->file.write(reinterpret_cast<char *> (header), sizeof(header));
+                this->writes.clear();
+                machine.reference_memory().set_tracing(&this->writes);
+                this->is_stopping = false;
+                this->writer = std::thread([this]() {
+                    std::vector<Record> records = std::vector<Record>(this->pending.size());
+                    std::vector<std::uint8_t> encoded = std::vector<std::uint8_t>(this->pending.size() * 32);
+
+                    while(true) {
+                        bool is_stopping = this->is_stopping.load(std::memory_order_acquire); // Read before popping, so nothing pushed before stopping is missed.
+                        std::size_t count = this->ring.pop(records.data(), records.size());
+
+                        if(count > 0) {
+                            std::size_t size = this->encode(records.data(), count, encoded.data());
+
+                            this->file.write(reinterpret_cast<char *> (encoded.data()), size);
+                            this->bytes += size;
+                        } else if(is_stopping) {
+                            break;
+                        } else {
+                            std::this_thread::sleep_for(std::chrono::microseconds(100));
+                        }
+                    }
+                });
+
+                return true;
+            }
+
+            /**
+             * @brief Stops recording, waiting for the background thread to write everything.
+             */
+            void stop() {
+                this->flush();
+                this->is_stopping.store(true, std::memory_order_release);
+                this->writer.join();
+                this->file.close();
+                this->machine->reference_memory().set_tracing(nullptr);
+                this->machine = nullptr;
+            }
+
+            /**
+             * @brief Records an executed instruction.
+             * @param address The address of the instruction.
+             * @param opcode The opcode.
+             * @param penalty The extra cycles over the base ones of the opcode.
+             * @param registers AR, XR, YR, SR and SP after the instruction.
+             */
+            void record(const std::uint16_t address, const std::uint8_t opcode, const std::uint8_t penalty, const std::array<std::uint8_t, 5> registers) noexcept {
+                Record & record = this->pending[this->pending_size];
+
+                record.address = address;
+                record.opcode = opcode;
+                record.penalty = penalty;
+                record.registers = registers;
+                record.count = 0;
+
+                if(!this->writes.empty()) {
+                    for(const std::pair<std::uint16_t, std::uint8_t> & write : this->writes) {
+                        if(record.count < Record::capacity) {
+                            record.write_addresses[record.count] = write.first;
+                            record.write_values[record.count] = write.second;
+                            record.count++;
+                        }
+                    }
+
+                    this->writes.clear();
+                }
+
+                this->records++;
+
+                if(++this->pending_size == this->pending.size()) {
+                    this->flush();
+                }
+            }
+
+            /**
+             * @brief Decodes a binary trace into text, one line per instruction.
+             * @param path The path to the trace.
+             * @param output The path to the text file.
+             * @return If the operation was successful.
+             */
+            static bool decode(const std::string path, const std::string output) {
+                std::ifstream file = std::ifstream(path, std::ios::binary);
+                std::ofstream text = std::ofstream(output);
+                std::uint8_t header[sizeof(magic) + 15];
+                std::uint8_t registers[5];
+                std::uint16_t address, last_write = 0x0000;
+                std::uint64_t cycles = 0;
+                int fields;
+
+                if(!file.is_open()) {
+                    std::cerr << "\tFile at \"" << path << "\" not found." << std::endl;
+                    return false;
+                }
+
+                if(!text.is_open()) {
+                    std::cerr << "\tFile at \"" << output << "\" not found." << std::endl;
+                    return false;
+                }
+
+                if(!file.read(reinterpret_cast<char *> (header), sizeof(header)) || std::memcmp(header, magic, sizeof(magic)) != 0) {
+                    std::cerr << "\tFile at \"" << path << "\" is not a trace." << std::endl;
+                    return false;
+                }
+
+                std::memcpy(registers, &header[sizeof(magic)], 5);
+                address = header[sizeof(magic) + 5] | (header[sizeof(magic) + 6] << 8);
+
+                for(std::uint8_t byte = 0; byte < 8; byte++) {
+                    cycles |= static_cast<std::uint64_t>(header[sizeof(magic) + 7 + byte]) << (byte * 8);
+                }
+
+                while((fields = file.get()) != EOF) {
+                    std::uint8_t opcode = file.get();
+                    const Machine::Instruction & instruction = Machine::instructions[opcode];
+                    std::uint8_t penalty = 0;
+
+                    if(fields & Field::Jump) {
+                        address += unzigzag(decode_varint(file));
+                    }
+
+                    for(std::uint8_t index = 0; index < 5; index++) {
+                        if(fields & (1 << index)) {
+                            registers[index] = file.get();
+                        }
+                    }
+
+                    if(fields & Field::Penalty) {
+                        penalty = file.get();
+                    }
+
+                    cycles += instruction.cycles + penalty;
+                    text << format_hex(address) << "  " << format_hex(opcode, 2) << " " << instruction.mnemonic;
+                    text << "  AR: " << format_hex(registers[0], 2) << " XR: " << format_hex(registers[1], 2) << " YR: " << format_hex(registers[2], 2);
+                    text << " SR: " << format_hex(registers[3], 2) << " SP: " << format_hex(registers[4], 2) << "  Cycles: " << cycles;
+
+                    if(fields & Field::Writes) {
+                        for(std::uint64_t count = decode_varint(file); count > 0; count--) {
+                            last_write += unzigzag(decode_varint(file));
+                            text << "  [" << format_hex(last_write) << "] <- " << format_hex(file.get() & 0xFF, 2);
+                        }
+                    }
+
+                    if(!file) {
+                        std::cerr << "\tFile at \"" << path << "\" is truncated." << std::endl;
+                        return false;
+                    }
+
+                    text << "\n";
+                    address += Machine::length(instruction.mode);
+                }
+
+                return true;
+            }
+
+            bool is_active() const noexcept {
+                return this->machine != nullptr;
+            }
+
+            std::uint64_t count_records() const noexcept {
+                return this->records;
+            }
+
+            /**
+             * @brief Counts the bytes written into the file, only up to date once stopped.
+             * @return The bytes.
+             */
+            std::uint64_t count_bytes() const noexcept {
+                return this->bytes;
+            }
+
+        private:
+            friend class Verifier;
+
+            /**
+             * @brief First bytes of a trace, followed by AR, XR, YR, SR, SP, IP and the cycles (little endian).
+             */
+            static constexpr std::uint8_t magic[8] = { 'R', 'H', 'E', 'A', 'T', 'R', 'C', 0x01 };
+
+            /**
+             * @brief Length of the instruction of each opcode, to know where the next one is expected.
+             */
+            std::array<std::uint8_t, 0x100> lengths;
+
+            /**
+             * @brief Machine being traced, null if none is.
+             */
+            Machine * machine;
+
+            /**
+             * @brief Writes through the bus of the machine since the last record.
+             */
+            std::vector<std::pair<std::uint16_t, std::uint8_t>> writes;
+
+            /**
+             * @brief Records waiting to be pushed into the ring, so it's only touched once every few hundreds.
+             */
+            std::array<Record, 0x100> pending;
+            std::size_t pending_size;
+
+            /**
+             * @brief Ring between the machine and the background thread.
+             */
+            Ring<Record> ring;
+
+            /**
+             * @brief Background thread encoding the ring into the file.
+             */
+            std::thread writer;
+            std::atomic<bool> is_stopping;
+            std::ofstream file;
+
+            /**
+             * @brief State the next record is encoded against, only touched by the background thread once started:
+             *        registers, expected IP and the last write address.
+             */
+            std::array<std::uint8_t, 5> registers;
+            std::uint16_t expected;
+            std::uint16_t last_write;
+
+            /**
+             * @brief Records captured and bytes written since the trace started.
+             */
+            std::uint64_t records;
+            std::uint64_t bytes;
+
+            /**
+             * @brief Pushes the pending records into the ring, waiting for the background thread if it's full.
+             */
+            void flush() noexcept {
+                while(!this->ring.push(this->pending.data(), this->pending_size)) {
+                    std::this_thread::yield();
+                }
+
+                this->pending_size = 0;
+            }
+
+            /**
+             * @brief Encodes records against the previous ones.
+             * @param records The records.
+             * @param count The number of records.
+             * @param output Where to write them, at least 32 bytes per record.
+             * @return The number of bytes written.
+             */
+            std::size_t encode(const Record * records, const std::size_t count, std::uint8_t * output) noexcept {
+                std::uint8_t * start = output;
+
+                for(std::size_t index = 0; index < count; index++) {
+                    const Record & record = records[index];
+                    std::uint8_t & fields = *output = 0;
+
+                    output[1] = record.opcode;
+                    output += 2;
+
+                    if(record.address != this->expected) {
+                        fields |= Field::Jump;
+                        output = encode_varint(output, zigzag(record.address - this->expected));
+                    }
+
+                    for(std::uint8_t register_index = 0; register_index < 5; register_index++) {
+                        if(record.registers[register_index] != this->registers[register_index]) {
+                            fields |= 1 << register_index;
+                            *output++ = record.registers[register_index];
+                        }
+                    }
+
+                    if(record.penalty != 0) {
+                        fields |= Field::Penalty;
+                        *output++ = record.penalty;
+                    }
+
+                    if(record.count != 0) {
+                        fields |= Field::Writes;
+                        output = encode_varint(output, record.count);
+
+                        for(std::uint8_t write = 0; write < record.count; write++) {
+                            output = encode_varint(output, zigzag(record.write_addresses[write] - this->last_write));
+                            *output++ = record.write_values[write];
+                            this->last_write = record.write_addresses[write];
+                        }
+                    }
+
+                    this->registers = record.registers;
+                    this->expected = record.address + this->lengths[record.opcode];
+                }
+
+                return output - start;
+            }
+
+            /**
+             * @brief Maps a 16 bits difference to an unsigned value, small negative ones staying small.
+             * @param difference The difference, wrapped around.
+             * @return The mapped value.
+             */
+            static std::uint16_t zigzag(const std::uint16_t difference) noexcept {
+                return (difference << 1) ^ ((difference & 0x8000) ? 0xFFFF : 0x0000);
+            }
+
+            static std::uint16_t unzigzag(const std::uint64_t value) noexcept {
+                return (value >> 1) ^ ((value & 1) ? 0xFFFF : 0x0000);
+            }
+
+            /**
+             * @brief Writes a varint: 7 bits per byte, the high bit set on all but the last one.
+             * @param output Where to write it.
+             * @param value The value.
+             * @return The position past the varint.
+             */
+            static std::uint8_t * encode_varint(std::uint8_t * output, std::uint64_t value) noexcept {
+                while(value >= 0x80) {
+                    *output++ = (value & 0x7F) | 0x80;
+                    value >>= 7;
+                }
+
+                *output++ = value;
+
+                return output;
+            }
+
+            static std::uint64_t decode_varint(std::ifstream & file) {
+                std::uint64_t value = 0;
+                int byte;
+
+                for(std::uint8_t shift = 0; (byte = file.get()) != EOF && shift < 64; shift += 7) {
+                    value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+
+                    if(!(byte & 0x80)) {
+                        break;
+                    }
+                }
+
+                return value;
+            }
+    };
+
+    inline std::uint64_t Machine::run(const std::uint64_t max_cycles, Tracer & tracer) noexcept {
+        std::uint64_t limit = this->cycles + max_cycles, executed = 0;
+
+        while(this->cycles < limit) {
+            std::uint64_t start = this->cycles;
+
+            if(this->cycles >= this->next_event) { // The cycles and pushes of an interrupt go with the first instruction of its handler.
+                this->dispatch_events();
+            }
+
+            std::uint16_t address = this->i_pointer;
+            std::uint8_t opcode = this->memory.fetch(address);
+
+            switch(opcode) {
+                #define X(opcode, mnemonic, handler, mode, timing) \
+                    case opcode: \
+                        this->i_pointer++; \
+                        this->penalty = 0; \
+                        this->execute_##handler<Mode::mode>(); \
+                        this->cycles += timing + this->penalty; \
+                        break;
+                __RHEA_INSTRUCTIONS__(X)
+                #undef X
+
+                default:
+                    return this->meter(executed, this->cycles + max_cycles - limit);
+            }
+
+            tracer.record(address, opcode, this->cycles - start - instructions[opcode].cycles, { this->a_register, this->x_register, this->y_register, this->s_register, this->s_pointer });
+            executed++;
+        }
+
+        return this->meter(executed, this->cycles + max_cycles - limit);
+    }
+
+    class Verifier {
+        public:
+            /**
+             * @brief Where the check is at.
+             */
+            enum class Status : std::uint8_t {
+                Idle,      // Not started.
+                Matching,  // Every instruction so far matched the trace.
+                Diverged,  // The machine diverged from the trace, see the divergence.
+                Finished,  // Every instruction of the trace matched.
+                Malformed  // The trace is truncated or not a trace.
+            };
+
+            /**
+             * @brief Largest encoded record: fields, opcode, jump, registers, penalty, count and the writes.
+             */
+            static constexpr std::size_t max_record = 2 + 3 + 5 + 1 + 1 + Tracer::Record::capacity * 4;
+
+            /**
+             * @brief Constructor.
+             */
+            Verifier() : buffer((1 << 16) + max_record) {
+                this->machine = nullptr;
+                this->status = Status::Idle;
+                this->checked = 0;
+            }
+
+            /**
+             * @brief Starts checking the instructions a machine executes against a trace recorded by the Tracer. The
+             *        trace is streamed through a fixed buffer, so its size doesn't matter. The registers and IP in its
+             *        header are checked right away; the cycles are checked from those of the machine on, as loading
+             *        a ROM doesn't clear them.
+             * @param path The path to the trace.
+             * @param machine The machine, it has to be in the state the trace starts from.
+             * @return If the operation was successful, a mismatching header still starts it as diverged.
+             */
+            bool start(const std::string path, Machine & machine) {
+                std::uint8_t header[sizeof(Tracer::magic) + 15];
+
+                this->file = std::ifstream(path, std::ios::binary);
+
+                if(!this->file.is_open()) {
+                    std::cerr << "\tFile at \"" << path << "\" not found." << std::endl;
+                    return false;
+                }
+
+                if(!this->file.read(reinterpret_cast<char *> (header), sizeof(header)) || std::memcmp(header, Tracer::magic, sizeof(Tracer::magic)) != 0) {
+                    std::cerr << "\tFile at \"" << path << "\" is not a trace." << std::endl;
+                    return false;
+                }
+
+                this->machine = &machine;
+                this->status = Status::Matching;
+                this->checked = 0;
+                this->position = 0;
+                this->size = 0;
+                this->last_write = 0x0000;
+                this->cycles = machine.reference_cycles();
+                std::memcpy(this->registers.data(), &header[sizeof(Tracer::magic)], 5);
+                this->expected = header[sizeof(Tracer::magic) + 5] | (header[sizeof(Tracer::magic) + 6] << 8);
+                this->expected_block = pack(this->expected, 0x00, this->registers);
+                this->writes.clear();
+                this->expected_writes.clear();
+                machine.reference_memory().set_tracing(&this->writes);
+
+                if(!this->compare(this->expected, 0x00, machine.reference_cycles(), {
+                    machine.reference_a_register(), machine.reference_x_register(), machine.reference_y_register(),
+                    machine.reference_s_register(), machine.reference_s_pointer()
+                })) {
+                    this->status = Status::Diverged;
+                }
+
+                return true;
+            }
+
+            /**
+             * @brief Stops checking, the status and the divergence are kept.
+             */
+            void stop() {
+                this->file.close();
+                this->machine->reference_memory().set_tracing(nullptr);
+                this->machine = nullptr;
+            }
+
+            /**
+             * @brief Checks an executed instruction against the next one of the trace.
+             * @param address The address of the instruction.
+             * @param opcode The opcode.
+             * @param cycles The cycles of the machine after the instruction.
+             * @param registers AR, XR, YR, SR and SP after the instruction.
+             * @return Whether or not the machine can go on: it matched and the trace has more instructions.
+             */
+            bool check(const std::uint16_t address, const std::uint8_t opcode, const std::uint64_t cycles, const std::array<std::uint8_t, 5> registers) noexcept {
+                if(this->status != Status::Matching) {
+                    return false;
+                }
+
+                if(!this->next()) {
+                    this->status = Status::Malformed;
+                    return false;
+                }
+
+                if(!this->compare(address, opcode, cycles, registers)) {
+                    this->status = Status::Diverged;
+                    return false;
+                }
+
+                this->checked++;
+                this->writes.clear();
+
+                if(this->position == this->size && !this->refill()) {
+                    this->status = Status::Finished;
+                    return false;
+                }
+
+                return true;
+            }
+
+            /**
+             * @brief Prints what differs at the divergence: the registers and pointers, the cycles, and the bytes the
+             *        trace or the machine wrote that don't match.
+             * @param output Where to print it, a line per difference.
+             */
+            void report(std::ostream & output) const {
+                static constexpr const char * names[5] = { "AR", "XR", "YR", "SR", "SP" };
+                std::uint64_t difference = this->actual_block ^ this->expected_block;
+
+                for(std::uint8_t index = 0; index < 5; index++) {
+                    if((difference >> (index * 8)) & 0xFF) {
+                        output << "\t\t" << names[index] << ": expected \"" << format_hex((this->expected_block >> (index * 8)) & 0xFF, 2) << "\", got \"" << format_hex((this->actual_block >> (index * 8)) & 0xFF, 2) << "\"." << std::endl;
+                    }
+                }
+
+                if((difference >> 40) & 0xFFFF) {
+                    output << "\t\tIP: expected \"" << format_hex((this->expected_block >> 40) & 0xFFFF) << "\", got \"" << format_hex((this->actual_block >> 40) & 0xFFFF) << "\"." << std::endl;
+                }
+
+                if(difference >> 56) {
+                    output << "\t\tOpcode: expected \"" << format_hex(this->expected_block >> 56, 2) << "\", got \"" << format_hex(this->actual_block >> 56, 2) << "\"." << std::endl;
+                }
+
+                if(this->actual_cycles != this->cycles) {
+                    output << "\t\tCycles: expected " << this->cycles << ", got " << this->actual_cycles << "." << std::endl;
+                }
+
+                for(const std::pair<std::uint16_t, std::uint8_t> & write : this->expected_writes) {
+                    std::vector<std::pair<std::uint16_t, std::uint8_t>>::const_reverse_iterator actual = std::find_if(this->writes.rbegin(), this->writes.rend(), [&](const std::pair<std::uint16_t, std::uint8_t> & other) {
+                        return other.first == write.first;
+                    });
+
+                    if(actual == this->writes.rend()) {
+                        output << "\t\t[" << format_hex(write.first) << "]: expected \"" << format_hex(write.second, 2) << "\", not written." << std::endl;
+                    } else if(actual->second != write.second) {
+                        output << "\t\t[" << format_hex(write.first) << "]: expected \"" << format_hex(write.second, 2) << "\", got \"" << format_hex(actual->second, 2) << "\"." << std::endl;
+                    }
+                }
+
+                for(const std::pair<std::uint16_t, std::uint8_t> & write : this->writes) {
+                    if(std::none_of(this->expected_writes.begin(), this->expected_writes.end(), [&](const std::pair<std::uint16_t, std::uint8_t> & other) { return other.first == write.first; })) {
+                        output << "\t\t[" << format_hex(write.first) << "]: not expected, got \"" << format_hex(write.second, 2) << "\"." << std::endl;
+                    }
+                }
+            }
+
+            bool is_active() const noexcept {
+                return this->machine != nullptr;
+            }
+
+            Status get_status() const noexcept {
+                return this->status;
+            }
+
+            /**
+             * @brief Counts the instructions that matched the trace since it started.
+             * @return The instructions.
+             */
+            std::uint64_t count_checked() const noexcept {
+                return this->checked;
+            }
+
+            /**
+             * @brief Gets the address the trace expected at the divergence.
+             * @return The address.
+             */
+            std::uint16_t get_expected_address() const noexcept {
+                return (this->expected_block >> 40) & 0xFFFF;
+            }
+
+        private:
+            /**
+             * @brief Machine being checked, null if none is.
+             */
+            Machine * machine;
+
+            Status status;
+            std::uint64_t checked;
+
+            /**
+             * @brief The trace, and the window of it in the buffer. The buffer has room for one more record past the
+             *        window, so a truncated record is read from zeros instead of past the end.
+             */
+            std::ifstream file;
+            std::vector<std::uint8_t> buffer;
+            std::size_t position;
+            std::size_t size;
+
+            /**
+             * @brief State of the last decoded record: registers, cycles, the address of the next instruction and the
+             *        last write address; as in the Tracer.
+             */
+            std::array<std::uint8_t, 5> registers;
+            std::uint64_t cycles;
+            std::uint16_t expected;
+            std::uint16_t last_write;
+
+            /**
+             * @brief Writes through the bus of the machine since the last check, and the ones of the trace.
+             */
+            std::vector<std::pair<std::uint16_t, std::uint8_t>> writes;
+            std::vector<std::pair<std::uint16_t, std::uint8_t>> expected_writes;
+
+            /**
+             * @brief Registers, pointers and opcode of the trace and of the machine at the last comparison, packed
+             *        into one word each (AR, XR, YR, SR, SP, IP and the opcode from the low byte up) so they're
+             *        compared at once.
+             */
+            std::uint64_t expected_block;
+            std::uint64_t actual_block;
+            std::uint64_t actual_cycles;
+
+            /**
+             * @brief Packs the registers, an address and an opcode into one word.
+             * @param address The address.
+             * @param opcode The opcode.
+             * @param registers AR, XR, YR, SR and SP.
+             * @return The word.
+             */
+            static std::uint64_t pack(const std::uint16_t address, const std::uint8_t opcode, const std::array<std::uint8_t, 5> & registers) noexcept {
+                std::uint64_t block = 0;
+
+                std::memcpy(&block, registers.data(), 5);
+
+                return block | (static_cast<std::uint64_t> (address) << 40) | (static_cast<std::uint64_t> (opcode) << 56);
+            }
+
+            /**
+             * @brief Compares the machine against the last decoded record.
+             * @param address The address of the instruction.
+             * @param opcode The opcode.
+             * @param cycles The cycles after the instruction.
+             * @param registers AR, XR, YR, SR and SP after the instruction.
+             * @return Whether or not they match.
+             */
+            bool compare(const std::uint16_t address, const std::uint8_t opcode, const std::uint64_t cycles, const std::array<std::uint8_t, 5> & registers) noexcept {
+                this->actual_block = pack(address, opcode, registers);
+                this->actual_cycles = cycles;
+
+                if(this->writes.size() > Tracer::Record::capacity) { // As many as the trace keeps.
+                    this->writes.resize(Tracer::Record::capacity);
+                }
+
+                return (this->actual_block ^ this->expected_block) == 0 && cycles == this->cycles && this->writes == this->expected_writes;
+            }
+
+            /**
+             * @brief Moves what's left of the window to the front of the buffer and reads after it.
+             * @return Whether or not there is something left to decode.
+             */
+            bool refill() {
+                std::size_t capacity = this->buffer.size() - max_record;
+
+                std::memmove(this->buffer.data(), &this->buffer[this->position], this->size - this->position);
+                this->size -= this->position;
+                this->position = 0;
+
+                if(this->file) {
+                    this->file.read(reinterpret_cast<char *> (&this->buffer[this->size]), capacity - this->size);
+                    this->size += this->file.gcount();
+                }
+
+                std::fill(&this->buffer[this->size], &this->buffer[this->size] + max_record, 0x00);
+
+                return this->size > 0;
+            }
+
+            /**
+             * @brief Decodes the next record of the trace into the expected state.
+             * @return Whether or not there was a whole record.
+             */
+            bool next() {
+                if(this->size - this->position < max_record) {
+                    this->refill();
+                }
+
+                const std::uint8_t * cursor = &this->buffer[this->position];
+                const std::uint8_t * end = &this->buffer[this->size];
+                std::uint32_t value;
+
+                if(cursor == end) {
+                    return false;
+                }
+
+                std::uint8_t fields = cursor[0], opcode = cursor[1];
+
+                cursor += 2;
+                this->expected_writes.clear();
+
+                if(fields & Tracer::Field::Jump) {
+                    cursor = read_varint(cursor, value);
+                    this->expected += Tracer::unzigzag(value);
+                }
+
+                for(std::uint8_t index = 0; index < 5; index++) {
+                    if(fields & (1 << index)) {
+                        this->registers[index] = *cursor++;
+                    }
+                }
+
+                this->cycles += Machine::instructions[opcode].cycles;
+
+                if(fields & Tracer::Field::Penalty) {
+                    this->cycles += *cursor++;
+                }
+
+                if(fields & Tracer::Field::Writes) {
+                    cursor = read_varint(cursor, value);
+
+                    if(cursor == nullptr || value > Tracer::Record::capacity) {
+                        return false;
+                    }
+
+                    for(std::uint32_t write = 0; write < value && cursor != nullptr; write++) {
+                        std::uint32_t difference;
+
+                        cursor = read_varint(cursor, difference);
+                        this->last_write += Tracer::unzigzag(difference);
+
+                        if(cursor != nullptr) {
+                            this->expected_writes.push_back({ this->last_write, *cursor++ });
+                        }
+                    }
+                }
+
+                if(cursor == nullptr || cursor > end) {
+                    return false;
+                }
+
+                this->expected_block = pack(this->expected, opcode, this->registers);
+                this->expected += Machine::length(Machine::instructions[opcode].mode);
+                this->position = cursor - this->buffer.data();
+
+                return true;
+            }
+
+            /**
+             * @brief Reads a varint of the trace, which never takes more than 3 bytes.
+             * @param cursor Where it starts.
+             * @param value Where to store it.
+             * @return The position past the varint, null if it's longer.
+             */
+            static const std::uint8_t * read_varint(const std::uint8_t * cursor, std::uint32_t & value) noexcept {
+                value = 0;
+
+                for(std::uint8_t shift = 0; shift < 21; shift += 7) {
+                    std::uint8_t byte = *cursor++;
+
+                    value |= static_cast<std::uint32_t> (byte & 0x7F) << shift;
+
+                    if(!(byte & 0x80)) {
+                        return cursor;
+                    }
+                }
+
+                return nullptr;
+            }
+    };
+
+    inline std::uint64_t Machine::run(const std::uint64_t max_cycles, Verifier & verifier) noexcept {
+        std::uint64_t limit = this->cycles + max_cycles, executed = 0;
+
+        while(this->cycles < limit) {
+            if(this->cycles >= this->next_event) {
+                this->dispatch_events();
+            }
+
+            std::uint16_t address = this->i_pointer;
+            std::uint8_t opcode = this->memory.fetch(address);
+
+            switch(opcode) {
+                #define X(opcode, mnemonic, handler, mode, timing) \
+                    case opcode: \
+                        this->i_pointer++; \
+                        this->penalty = 0; \
+                        this->execute_##handler<Mode::mode>(); \
+                        this->cycles += timing + this->penalty; \
+                        break;
+                __RHEA_INSTRUCTIONS__(X)
+                #undef X
+
+                default:
+                    return this->meter(executed, this->cycles + max_cycles - limit);
+            }
+
+            executed++;
+
+            if(!verifier.check(address, opcode, this->cycles, { this->a_register, this->x_register, this->y_register, this->s_register, this->s_pointer })) {
+                break;
+            }
+        }
+
+        return this->meter(executed, this->cycles + max_cycles - limit);
+    }
+
+    #if __RHEA_PROFILER__
+        class Profiler {
+            public:
+                /**
+                 * @brief Deepest call the call graph follows, deeper calls are counted in their caller. Keeps the graph
+                 *        bounded when code leaves subroutines without RTS.
+                 */
+                static constexpr std::uint32_t max_depth = 0x100;
+
+                /**
+                 * @brief Constructor.
+                 */
+                Profiler() {
+                    this->is_profiling = false;
+                    this->clear(0x8000);
+                }
+
+                /**
+                 * @brief Starts counting the instructions of the next runs, on top of what was already counted.
+                 * @param machine The machine, names the root of the call graph if nothing was counted yet.
+                 */
+                void start(Machine & machine) {
+                    if(this->instructions == 0) {
+                        this->clear(machine.reference_i_pointer());
+                    }
+
+                    this->is_profiling = true;
+                }
+
+                /**
+                 * @brief Stops counting, the counts are kept.
+                 */
+                void stop() noexcept {
+                    this->is_profiling = false;
+                }
+
+                /**
+                 * @brief Drops every count.
+                 * @param root The address naming the root of the call graph.
+                 */
+                void clear(const std::uint16_t root) {
+                    this->opcode_counts.fill(0);
+                    this->opcode_cycles.fill(0);
+                    this->address_counts.assign(0x10000, 0);
+                    this->address_cycles.assign(0x10000, 0);
+                    this->nodes.assign(1, Node { root, 0, 0, 0 });
+                    this->children.clear();
+                    this->current = 0;
+                    this->depth = 0;
+                    this->instructions = 0;
+                    this->cycles = 0;
+                }
+
+                /**
+                 * @brief Counts an executed instruction.
+                 * @param address The address of the instruction.
+                 * @param opcode The opcode.
+                 * @param cycles The cycles it took.
+                 * @param next The address IP points to after it.
+                 */
+                void record(const std::uint16_t address, const std::uint8_t opcode, const std::uint8_t cycles, const std::uint16_t next) {
+                    this->opcode_counts[opcode]++;
+                    this->opcode_cycles[opcode] += cycles;
+                    this->address_counts[address]++;
+                    this->address_cycles[address] += cycles;
+                    this->nodes[this->current].cycles += cycles;
+                    this->instructions++;
+                    this->cycles += cycles;
+
+                    if(opcode == 0x20) { // JSR enters the node of the subroutine under the current one.
+                        this->call(next);
+                    } else if((opcode == 0x60 || opcode == 0x40) && this->depth > 0) { // RTS and RTI go back to the caller.
+                        this->current = this->nodes[this->current].parent;
+                        this->depth--;
+                    }
+                }
+
+                /**
+                 * @brief Enters an interrupt handler, as if it was called from the current subroutine.
+                 * @param address The address of the handler.
+                 */
+                void enter(const std::uint16_t address) {
+                    this->call(address);
+                }
+
+                /**
+                 * @brief Gets the most executed opcodes.
+                 * @param count The maximum number of opcodes.
+                 * @return The opcodes with their cycles, the most cycles first.
+                 */
+                std::vector<std::pair<std::uint8_t, std::uint64_t>> get_hot_opcodes(const std::size_t count) const {
+                    std::vector<std::pair<std::uint8_t, std::uint64_t>> hot;
+
+                    for(std::uint16_t opcode = 0x00; opcode < 0x100; opcode++) {
+                        if(this->opcode_counts[opcode] > 0) {
+                            hot.push_back({ opcode, this->opcode_cycles[opcode] });
+                        }
+                    }
+
+                    return this->take_hottest(hot, count);
+                }
+
+                /**
+                 * @brief Gets the addresses where the most cycles were spent.
+                 * @param count The maximum number of addresses.
+                 * @return The addresses with their cycles, the most cycles first.
+                 */
+                std::vector<std::pair<std::uint16_t, std::uint64_t>> get_hot_addresses(const std::size_t count) const {
+                    std::vector<std::pair<std::uint16_t, std::uint64_t>> hot;
+
+                    for(std::uint32_t address = 0x0000; address <= 0xFFFF; address++) {
+                        if(this->address_cycles[address] > 0) {
+                            hot.push_back({ address, this->address_cycles[address] });
+                        }
+                    }
+
+                    return this->take_hottest(hot, count);
+                }
+
+                /**
+                 * @brief Gets the subroutines where the most cycles were spent, including the cycles of what they
+                 *        called. Recursive calls are only counted once.
+                 * @param count The maximum number of subroutines.
+                 * @return The addresses of the subroutines with their cycles, the most cycles first.
+                 */
+                std::vector<std::pair<std::uint16_t, std::uint64_t>> get_hot_subroutines(const std::size_t count) const {
+                    std::vector<std::uint64_t> totals = std::vector<std::uint64_t>(this->nodes.size(), 0);
+                    std::unordered_map<std::uint16_t, std::uint64_t> inclusive;
+                    std::vector<std::pair<std::uint16_t, std::uint64_t>> hot;
+
+                    for(std::size_t index = this->nodes.size() - 1; index > 0; index--) { // Children always come after their parent.
+                        totals[index] += this->nodes[index].cycles;
+                        totals[this->nodes[index].parent] += totals[index];
+                    }
+
+                    for(std::size_t index = 1; index < this->nodes.size(); index++) {
+                        bool is_recursive = false;
+
+                        for(std::uint32_t parent = this->nodes[index].parent; parent != 0 && !is_recursive; parent = this->nodes[parent].parent) {
+                            is_recursive = this->nodes[parent].address == this->nodes[index].address;
+                        }
+
+                        if(!is_recursive) {
+                            inclusive[this->nodes[index].address] += totals[index];
+                        }
+                    }
+
+                    hot.assign(inclusive.begin(), inclusive.end());
+
+                    return this->take_hottest(hot, count);
+                }
+
+                /**
+                 * @brief Writes the call graph as folded stacks, one line per call path with the cycles spent in it,
+                 *        the format flame graph tools read.
+                 * @param path The path to the file.
+                 * @return If the operation was successful.
+                 */
+                bool write_folded(const std::string path) const {
+                    std::ofstream file = std::ofstream(path);
+                    std::string line;
+
+                    if(!file.is_open()) {
+                        std::cerr << "\tFile at \"" << path << "\" not found." << std::endl;
+                        return false;
+                    }
+
+                    for(std::size_t index = 0; index < this->nodes.size(); index++) {
+                        if(this->nodes[index].cycles == 0) {
+                            continue;
+                        }
+
+                        line.clear();
+
+                        for(std::uint32_t node = index; ; node = this->nodes[node].parent) { // From the leaf up, prepending each caller.
+                            std::string name = format_hex(this->nodes[node].address);
+
+                            line.insert(line.begin(), name.begin(), name.end());
+
+                            if(node == 0) {
+                                break;
+                            }
+
+                            line.insert(line.begin(), ';');
+                        }
+
+                        file << line << " " << this->nodes[index].cycles << "\n";
+                    }
+
+                    return true;
+                }
+
+                bool is_active() const noexcept {
+                    return this->is_profiling;
+                }
+
+                std::uint64_t count_instructions() const noexcept {
+                    return this->instructions;
+                }
+
+                std::uint64_t count_cycles() const noexcept {
+                    return this->cycles;
+                }
+
+                std::uint64_t count_calls(const std::uint16_t address) const noexcept {
+                    std::uint64_t calls = 0;
+
+                    for(const Node & node : this->nodes) {
+                        calls += node.address == address ? node.calls : 0;
+                    }
+
+                    return calls;
+                }
+
+            private:
+                /**
+                 * @brief Node of the call graph, one per distinct path of calls.
+                 */
+                struct Node {
+                    std::uint16_t address; // Entry of the subroutine.
+                    std::uint32_t parent;  // Node of the caller.
+                    std::uint64_t calls;   // Times it was entered.
+                    std::uint64_t cycles;  // Cycles spent in it, not counting its callees.
+                };
+
+                /**
+                 * @brief Enters a subroutine from the current node.
+                 * @param address The entry of the subroutine.
+                 */
+                void call(const std::uint16_t address) {
+                    if(this->depth >= max_depth) {
+                        return;
+                    }
+
+                    std::uint64_t key = (static_cast<std::uint64_t>(this->current) << 16) | address;
+                    auto child = this->children.find(key);
+
+                    if(child == this->children.end()) {
+                        child = this->children.emplace(key, this->nodes.size()).first;
+                        this->nodes.push_back(Node { address, this->current, 0, 0 });
+                    }
+
+                    this->current = child->second;
+                    this->nodes[this->current].calls++;
+                    this->depth++;
+                }
+
+                /**
+                 * @brief Sorts entries by their cycles and keeps the first ones.
+                 * @param entries The entries.
+                 * @param count The number of entries to keep.
+                 * @return The kept entries.
+                 */
+                template<typename Key>
+                static std::vector<std::pair<Key, std::uint64_t>> take_hottest(std::vector<std::pair<Key, std::uint64_t>> & entries, const std::size_t count) {
+                    std::size_t kept = std::min(count, entries.size());
+
+                    std::partial_sort(entries.begin(), entries.begin() + kept, entries.end(), [](const auto & left, const auto & right) {
+                        return left.second > right.second || (left.second == right.second && left.first < right.first);
+                    });
+
+                    entries.resize(kept);
+
+                    return entries;
+                }
+
+                std::array<std::uint64_t, 0x100> opcode_counts;
+                std::array<std::uint64_t, 0x100> opcode_cycles;
+                std::vector<std::uint64_t> address_counts;
+                std::vector<std::uint64_t> address_cycles;
+                std::vector<Node> nodes;
+                std::unordered_map<std::uint64_t, std::uint32_t> children;
+                std::uint32_t current;
+                std::uint32_t depth;
+                std::uint64_t instructions;
+                std::uint64_t cycles;
+                bool is_profiling;
+        };
+
+        inline std::uint64_t Machine::run(const std::uint64_t max_cycles, Profiler & profiler) noexcept {
+            std::uint64_t limit = this->cycles + max_cycles, executed = 0;
+
+            while(this->cycles < limit) {
+                std::uint64_t start = this->cycles;
+
+                if(this->cycles >= this->next_event) {
+                    std::uint16_t interrupted = this->i_pointer;
+
+                    this->dispatch_events();
+
+                    if(this->cycles != start || this->i_pointer != interrupted) { // Handlers are callees of the interrupted code.
+                        profiler.enter(this->i_pointer);
+                    }
+                }
+
+                std::uint16_t address = this->i_pointer;
+                std::uint8_t opcode = this->memory.fetch(address);
+
+                switch(opcode) {
+                    #define X(opcode, mnemonic, handler, mode, timing) \
+                        case opcode: \
+                            this->i_pointer++; \
+                            this->penalty = 0; \
+                            this->execute_##handler<Mode::mode>(); \
+                            this->cycles += timing + this->penalty; \
+                            break;
+                    __RHEA_INSTRUCTIONS__(X)
+                    #undef X
+
+                    default:
+                        return this->meter(executed, this->cycles + max_cycles - limit);
+                }
+
+                profiler.record(address, opcode, this->cycles - start, this->i_pointer);
+                executed++;
+            }
+
+            return this->meter(executed, this->cycles + max_cycles - limit);
+        }
+    #else
+        /**
+         * @brief Stands in for the profiler when it isn't built, it's never active.
+         */
+        class Profiler {
+            public:
+                static constexpr bool is_active() noexcept {
+                    return false;
+                }
+        };
+
+        inline std::uint64_t Machine::run(const std::uint64_t max_cycles, Profiler &) noexcept {
+            return this->run(max_cycles);
+        }
+    #endif
+
+    class Journal {
+        public:
+            /**
+             * @brief Kinds of the records, each one byte followed by its cycle as a varint difference with the previous
+             *        record (checkpoints hold the whole cycle instead, and are what the next one is relative to).
+             */
+            enum Kind : std::uint8_t {
+                Read = 0x01,       // Address (little endian) and the byte a device returned.
+                Interrupt = 0x02,  // IRQ lines and whether they're asserted.
+                Nmi = 0x03,        // Nothing else.
+                Checkpoint = 0x04, // Cycle (8 bytes), varint size and text of the command that changed the machine (none for the periodic ones), size (4 bytes) and the state.
+                End = 0x05         // Nothing else, the recording stopped.
+            };
+
+            /**
+             * @brief Constructor.
+             */
+            Journal() noexcept {
+                this->machine = nullptr;
+                this->period = 0;
+                this->generation = 0;
+                this->is_paused = false;
+                this->touched = 0;
+                this->paused_state = 0;
+                this->last_cycle = 0;
+                this->inputs = 0;
+                this->checkpoints = 0;
+                this->bytes = 0;
+            }
+
+            /**
+             * @brief Destructor.
+             */
+            ~Journal() noexcept {
+                if(this->is_active()) {
+                    this->stop();
+                }
+            }
+
+            /**
+             * @brief Starts recording the inputs of a machine into an append-only file: the bytes its devices return
+             *        and the interrupt requests, keyed by cycle, between checkpoints of its whole state. The offsets of
+             *        the checkpoints also go into an index next to it ("<path>.index"), to seek without reading all.
+             * @param path The path to the file.
+             * @param machine The machine, its devices are wrapped until stopped.
+             * @param period Cycles between two checkpoints.
+             * @return If the operation was successful.
+             */
+            bool start(const std::string path, Machine & machine, const std::uint64_t period) {
+                this->file = std::ofstream(path, std::ios::binary);
+                this->index = std::ofstream(path + ".index", std::ios::binary);
+
+                if(!this->file.is_open() || !this->index.is_open()) {
+                    std::cerr << "\tFile at \"" << (this->file.is_open() ? path + ".index" : path) << "\" not found." << std::endl;
+                    this->file.close();
+                    this->index.close();
+                    return false;
+                }
+
+                this->file.write(reinterpret_cast<const char *> (magic), sizeof(magic));
+                this->index.write(reinterpret_cast<const char *> (index_magic), sizeof(index_magic));
+                this->machine = &machine;
+                this->period = std::max<std::uint64_t>(period, 1);
+                this->is_paused = false;
+                this->inputs = 0;
+                this->checkpoints = 0;
+                this->bytes = sizeof(magic);
+                this->buffer.clear();
+                this->wrap();
+                machine.set_journal(this);
+                this->checkpoint("");
+                this->arm();
+
+                return true;
+            }
+
+            /**
+             * @brief Stops recording, writing where it stopped and giving the machine its devices back.
+             */
+            void stop() {
+                this->append_record(Kind::End);
+                this->flush();
+                this->generation++; // The pending checkpoint does nothing now.
+
+                for(std::uint16_t page = 0x00; page < 0x100; page++) {
+                    std::shared_ptr<Recorded> recorded = std::dynamic_pointer_cast<Recorded>(this->machine->reference_memory().get_device(page));
+
+                    if(recorded != nullptr) {
+                        this->machine->reference_memory().attach(page, page, recorded->device);
+                    }
+                }
+
+                this->machine->set_journal(nullptr);
+                this->machine = nullptr;
+                this->file.close();
+                this->index.close();
+            }
+
+            /**
+             * @brief Stops recording inputs while something outside of the execution changes the machine (a command),
+             *        until Journal::resume.
+             */
+            void pause() {
+                this->is_paused = true;
+                this->touched = 0;
+                this->paused_state = fingerprint(*this->machine);
+            }
+
+            /**
+             * @brief Resumes recording after Journal::pause. If the machine changed meanwhile, or its devices were
+             *        touched, a checkpoint replaces whatever was done, so a replay never needs to repeat it.
+             * @param command What changed the machine, kept with the checkpoint.
+             */
+            void resume(const std::string_view command) {
+                this->is_paused = false;
+                this->wrap(); // Devices attached meanwhile.
+
+                if(this->touched > 0 || fingerprint(*this->machine) != this->paused_state) {
+                    this->checkpoint(command);
+                }
+
+                this->arm(); // The schedule may have been cleared or the cycles moved.
+            }
+
+            /**
+             * @brief Records a byte returned by a device.
+             * @param address The address.
+             * @param value The byte.
+             */
+            void record_read(const std::uint16_t address, const std::uint8_t value) {
+                if(this->is_paused) {
+                    this->touched++;
+                    return;
+                }
+
+                this->append_record(Kind::Read);
+                this->inputs++;
+                this->buffer.insert(this->buffer.end(), { static_cast<std::uint8_t>(address & 0xFF), static_cast<std::uint8_t>(address >> 8), value });
+                this->flush_if_full();
+            }
+
+            /**
+             * @brief Records an interrupt request, if it's for the recorded machine (copies keep the journal).
+             * @param machine The machine requesting it.
+             * @param lines The IRQ lines.
+             * @param is_asserted Whether the lines are asserted or released.
+             * @param is_nmi Whether it's an NMI instead, without lines.
+             */
+            void record_interrupt(const Machine & machine, const std::uint8_t lines, const bool is_asserted, const bool is_nmi) {
+                if(&machine != this->machine) {
+                    return;
+                }
+
+                if(this->is_paused) {
+                    this->touched++;
+                    return;
+                }
+
+                this->append_record(is_nmi ? Kind::Nmi : Kind::Interrupt);
+                this->inputs++;
+
+                if(!is_nmi) {
+                    this->buffer.insert(this->buffer.end(), { lines, static_cast<std::uint8_t>(is_asserted) });
+                }
+
+                this->flush_if_full();
+            }
+
+            /**
+             * @brief Brings a machine to a cycle of a recording: loads the last checkpoint at or before it, then runs
+             *        from there feeding the recorded inputs, so the time taken depends on the distance from that
+             *        checkpoint only. The machine needs the devices it had when recording, at the same pages; its
+             *        timers are dropped, the interrupts they requested come from the journal.
+             * @param path The path to the file.
+             * @param machine The machine.
+             * @param cycle The cycle, reached after the inputs at it. Past the end of the recording, its end.
+             * @param start The cycle of the checkpoint the replay started from.
+             * @param inputs The number of inputs fed.
+             * @return If the operation was successful, false if the machine diverged from the recording.
+             */
+            static bool replay(const std::string path, Machine & machine, std::uint64_t cycle, std::uint64_t & start, std::uint64_t & inputs) {
+                std::vector<std::pair<std::uint64_t, std::uint64_t>> offsets;
+                Replay replay = Replay();
+                Entry entry;
+
+                if(!load_index(path, offsets)) {
+                    return false;
+                }
+
+                auto checkpoint = std::find_if(offsets.rbegin(), offsets.rend(), [cycle](const std::pair<std::uint64_t, std::uint64_t> & offset) { return offset.first <= cycle; });
+
+                if(checkpoint == offsets.rend()) {
+                    std::cerr << "\tThe journal at \"" << path << "\" has no checkpoint at or before cycle " << cycle << "." << std::endl;
+                    return false;
+                }
+
+                if(!replay.reader.open(path, checkpoint->second) || !replay.reader.next(entry) || entry.kind != Kind::Checkpoint) {
+                    std::cerr << "\tFile at \"" << path << "\" is truncated or malformed." << std::endl;
+                    return false;
+                }
+
+                if(!machine.decode_state(entry.state, "The checkpoint at cycle " + std::to_string(entry.cycle) + " of \"" + path + "\"")) {
+                    return false;
+                }
+
+                start = entry.cycle;
+                inputs = 0;
+                replay.machine = &machine;
+                machine.clear_schedule();
+
+                std::vector<std::pair<std::uint8_t, std::shared_ptr<Device>>> devices = wrap_replayed(machine, replay);
+                bool is_exhausted = false, is_successful = true;
+
+                while(!replay.is_diverged) {
+                    while(!is_exhausted && replay.pending.size() < replay_capacity) { // Reads are taken by the devices, the rest by this loop.
+                        if(!replay.reader.next(entry)) {
+                            is_successful = !replay.reader.is_malformed();
+                            is_exhausted = true;
+                        } else if(entry.kind == Kind::End) {
+                            cycle = std::min(cycle, entry.cycle);
+                            is_exhausted = true;
+                        } else {
+                            replay.pending.push_back(std::move(entry));
+                        }
+                    }
+
+                    if(!replay.pending.empty() && replay.pending.front().kind == Kind::Read && replay.pending.front().cycle < machine.reference_cycles()) { // Went past it without reading it.
+                        replay.is_diverged = true;
+                        replay.diverged_cycle = replay.pending.front().cycle;
+                        replay.diverged_address = replay.pending.front().address;
+                        break;
+                    }
+
+                    if(!replay.pending.empty() && replay.pending.front().kind != Kind::Read && replay.pending.front().cycle <= machine.reference_cycles()) {
+                        Entry & input = replay.pending.front();
+
+                        if(input.kind == Kind::Interrupt) {
+                            machine.set_irq(input.value, input.address != 0);
+                        } else if(input.kind == Kind::Nmi) {
+                            machine.trigger_nmi();
+                        } else if(input.address != 0 && !machine.decode_state(input.state, "The checkpoint at cycle " + std::to_string(input.cycle) + " of \"" + path + "\"")) {
+                            is_successful = false;
+                            break;
+                        }
+
+                        replay.pending.pop_front();
+                        inputs++;
+                        continue;
+                    }
+
+                    if(machine.reference_cycles() >= cycle || machine.is_halted()) {
+                        break;
+                    }
+
+                    auto event = std::find_if(replay.pending.begin(), replay.pending.end(), [](const Entry & pending) { return pending.kind != Kind::Read; });
+                    std::uint64_t limit = cycle;
+
+                    if(event != replay.pending.end()) { // Runs stop at the first instruction boundary at or past their limit, where the input was recorded.
+                        limit = std::min(limit, event->cycle);
+                    } else if(!is_exhausted && !replay.pending.empty()) { // Not past the buffered reads.
+                        limit = std::min(limit, replay.pending.back().cycle);
+                    }
+
+                    std::uint64_t before = machine.reference_cycles();
+
+                    if(limit > before) {
+                        machine.run(limit - before);
+                    }
+
+                    if(machine.reference_cycles() == before && machine.step() == 0) { // Also past the breakpoints, which stop the runs.
+                        break;
+                    }
+                }
+
+                for(const std::pair<std::uint8_t, std::shared_ptr<Device>> & device : devices) {
+                    machine.reference_memory().attach(device.first, device.first, device.second);
+                }
+
+                inputs += replay.reads;
+
+                if(replay.is_diverged) {
+                    std::cerr << "\tThe machine diverged from the journal at cycle " << replay.diverged_cycle << ", on the read of the \"" << format_hex(replay.diverged_address) << "\" address." << std::endl;
+                    return false;
+                }
+
+                if(!is_successful) {
+                    std::cerr << "\tFile at \"" << path << "\" is truncated or malformed." << std::endl;
+                    return false;
+                }
+
+                return true;
+            }
+
+            bool is_active() const noexcept {
+                return this->machine != nullptr;
+            }
+
+            std::uint64_t count_inputs() const noexcept {
+                return this->inputs;
+            }
+
+            std::uint64_t count_checkpoints() const noexcept {
+                return this->checkpoints;
+            }
+
+            /**
+             * @brief Counts the bytes written into the file, up to date once stopped.
+             * @return The bytes.
+             */
+            std::uint64_t count_bytes() const noexcept {
+                return this->bytes + this->buffer.size();
+            }
+
+        private:
+            /**
+             * @brief First bytes of a journal and of its index, whose entries are the cycle and the offset of each
+             *        checkpoint (8 bytes each, little endian).
+             */
+            static constexpr std::uint8_t magic[8] = { 'R', 'H', 'E', 'A', 'J', 'R', 'N', 0x01 };
+            static constexpr std::uint8_t index_magic[8] = { 'R', 'H', 'E', 'A', 'J', 'I', 'X', 0x01 };
+
+            /**
+             * @brief Bytes buffered before they're written into the file.
+             */
+            static constexpr std::size_t buffer_capacity = 0x10000;
+
+            /**
+             * @brief Records read ahead while replaying.
+             */
+            static constexpr std::size_t replay_capacity = 0x1000;
+
+            /**
+             * @brief Record as read back from a journal.
+             */
+            struct Entry {
+                Kind kind;
+                std::uint64_t cycle;
+                std::uint16_t address; // Read: the address. Interrupt: whether the lines are asserted. Checkpoint: whether a command made it.
+                std::uint8_t value;    // Read: the byte. Interrupt: the lines.
+                std::vector<std::uint8_t> state;
+            };
+
+            /**
+             * @brief Reads the records of a journal through a buffer.
+             */
+            class Reader {
+                public:
+                    /**
+                     * @brief Opens a journal.
+                     * @param path The path to the file.
+                     * @param offset Where the first record to read is, past the magic.
+                     * @return If the operation was successful.
+                     */
+                    bool open(const std::string path, const std::uint64_t offset) {
+                        std::uint8_t header[sizeof(magic)];
+
+                        this->file = std::ifstream(path, std::ios::binary);
+
+                        if(!this->file.is_open() || !this->file.read(reinterpret_cast<char *> (header), sizeof(header)) || std::memcmp(header, magic, sizeof(magic)) != 0 || offset < sizeof(magic)) {
+                            return false;
+                        }
+
+                        this->file.seekg(offset);
+                        this->buffer.clear();
+                        this->position = 0;
+                        this->offset = offset;
+                        this->cycle = 0;
+                        this->is_truncated = false;
+
+                        return true;
+                    }
+
+                    /**
+                     * @brief Reads the next record.
+                     * @param entry The record.
+                     * @return Whether or not there was a whole one, see Reader::is_malformed for why there wasn't.
+                     */
+                    bool next(Entry & entry) {
+                        std::uint8_t bytes[8];
+                        std::uint64_t value;
+
+                        if(!this->take(bytes, 1)) {
+                            this->is_truncated = false; // Ends between records.
+                            return false;
+                        }
+
+                        entry.kind = static_cast<Kind>(bytes[0]);
+
+                        if(entry.kind == Kind::Checkpoint) {
+                            if(!this->take(bytes, 8)) {
+                                return false;
+                            }
+
+                            entry.cycle = this->cycle = read_le(bytes, 8);
+
+                            if(!this->take_varint(value) || !this->skip(value) || !this->take(bytes, 4)) {
+                                return false;
+                            }
+
+                            entry.address = value != 0; // Whether a command made it, the periodic ones aren't needed to replay.
+                            entry.state.resize(read_le(bytes, 4));
+
+                            return this->take(entry.state.data(), entry.state.size());
+                        }
+
+                        if(entry.kind < Kind::Read || entry.kind > Kind::End || !this->take_varint(value)) {
+                            this->is_truncated = true;
+                            return false;
+                        }
+
+                        entry.cycle = this->cycle += value;
+
+                        if(entry.kind == Kind::Read) {
+                            if(!this->take(bytes, 3)) {
+                                return false;
+                            }
+
+                            entry.address = bytes[0] | (bytes[1] << 8);
+                            entry.value = bytes[2];
+                        } else if(entry.kind == Kind::Interrupt) {
+                            if(!this->take(bytes, 2)) {
+                                return false;
+                            }
+
+                            entry.value = bytes[0];
+                            entry.address = bytes[1];
+                        }
+
+                        return true;
+                    }
+
+                    /**
+                     * @brief Checks if the last Reader::next failed inside of a record instead of at the end.
+                     * @return Whether or not the journal is truncated or malformed.
+                     */
+                    bool is_malformed() const noexcept {
+                        return this->is_truncated;
+                    }
+
+                    /**
+                     * @brief Gets where the next record is in the file.
+                     * @return The offset.
+                     */
+                    std::uint64_t tell() const noexcept {
+                        return this->offset;
+                    }
+
+                private:
+                    std::ifstream file;
+                    std::vector<std::uint8_t> buffer;
+                    std::size_t position;
+                    std::uint64_t offset;
+                    std::uint64_t cycle;
+                    bool is_truncated;
+
+                    /**
+                     * @brief Takes bytes, reading more of the file when the buffer runs out.
+                     * @param bytes Where to copy them.
+                     * @param count The number of bytes.
+                     * @return If there were enough, otherwise the journal is truncated.
+                     */
+                    bool take(std::uint8_t * bytes, const std::size_t count) {
+                        for(std::size_t copied = 0; copied < count;) {
+                            if(this->position == this->buffer.size()) {
+                                this->buffer.resize(buffer_capacity);
+                                this->file.read(reinterpret_cast<char *> (this->buffer.data()), this->buffer.size());
+                                this->buffer.resize(this->file.gcount());
+                                this->position = 0;
+
+                                if(this->buffer.empty()) {
+                                    this->is_truncated = true;
+                                    return false;
+                                }
+                            }
+
+                            std::size_t chunk = std::min(count - copied, this->buffer.size() - this->position);
+
+                            std::memcpy(&bytes[copied], &this->buffer[this->position], chunk);
+                            this->position += chunk;
+                            this->offset += chunk;
+                            copied += chunk;
+                        }
+
+                        return true;
+                    }
+
+                    bool skip(std::uint64_t count) {
+                        std::uint8_t bytes[0x100];
+
+                        for(std::size_t chunk; count > 0; count -= chunk) {
+                            chunk = std::min<std::uint64_t>(count, sizeof(bytes));
+
+                            if(!this->take(bytes, chunk)) {
+                                return false;
+                            }
+                        }
+
+                        return true;
+                    }
+
+                    bool take_varint(std::uint64_t & value) {
+                        std::uint8_t byte = 0x80;
+
+                        value = 0;
+
+                        for(std::uint8_t shift = 0; (byte & 0x80) && shift < 64; shift += 7) {
+                            if(!this->take(&byte, 1)) {
+                                return false;
+                            }
+
+                            value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+                        }
+
+                        return true;
+                    }
+            };
+
+            /**
+             * @brief State of a replay, shared with the devices.
+             */
+            struct Replay {
+                Reader reader;
+                std::deque<Entry> pending;
+                Machine * machine = nullptr;
+                std::uint64_t reads = 0;
+                bool is_diverged = false;
+                std::uint64_t diverged_cycle = 0;
+                std::uint16_t diverged_address = 0x0000;
+            };
+
+            /**
+             * @brief Device recording what another one returns.
+             */
+            class Recorded : public Device {
+                public:
+                    Recorded(const std::shared_ptr<Device> device, Journal & journal) noexcept : device(device), journal(journal) {}
+
+                    std::uint8_t read(const std::uint16_t address) override {
+                        std::uint8_t value = this->device->read(address);
+
+                        this->journal.record_read(address, value);
+
+                        return value;
+                    }
+
+                    void write(const std::uint16_t address, const std::uint8_t value) override {
+                        this->device->write(address, value);
+                    }
+
+                    void save_state(std::string & state) const override {
+                        this->device->save_state(state);
+                    }
+
+                    bool load_state(const std::string & state) override {
+                        return this->device->load_state(state);
+                    }
+
+                    /**
+                     * @brief The wrapped device.
+                     */
+                    const std::shared_ptr<Device> device;
+
+                private:
+                    Journal & journal;
+            };
+
+            /**
+             * @brief Device returning what was recorded instead of reading another one, which still takes the writes.
+             */
+            class Replayed : public Device {
+                public:
+                    Replayed(const std::shared_ptr<Device> device, Replay & replay) noexcept : device(device), replay(replay) {}
+
+                    /**
+                     * @brief Takes the next recorded read, it has to be of this address at this cycle. Otherwise the
+                     *        replay diverged, and the device is read.
+                     * @param address The address.
+                     * @return The byte.
+                     */
+                    std::uint8_t read(const std::uint16_t address) override {
+                        std::deque<Entry> & pending = this->replay.pending;
+                        std::uint64_t cycles = this->replay.machine->reference_cycles();
+
+                        if(!pending.empty() && pending.front().kind == Kind::Read && pending.front().address == address && pending.front().cycle == cycles) {
+                            std::uint8_t value = pending.front().value;
+
+                            pending.pop_front();
+                            this->replay.reads++;
+
+                            return value;
+                        }
+
+                        if(!this->replay.is_diverged) {
+                            this->replay.is_diverged = true;
+                            this->replay.diverged_cycle = cycles;
+                            this->replay.diverged_address = address;
+                        }
+
+                        return this->device->read(address);
+                    }
+
+                    void write(const std::uint16_t address, const std::uint8_t value) override {
+                        this->device->write(address, value);
+                    }
+
+                    void save_state(std::string & state) const override {
+                        this->device->save_state(state);
+                    }
+
+                    bool load_state(const std::string & state) override {
+                        return this->device->load_state(state);
+                    }
+
+                private:
+                    const std::shared_ptr<Device> device;
+                    Replay & replay;
+            };
+
+            /**
+             * @brief Machine being recorded, null if none is.
+             */
+            Machine * machine;
+
+            /**
+             * @brief Cycles between two checkpoints, and the number of the only scheduled checkpoint still to be taken.
+             */
+            std::uint64_t period;
+            std::uint64_t generation;
+
+            /**
+             * @brief Whether the inputs are only counted, as something outside of the execution is changing the
+             *        machine, how many were, and the fingerprint of the machine before.
+             */
+            bool is_paused;
+            std::uint64_t touched;
+            std::uint64_t paused_state;
+
+            /**
+             * @brief Cycle of the last record, the next one is relative to it.
+             */
+            std::uint64_t last_cycle;
+
+            /**
+             * @brief Records not yet written into the file.
+             */
+            std::vector<std::uint8_t> buffer;
+
+            std::ofstream file;
+            std::ofstream index;
+
+            /**
+             * @brief Inputs and checkpoints recorded, and bytes written since the journal started.
+             */
+            std::uint64_t inputs;
+            std::uint64_t checkpoints;
+            std::uint64_t bytes;
+
+            /**
+             * @brief Reads a value in little endian.
+             * @param bytes The bytes.
+             * @param count The number of bytes.
+             * @return The value.
+             */
+            static std::uint64_t read_le(const std::uint8_t * bytes, const std::uint8_t count) noexcept {
+                std::uint64_t value = 0;
+
+                for(std::uint8_t byte = 0; byte < count; byte++) {
+                    value |= static_cast<std::uint64_t> (bytes[byte]) << (byte * 8);
+                }
+
+                return value;
+            }
+
+            /**
+             * @brief Wraps the devices of the machine not wrapped yet, one wrapper per device.
+             */
+            void wrap() {
+                Memory & memory = this->machine->reference_memory();
+                std::shared_ptr<Device> device, wrapper;
+
+                for(std::uint16_t page = 0x00; page < 0x100; page++) {
+                    if(memory.get_device(page) == nullptr || std::dynamic_pointer_cast<Recorded>(memory.get_device(page)) != nullptr) {
+                        continue;
+                    }
+
+                    if(memory.get_device(page) != device) {
+                        device = memory.get_device(page);
+                        wrapper = std::make_shared<Recorded>(device, *this);
+                    }
+
+                    memory.attach(page, page, wrapper);
+                }
+            }
+
+            /**
+             * @brief Wraps the devices of a machine for a replay.
+             * @param machine The machine.
+             * @param replay The state of the replay.
+             * @return The wrapped devices and their pages, to attach them back.
+             */
+            static std::vector<std::pair<std::uint8_t, std::shared_ptr<Device>>> wrap_replayed(Machine & machine, Replay & replay) {
+                std::vector<std::pair<std::uint8_t, std::shared_ptr<Device>>> devices;
+                std::shared_ptr<Device> wrapper;
+
+                for(std::uint16_t page = 0x00; page < 0x100; page++) {
+                    std::shared_ptr<Device> device = machine.reference_memory().get_device(page);
+
+                    if(device == nullptr) {
+                        continue;
+                    }
+
+                    if(devices.empty() || devices.back().second != device) {
+                        wrapper = std::make_shared<Replayed>(device, replay);
+                    }
+
+                    devices.push_back({ page, device });
+                    machine.reference_memory().attach(page, page, wrapper);
+                }
+
+                return devices;
+            }
+
+            /**
+             * @brief Appends the kind and cycle of a record, the rest follows.
+             * @param kind The kind.
+             */
+            void append_record(const Kind kind) {
+                std::uint64_t cycle = this->machine->reference_cycles();
+                std::uint64_t difference = cycle - this->last_cycle;
+
+                this->buffer.push_back(kind);
+
+                while(difference >= 0x80) {
+                    this->buffer.push_back((difference & 0x7F) | 0x80);
+                    difference >>= 7;
+                }
+
+                this->buffer.push_back(difference);
+                this->last_cycle = cycle;
+            }
+
+            /**
+             * @brief Appends a checkpoint of the machine and writes it through, then its index entry.
+             * @param command What changed the machine, empty for the periodic checkpoints.
+             */
+            void checkpoint(const std::string_view command) {
+                std::vector<std::uint8_t> state;
+                std::uint64_t cycle = this->machine->reference_cycles();
+                std::uint64_t offset = this->bytes + this->buffer.size();
+                std::uint8_t entry[16];
+
+                this->machine->encode_state(state);
+                this->buffer.push_back(Kind::Checkpoint);
+
+                for(std::uint8_t byte = 0; byte < 8; byte++) {
+                    this->buffer.push_back((cycle >> (byte * 8)) & 0xFF);
+                }
+
+                for(std::size_t size = command.size(); ; size >>= 7) {
+                    this->buffer.push_back((size & 0x7F) | (size >= 0x80 ? 0x80 : 0x00));
+
+                    if(size < 0x80) {
+                        break;
+                    }
+                }
+
+                this->buffer.insert(this->buffer.end(), command.begin(), command.end());
+
+                for(std::uint8_t byte = 0; byte < 4; byte++) {
+                    this->buffer.push_back((state.size() >> (byte * 8)) & 0xFF);
+                }
+
+                this->buffer.insert(this->buffer.end(), state.begin(), state.end());
+                this->last_cycle = cycle;
+                this->checkpoints++;
+                this->flush(); // The checkpoint is on the disk before the index points to it.
+
+                for(std::uint8_t byte = 0; byte < 8; byte++) {
+                    entry[byte] = (cycle >> (byte * 8)) & 0xFF;
+                    entry[8 + byte] = (offset >> (byte * 8)) & 0xFF;
+                }
+
+                this->index.write(reinterpret_cast<const char *> (entry), sizeof(entry));
+                this->index.flush();
+            }
+
+            /**
+             * @brief Schedules the next periodic checkpoint, the previously scheduled one does nothing anymore.
+             */
+            void arm() {
+                std::uint64_t generation = ++this->generation;
+
+                this->machine->schedule(this->machine->reference_cycles() + this->period, [this, generation](Machine & machine) {
+                    if(generation == this->generation && &machine == this->machine) {
+                        this->checkpoint("");
+                        this->arm();
+                    }
+                });
+            }
+
+            /**
+             * @brief Writes the buffered records into the file.
+             */
+            void flush() {
+                this->file.write(reinterpret_cast<const char *> (this->buffer.data()), this->buffer.size());
+                this->file.flush();
+                this->bytes += this->buffer.size();
+                this->buffer.clear();
+            }
+
+            void flush_if_full() {
+                if(this->buffer.size() >= buffer_capacity) {
+                    this->flush();
+                }
+            }
+
+            /**
+             * @brief Fingerprints the whole state of a machine, devices included, to tell if a command changed it.
+             * @param machine The machine.
+             * @return The fingerprint.
+             */
+            static std::uint64_t fingerprint(const Machine & machine) {
+                std::vector<std::uint8_t> state;
+
+                machine.encode_state(state, false);
+
+                return checksum(state.data(), state.size());
+            }
+
+            /**
+             * @brief Reads the cycles and offsets of the checkpoints of a journal from its index, or from the journal
+             *        itself if the index is missing. Entries pointing past the end of the journal are left out.
+             * @param path The path to the journal.
+             * @param offsets The cycle and offset of each checkpoint.
+             * @return If the operation was successful.
+             */
+            static bool load_index(const std::string path, std::vector<std::pair<std::uint64_t, std::uint64_t>> & offsets) {
+                std::ifstream journal = std::ifstream(path, std::ios::binary | std::ios::ate);
+                std::ifstream index = std::ifstream(path + ".index", std::ios::binary);
+                std::uint8_t entry[16];
+
+                if(!journal.is_open()) {
+                    std::cerr << "\tFile at \"" << path << "\" not found." << std::endl;
+                    return false;
+                }
+
+                std::uint64_t size = journal.tellg();
+
+                if(index.is_open() && index.read(reinterpret_cast<char *> (entry), sizeof(index_magic)) && std::memcmp(entry, index_magic, sizeof(index_magic)) == 0) {
+                    while(index.read(reinterpret_cast<char *> (entry), sizeof(entry))) {
+                        if(read_le(&entry[8], 8) < size) {
+                            offsets.push_back({ read_le(entry, 8), read_le(&entry[8], 8) });
+                        }
+                    }
+
+                    return true;
+                }
+
+                Reader reader; // No index, the records are skimmed.
+                Entry record;
+                std::uint64_t offset = sizeof(magic);
+
+                if(!reader.open(path, offset)) {
+                    std::cerr << "\tFile at \"" << path << "\" is not a journal." << std::endl;
+                    return false;
+                }
+
+                while(reader.next(record)) {
+                    if(record.kind == Kind::Checkpoint) {
+                        offsets.push_back({ record.cycle, offset });
+                    }
+
+                    offset = reader.tell();
+                }
+
+                return true;
+            }
+    };
+
+    inline void Machine::record_interrupt(const std::uint8_t lines, const bool is_asserted, const bool is_nmi) noexcept {
+        this->journal->record_interrupt(*this, lines, is_asserted, is_nmi);
+    }
+
+    class Scheduler {
+        public:
+            /**
+             * @brief Emulated time run between two waits, in seconds.
+             */
+            static constexpr double slice = 0.005;
+
+            /**
+             * @brief Time before the end of a wait that is spun instead of slept, in seconds. Sleeping wakes up late by
+             *        tens of microseconds, spinning only the end keeps the host mostly idle while throttled.
+             */
+            static constexpr double margin = 0.0001;
+
+            /**
+             * @brief Constructor.
+             */
+            Scheduler() noexcept {
+                this->set_rate(0);
+            }
+
+            /**
+             * @brief Sets the emulated clock rate and drops the accumulated timings.
+             * @param hz The rate in cycles per second, 0 to run as fast as possible.
+             */
+            void set_rate(const std::uint64_t hz) noexcept {
+                this->hz = hz;
+                this->emulated_seconds = 0;
+                this->host_seconds = 0;
+                this->busy_seconds = 0;
+                this->worst_lag = 0;
+                this->last_drift = 0;
+            }
+
+            /**
+             * @brief Executes instructions until a number of cycles has elapsed or the machine stops, in slices
+             *        paced to the clock rate. Each slice ends at an absolute deadline from the start of the run, so
+             *        late wake ups don't add up.
+             * @param machine The machine.
+             * @param max_cycles The maximum number of cycles.
+             * @param runner Runs the machine for a number of cycles and returns the instructions executed.
+             * @return The number of instructions executed.
+             */
+            template<typename Runner>
+            std::uint64_t run(Machine & machine, const std::uint64_t max_cycles, Runner runner) {
+                std::uint64_t start_cycles = machine.reference_cycles(), slice_cycles = std::max<std::uint64_t>(1, this->hz * slice), executed = 0, done = 0;
+                auto start = std::chrono::steady_clock::now(), now = start;
+
+                while(done < max_cycles) {
+                    std::uint64_t cycles = std::min(slice_cycles, max_cycles - done);
+                    auto slice_start = std::chrono::steady_clock::now();
+
+                    executed += runner(cycles);
+
+                    std::uint64_t ran = machine.reference_cycles() - start_cycles - done;
+                    auto deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(static_cast<double>(done + ran) / this->hz));
+
+                    done += ran;
+                    now = std::chrono::steady_clock::now();
+                    this->busy_seconds += std::chrono::duration<double>(now - slice_start).count();
+
+                    if(now > deadline) { // The host couldn't keep up.
+                        this->worst_lag = std::max(this->worst_lag, std::chrono::duration<double>(now - deadline).count());
+                    } else {
+                        if(deadline - now > std::chrono::duration<double>(margin)) {
+                            std::this_thread::sleep_until(deadline - std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(margin)));
+                        }
+
+                        auto spin_start = std::chrono::steady_clock::now();
+
+                        while((now = std::chrono::steady_clock::now()) < deadline) {}
+
+                        this->busy_seconds += std::chrono::duration<double>(now - spin_start).count();
+                    }
+
+                    if(ran < cycles) { // Halted or stopped on a breakpoint or watchpoint.
+                        break;
+                    }
+                }
+
+                double emulated = static_cast<double>(done) / this->hz, host = std::chrono::duration<double>(now - start).count();
+
+                this->emulated_seconds += emulated;
+                this->host_seconds += host;
+                this->last_drift = host - emulated;
+
+                return executed;
+            }
+
+            bool is_throttled() const noexcept {
+                return this->hz > 0;
+            }
+
+            std::uint64_t get_rate() const noexcept {
+                return this->hz;
+            }
+
+            /**
+             * @brief Gets how far the host time is behind the emulated time, positive when the machine runs slow.
+             * @param is_total Whether to get it over every run since the rate was set instead of the last run.
+             * @return The drift in seconds.
+             */
+            double get_drift(const bool is_total = false) const noexcept {
+                return is_total ? this->host_seconds - this->emulated_seconds : this->last_drift;
+            }
+
+            double get_emulated_seconds() const noexcept {
+                return this->emulated_seconds;
+            }
+
+            double get_host_seconds() const noexcept {
+                return this->host_seconds;
+            }
+
+            double get_busy_seconds() const noexcept {
+                return this->busy_seconds;
+            }
+
+            double get_worst_lag() const noexcept {
+                return this->worst_lag;
+            }
+
+        private:
+            std::uint64_t hz;
+            double emulated_seconds;
+            double host_seconds;
+            double busy_seconds;
+            double worst_lag;
+            double last_drift;
+    };
+
+    class Swarm {
+        public:
+            /**
+             * @brief State of a lane.
+             */
+            enum class State : std::uint8_t {
+                Running, // Executes on the next step.
+                Stopped, // Reached the cycle limit of the current run.
+                Halted   // Stopped on an illegal opcode.
+            };
+
+            /**
+             * @brief Constructor. Every lane starts as a copy of a machine: registers, pointers, cycles and memory.
+             *        The memory of the machine becomes one image all the lanes read from, a lane copies a page only
+             *        when it first writes to it. The lanes have no devices, interrupts, breakpoints nor watchpoints,
+             *        the device pages read and write their backing memory; the write protection is kept.
+             * @param machine The machine.
+             * @param count The number of lanes.
+             */
+            Swarm(Machine & machine, const std::uint32_t count) : image(new std::uint8_t[0x10000]) {
+                Memory & memory = machine.reference_memory();
+
+                this->count = count;
+                this->a_registers.assign(count, machine.reference_a_register());
+                this->x_registers.assign(count, machine.reference_x_register());
+                this->y_registers.assign(count, machine.reference_y_register());
+                this->s_registers.assign(count, machine.reference_s_register());
+                this->s_pointers.assign(count, machine.reference_s_pointer());
+                this->i_pointers.assign(count, machine.reference_i_pointer());
+                this->cycles.assign(count, machine.reference_cycles());
+                this->limits.assign(count, 0);
+                this->states.assign(count, State::Stopped);
+                this->matches.assign(count, 0);
+                this->read_pages.resize(count << 8);
+                this->write_pages.assign(count << 8, nullptr);
+                this->leader = machine.reference_i_pointer();
+                this->is_uniform = false;
+                this->converged = 0;
+                this->diverged = 0;
+
+                for(std::uint16_t page = 0x00; page < 0x100; page++) {
+                    std::memcpy(&this->image[page << 8], memory.get_page(page), 0x100);
+                    this->is_read_only[page] = memory.get_flags(page) & Memory::Page::ReadOnly;
+                    std::fill_n(&this->read_pages[page * count], count, &this->image[page << 8]);
+                }
+            }
+
+            /**
+             * @brief Executes instructions on every running lane. The lanes at the IP most lanes were at after the
+             *        last step, with the same code there, execute one instruction through one loop for the opcode
+             *        with the operand decoded once. The rest go one by one, each until it gets to where those went.
+             * @return The number of instructions executed, over all the lanes.
+             */
+            std::uint32_t step() noexcept {
+                std::uint32_t running = 0, matching = 0, stepped = 0, first = this->count;
+                std::uint16_t target = this->leader;
+
+                for(std::uint32_t lane = 0; lane < this->count; lane++) {
+                    if(this->states[lane] == State::Running && this->cycles[lane] >= this->limits[lane]) {
+                        this->states[lane] = State::Stopped;
+                    }
+
+                    bool is_running = this->states[lane] == State::Running;
+                    bool is_matching = is_running && this->i_pointers[lane] == this->leader && this->is_sharing_code(lane, this->leader);
+
+                    this->matches[lane] = is_matching;
+                    running += is_running;
+                    matching += is_matching;
+                    first = (is_matching && first == this->count) ? lane : first;
+                }
+
+                if(matching > 0) {
+                    bool is_split = false;
+
+                    this->execute_group(matching, first, is_split);
+                    target = this->i_pointers[first];
+                    (matching > 1 ? this->converged : this->diverged) += matching; // A lane on its own isn't in lockstep.
+                }
+
+                if(matching < running) {
+                    for(std::uint32_t lane = 0; lane < this->count; lane++) {
+                        if(this->states[lane] == State::Running && !this->matches[lane]) {
+                            stepped += this->run_lane(lane, target);
+                        }
+                    }
+
+                    this->diverged += stepped;
+                }
+
+                std::uint32_t votes = 0, voters = 0, agreeing = 0, halted = 0;
+                std::uint16_t agreed = 0;
+
+                for(std::uint32_t lane = 0; lane < this->count; lane++) { // Majority vote for the next leader.
+                    if(this->states[lane] != State::Running) {
+                        halted += this->states[lane] == State::Halted;
+                        continue;
+                    }
+
+                    agreed = voters == 0 ? this->i_pointers[lane] : agreed;
+                    agreeing += this->i_pointers[lane] == agreed;
+                    voters++;
+
+                    if(votes == 0) {
+                        this->leader = this->i_pointers[lane];
+                        votes = 1;
+                    } else {
+                        votes += this->i_pointers[lane] == this->leader ? 1 : -1;
+                    }
+                }
+
+                this->is_uniform = voters > 0 && voters + halted == this->count && agreeing == voters;
+
+                return matching + stepped;
+            }
+
+            /**
+             * @brief Executes instructions on every lane until each one has run a number of cycles or halted. While
+             *        every lane runs the same code, the steps skip the checks on the lanes. Once most instructions
+             *        run one by one over a window of steps, or the lanes are at the same instruction after fewer than
+             *        half of the steps, the lanes stop waiting for each other and each one runs on its own to the end,
+             *        like separate machines would. Checking every lane on every step costs more than it saves then.
+             * @param max_cycles The maximum number of cycles of each lane.
+             * @return The number of instructions executed, over all the lanes.
+             */
+            std::uint64_t run(const std::uint64_t max_cycles) noexcept {
+                std::uint64_t executed = 0, converged = this->converged, diverged = this->diverged;
+                std::uint32_t steps = 0, uniform = 0;
+
+                for(std::uint32_t lane = 0; lane < this->count; lane++) {
+                    if(this->states[lane] != State::Halted) {
+                        this->states[lane] = State::Running;
+                        this->limits[lane] = this->cycles[lane] + std::min(max_cycles, std::numeric_limits<std::uint64_t>::max() - this->cycles[lane]);
+                    }
+                }
+
+                for(std::uint32_t stepped = this->step(); stepped > 0; stepped = this->step()) {
+                    executed += stepped;
+
+                    if(this->is_uniform) {
+                        executed += this->run_uniform();
+                        uniform++;
+                    }
+
+                    if(++steps % divergence_window == 0) {
+                        if(this->diverged - diverged > this->converged - converged || uniform < divergence_window / 2) {
+                            return executed + this->run_apart();
+                        }
+
+                        converged = this->converged;
+                        diverged = this->diverged;
+                        uniform = 0;
+                    }
+                }
+
+                return executed;
+            }
+
+            /**
+             * @brief Gets a byte of the memory of a lane.
+             * @param lane The lane.
+             * @param address The address.
+             * @return The byte.
+             */
+            std::uint8_t get(const std::uint32_t lane, const std::uint16_t address) const noexcept {
+                return this->read_pages[(address >> 8) * this->count + lane][address & 0xFF];
+            }
+
+            /**
+             * @brief Sets a byte of the memory of a lane, bypassing the write protection like Memory::load_bytes.
+             *        Meant to give each lane its input.
+             * @param lane The lane.
+             * @param address The address.
+             * @param value The byte.
+             */
+            void patch(const std::uint32_t lane, const std::uint16_t address, const std::uint8_t value) {
+                std::uint8_t * page = this->write_pages[(address >> 8) * this->count + lane];
+
+                if(page == nullptr) {
+                    page = this->get_lanes().copy_page(lane, address >> 8);
+                }
+
+                page[address & 0xFF] = value;
+            }
+
+            /**
+             * @brief Checks if a lane is in the same state as a machine: registers, pointers, cycles and memory.
+             * @param lane The lane.
+             * @param machine The machine.
+             * @return Whether or not they match.
+             */
+            bool is_matching(const std::uint32_t lane, Machine & machine) const noexcept {
+                if(this->a_registers[lane] != machine.reference_a_register() || this->x_registers[lane] != machine.reference_x_register() ||
+                   this->y_registers[lane] != machine.reference_y_register() || this->s_registers[lane] != machine.reference_s_register() ||
+                   this->s_pointers[lane] != machine.reference_s_pointer() || this->i_pointers[lane] != machine.reference_i_pointer() ||
+                   this->cycles[lane] != machine.reference_cycles()) {
+                    return false;
+                }
+
+                for(std::uint16_t page = 0x00; page < 0x100; page++) {
+                    if(std::memcmp(this->read_pages[page * this->count + lane], machine.reference_memory().get_page(page), 0x100) != 0) {
+                        return false;
+                    }
+                }
+
+                return true;
+            }
+
+            std::uint32_t count_lanes() const noexcept {
+                return this->count;
+            }
+
+            /**
+             * @brief Counts the pages the lanes copied, over all the lanes.
+             * @return The pages.
+             */
+            std::size_t count_private_pages() const noexcept {
+                return this->private_pages.size();
+            }
+
+            /**
+             * @brief Counts the instructions executed by lanes together with others, in one loop per opcode.
+             * @return The instructions.
+             */
+            std::uint64_t count_converged() const noexcept {
+                return this->converged;
+            }
+
+            /**
+             * @brief Counts the instructions executed by lanes one by one.
+             * @return The instructions.
+             */
+            std::uint64_t count_diverged() const noexcept {
+                return this->diverged;
+            }
+
+            State get_state(const std::uint32_t lane) const noexcept {
+                return this->states[lane];
+            }
+
+            std::uint8_t & reference_a_register(const std::uint32_t lane) noexcept {
+                return this->a_registers[lane];
+            }
+
+            std::uint8_t & reference_x_register(const std::uint32_t lane) noexcept {
+                return this->x_registers[lane];
+            }
+
+            std::uint8_t & reference_y_register(const std::uint32_t lane) noexcept {
+                return this->y_registers[lane];
+            }
+
+            std::uint8_t & reference_s_register(const std::uint32_t lane) noexcept {
+                return this->s_registers[lane];
+            }
+
+            std::uint16_t & reference_i_pointer(const std::uint32_t lane) noexcept {
+                return this->i_pointers[lane];
+            }
+
+            std::uint8_t & reference_s_pointer(const std::uint32_t lane) noexcept {
+                return this->s_pointers[lane];
+            }
+
+            std::uint64_t & reference_cycles(const std::uint32_t lane) noexcept {
+                return this->cycles[lane];
+            }
+
+        private:
+            using Mode = Machine::Mode;
+            using Flag = Machine::Flag;
+
+            /**
+             * @brief The registers, pointers and page tables of every lane, as plain pointers with the instructions
+             *        working on them. Held in a local while stepping, so the compiler can tell the byte stores don't
+             *        touch the pointers and keep them in registers, which lets the loops over the lanes vectorize.
+             */
+            class Lanes {
+                public:
+                    std::uint8_t * a_registers;
+                    std::uint8_t * x_registers;
+                    std::uint8_t * y_registers;
+                    std::uint8_t * s_registers;
+                    std::uint8_t * s_pointers;
+                    std::uint16_t * i_pointers;
+                    const std::uint8_t ** read_pages;
+                    std::uint8_t ** write_pages;
+                    Swarm * swarm;
+                    std::uint32_t count;
+
+                    /**
+                     * @brief Gives a lane its own copy of a page.
+                     * @param lane The lane.
+                     * @param page The page.
+                     * @return The copy.
+                     */
+                    [[gnu::noinline, gnu::cold]] std::uint8_t * copy_page(const std::uint32_t lane, const std::uint8_t page) {
+                        std::uint8_t * copy = this->swarm->private_pages.emplace_back().data();
+
+                        std::memcpy(copy, this->read_pages[page * this->count + lane], 0x100);
+                        this->read_pages[page * this->count + lane] = copy;
+                        this->write_pages[page * this->count + lane] = copy;
+                        this->swarm->is_written[page] = true;
+
+                        return copy;
+                    }
+
+                    std::uint8_t get(const std::uint32_t lane, const std::uint16_t address) const noexcept {
+                        return this->read_pages[(address >> 8) * this->count + lane][address & 0xFF];
+                    }
+
+                    /**
+                     * @brief Writes a byte through the page table of a lane, copying the page first if it's shared.
+                     * @param lane The lane.
+                     * @param address The address.
+                     * @param value The byte.
+                     */
+                    void set(const std::uint32_t lane, const std::uint16_t address, const std::uint8_t value) noexcept {
+                        std::uint8_t * page = this->write_pages[(address >> 8) * this->count + lane];
+
+                        if(page == nullptr) {
+                            if(this->swarm->is_read_only[address >> 8]) {
+                                return;
+                            }
+
+                            page = this->copy_page(lane, address >> 8);
+                        }
+
+                        page[address & 0xFF] = value;
+                    }
+
+                    /**
+                     * @brief Resolves the effective address of the operand, as Machine::address does.
+                     * @tparam mode The addressing mode.
+                     * @tparam penalize Whether or not crossing a page costs an extra cycle (reads only).
+                     * @param lane The lane.
+                     * @param argument The bytes after the opcode.
+                     * @param penalty Where to add the extra cycle.
+                     * @return The effective address.
+                     */
+                    template<Mode mode, bool penalize = false> std::uint16_t address(const std::uint32_t lane, const std::uint16_t argument, std::uint8_t & penalty) const noexcept {
+                        if constexpr(mode == Mode::ZeroPage) {
+                            return argument & 0xFF;
+                        } else if constexpr(mode == Mode::ZeroPageX) {
+                            return static_cast<std::uint8_t>(argument + this->x_registers[lane]);
+                        } else if constexpr(mode == Mode::ZeroPageY) {
+                            return static_cast<std::uint8_t>(argument + this->y_registers[lane]);
+                        } else if constexpr(mode == Mode::Absolute) {
+                            return argument;
+                        } else if constexpr(mode == Mode::Indirect) {
+                            return this->get(lane, argument) | (this->get(lane, (argument & 0xFF00) | static_cast<std::uint8_t>(argument + 1)) << 8);
+                        } else if constexpr(mode == Mode::IndirectX) {
+                            std::uint8_t pointer = argument + this->x_registers[lane];
+
+                            return this->get(lane, pointer) | (this->get(lane, static_cast<std::uint8_t>(pointer + 1)) << 8);
+                        } else {
+                            std::uint8_t pointer = argument;
+                            std::uint16_t base = (mode == Mode::IndirectY) ? (this->get(lane, pointer) | (this->get(lane, static_cast<std::uint8_t>(pointer + 1)) << 8)) : argument;
+                            std::uint16_t effective = base + ((mode == Mode::AbsoluteX) ? this->x_registers[lane] : this->y_registers[lane]);
+
+                            if(penalize && ((base ^ effective) & 0xFF00)) {
+                                penalty++;
+                            }
+
+                            return effective;
+                        }
+                    }
+
+                    /**
+                     * @brief Reads the operand of a read instruction, the immediate one being the argument itself.
+                     * @tparam mode The addressing mode.
+                     * @param lane The lane.
+                     * @param argument The bytes after the opcode.
+                     * @param penalty Where to add the page crossing cycle.
+                     * @return The operand.
+                     */
+                    template<Mode mode> std::uint8_t operand(const std::uint32_t lane, const std::uint16_t argument, std::uint8_t & penalty) const noexcept {
+                        if constexpr(mode == Mode::Immediate) {
+                            return argument & 0xFF;
+                        } else {
+                            return this->get(lane, this->address<mode, true>(lane, argument, penalty));
+                        }
+                    }
+
+                    std::uint8_t update_zn(const std::uint32_t lane, const std::uint8_t value) noexcept {
+                        this->s_registers[lane] = (this->s_registers[lane] & ~(Flag::Zero | Flag::Negative)) | (value & Flag::Negative) | (value == 0 ? Flag::Zero : 0);
+                        return value;
+                    }
+
+                    void set_flag(const std::uint32_t lane, const Flag flag, const bool value) noexcept {
+                        this->s_registers[lane] = value ? (this->s_registers[lane] | flag) : (this->s_registers[lane] & ~flag);
+                    }
+
+                    void push(const std::uint32_t lane, const std::uint8_t value) noexcept {
+                        this->set(lane, 0x0100 + this->s_pointers[lane]--, value);
+                    }
+
+                    std::uint8_t pull(const std::uint32_t lane) noexcept {
+                        return this->get(lane, 0x0100 + ++this->s_pointers[lane]);
+                    }
+
+                    /**
+                     * @brief Applies a read-modify-write operation on the accumulator or on the memory of a lane.
+                     * @tparam mode The addressing mode.
+                     * @param lane The lane.
+                     * @param argument The bytes after the opcode.
+                     * @param operation The operation.
+                     * @return The extra cycles, none.
+                     */
+                    template<Mode mode, typename Operation> std::uint8_t modify(const std::uint32_t lane, const std::uint16_t argument, Operation operation) noexcept {
+                        std::uint8_t penalty = 0;
+
+                        if constexpr(mode == Mode::Accumulator) {
+                            this->a_registers[lane] = this->update_zn(lane, operation(this->a_registers[lane]));
+                        } else {
+                            std::uint16_t effective = this->address<mode>(lane, argument, penalty);
+
+                            this->set(lane, effective, this->update_zn(lane, operation(this->get(lane, effective))));
+                        }
+
+                        return 0;
+                    }
+
+                    /**
+                     * @brief Takes a relative branch if a condition holds, IP already being past the instruction.
+                     * @param lane The lane.
+                     * @param argument The bytes after the opcode, the offset is the first one.
+                     * @param condition The condition.
+                     * @return The taken and page crossing penalties.
+                     */
+                    std::uint8_t branch(const std::uint32_t lane, const std::uint16_t argument, const bool condition) noexcept {
+                        std::uint16_t next = this->i_pointers[lane];
+                        std::uint16_t target = next + static_cast<std::int8_t>(argument & 0xFF);
+
+                        if(!condition) {
+                            return 0;
+                        }
+
+                        this->i_pointers[lane] = target;
+
+                        return ((next ^ target) & 0xFF00) ? 2 : 1;
+                    }
+
+                    template<Mode mode> std::uint8_t compare(const std::uint32_t lane, const std::uint16_t argument, const std::uint8_t value) noexcept {
+                        std::uint8_t penalty = 0, operand = this->operand<mode>(lane, argument, penalty);
+
+                        this->set_flag(lane, Flag::Carry, value >= operand);
+                        this->update_zn(lane, value - operand);
+
+                        return penalty;
+                    }
+
+                //--------------------------------------------------//
+                // Instructions
+                //--------------------------------------------------//
+
+                template<Mode mode> std::uint8_t execute_adc(const std::uint32_t lane, const std::uint16_t argument) noexcept {
+                    std::uint8_t penalty = 0;
+
+                    this->a_registers[lane] = Machine::add(this->s_registers[lane], this->a_registers[lane], this->operand<mode>(lane, argument, penalty));
+
+                    return penalty;
+                }
+
+                template<Mode mode> std::uint8_t execute_and(const std::uint32_t lane, const std::uint16_t argument) noexcept {
+                    std::uint8_t penalty = 0;
+
+                    this->a_registers[lane] = this->update_zn(lane, this->a_registers[lane] & this->operand<mode>(lane, argument, penalty));
+
+                    return penalty;
+                }
+
+                template<Mode mode> std::uint8_t execute_asl(const std::uint32_t lane, const std::uint16_t argument) noexcept {
+                    return this->modify<mode>(lane, argument, [this, lane](std::uint8_t value) {
+                        this->set_flag(lane, Flag::Carry, value & 0x80);
+                        return static_cast<std::uint8_t>(value << 1);
+                    });
+                }
+
+                template<Mode> std::uint8_t execute_bcc(const std::uint32_t lane, const std::uint16_t argument) noexcept {
+                    return this->branch(lane, argument, !(this->s_registers[lane] & Flag::Carry));
+                }
+
+                template<Mode> std::uint8_t execute_bcs(const std::uint32_t lane, const std::uint16_t argument) noexcept {
+                    return this->branch(lane, argument, this->s_registers[lane] & Flag::Carry);
+                }
+
+                template<Mode> std::uint8_t execute_beq(const std::uint32_t lane, const std::uint16_t argument) noexcept {
+                    return this->branch(lane, argument, this->s_registers[lane] & Flag::Zero);
+                }
+
+                template<Mode mode> std::uint8_t execute_bit(const std::uint32_t lane, const std::uint16_t argument) noexcept {
+                    std::uint8_t penalty = 0, operand = this->operand<mode>(lane, argument, penalty);
+
+                    this->set_flag(lane, Flag::Zero, (this->a_registers[lane] & operand) == 0);
+                    this->s_registers[lane] = (this->s_registers[lane] & ~(Flag::Negative | Flag::Overflow)) | (operand & (Flag::Negative | Flag::Overflow));
+
+                    return penalty;
+                }
+
+                template<Mode> std::uint8_t execute_bmi(const std::uint32_t lane, const std::uint16_t argument) noexcept {
+                    return this->branch(lane, argument, this->s_registers[lane] & Flag::Negative);
+                }
+
+                template<Mode> std::uint8_t execute_bne(const std::uint32_t lane, const std::uint16_t argument) noexcept {
+                    return this->branch(lane, argument, !(this->s_registers[lane] & Flag::Zero));
+                }
+
+                template<Mode> std::uint8_t execute_bpl(const std::uint32_t lane, const std::uint16_t argument) noexcept {
+                    return this->branch(lane, argument, !(this->s_registers[lane] & Flag::Negative));
+                }
+
+                template<Mode> std::uint8_t execute_brk(const std::uint32_t lane, const std::uint16_t) noexcept {
+                    std::uint16_t pushed = this->i_pointers[lane] + 1; // BRK skips a padding byte.
+
+                    this->push(lane, pushed >> 8);
+                    this->push(lane, pushed & 0xFF);
+                    this->push(lane, this->s_registers[lane] | Flag::Break | Flag::Unused);
+                    this->set_flag(lane, Flag::Interrupt, true);
+                    this->i_pointers[lane] = this->get(lane, 0xFFFE) | (this->get(lane, 0xFFFF) << 8);
+
+                    return 0;
+                }
+
+                template<Mode> std::uint8_t execute_bvc(const std::uint32_t lane, const std::uint16_t argument) noexcept {
+                    return this->branch(lane, argument, !(this->s_registers[lane] & Flag::Overflow));
+                }
+
+                template<Mode> std::uint8_t execute_bvs(const std::uint32_t lane, const std::uint16_t argument) noexcept {
+                    return this->branch(lane, argument, this->s_registers[lane] & Flag::Overflow);
+                }
+
+                template<Mode> std::uint8_t execute_clc(const std::uint32_t lane, const std::uint16_t) noexcept {
+                    this->set_flag(lane, Flag::Carry, false);
+                    return 0;
+                }
+
+                template<Mode> std::uint8_t execute_cld(const std::uint32_t lane, const std::uint16_t) noexcept {
+                    this->set_flag(lane, Flag::Decimal, false);
+                    return 0;
+                }
+
+                template<Mode> std::uint8_t execute_cli(const std::uint32_t lane, const std::uint16_t) noexcept {
+                    this->set_flag(lane, Flag::Interrupt, false);
+                    return 0;
+                }
+
+                template<Mode> std::uint8_t execute_clv(const std::uint32_t lane, const std::uint16_t) noexcept {
+                    this->set_flag(lane, Flag::Overflow, false);
+                    return 0;
+                }
+
+                template<Mode mode> std::uint8_t execute_cmp(const std::uint32_t lane, const std::uint16_t argument) noexcept {
+                    return this->compare<mode>(lane, argument, this->a_registers[lane]);
+                }
+
+                template<Mode mode> std::uint8_t execute_cpx(const std::uint32_t lane, const std::uint16_t argument) noexcept {
+                    return this->compare<mode>(lane, argument, this->x_registers[lane]);
+                }
+
+                template<Mode mode> std::uint8_t execute_cpy(const std::uint32_t lane, const std::uint16_t argument) noexcept {
+                    return this->compare<mode>(lane, argument, this->y_registers[lane]);
+                }
+
+                template<Mode mode> std::uint8_t execute_dec(const std::uint32_t lane, const std::uint16_t argument) noexcept {
+                    return this->modify<mode>(lane, argument, [](std::uint8_t value) {
+                        return static_cast<std::uint8_t>(value - 1);
+                    });
+                }
+
+                template<Mode> std::uint8_t execute_dex(const std::uint32_t lane, const std::uint16_t) noexcept {
+                    this->x_registers[lane] = this->update_zn(lane, this->x_registers[lane] - 1);
+                    return 0;
+                }
+
+                template<Mode> std::uint8_t execute_dey(const std::uint32_t lane, const std::uint16_t) noexcept {
+                    this->y_registers[lane] = this->update_zn(lane, this->y_registers[lane] - 1);
+                    return 0;
+                }
+
+                template<Mode mode> std::uint8_t execute_eor(const std::uint32_t lane, const std::uint16_t argument) noexcept {
+                    std::uint8_t penalty = 0;
+
+                    this->a_registers[lane] = this->update_zn(lane, this->a_registers[lane] ^ this->operand<mode>(lane, argument, penalty));
+
+                    return penalty;
+                }
+
+                template<Mode mode> std::uint8_t execute_inc(const std::uint32_t lane, const std::uint16_t argument) noexcept {
+                    return this->modify<mode>(lane, argument, [](std::uint8_t value) {
+                        return static_cast<std::uint8_t>(value + 1);
+                    });
+                }
+
+                template<Mode> std::uint8_t execute_inx(const std::uint32_t lane, const std::uint16_t) noexcept {
+                    this->x_registers[lane] = this->update_zn(lane, this->x_registers[lane] + 1);
+                    return 0;
+                }
+
+                template<Mode> std::uint8_t execute_iny(const std::uint32_t lane, const std::uint16_t) noexcept {
+                    this->y_registers[lane] = this->update_zn(lane, this->y_registers[lane] + 1);
+                    return 0;
+                }
+
+                template<Mode mode> std::uint8_t execute_jmp(const std::uint32_t lane, const std::uint16_t argument) noexcept {
+                    std::uint8_t penalty = 0;
+
+                    this->i_pointers[lane] = this->address<mode>(lane, argument, penalty);
+
+                    return 0;
+                }
+
+                template<Mode> std::uint8_t execute_jsr(const std::uint32_t lane, const std::uint16_t argument) noexcept {
+                    std::uint16_t pushed = this->i_pointers[lane] - 1; // JSR pushes the address of its last byte.
+
+                    this->push(lane, pushed >> 8);
+                    this->push(lane, pushed & 0xFF);
+                    this->i_pointers[lane] = argument;
+
+                    return 0;
+                }
+
+                template<Mode mode> std::uint8_t execute_lda(const std::uint32_t lane, const std::uint16_t argument) noexcept {
+                    std::uint8_t penalty = 0;
+
+                    this->a_registers[lane] = this->update_zn(lane, this->operand<mode>(lane, argument, penalty));
+
+                    return penalty;
+                }
+
+                template<Mode mode> std::uint8_t execute_ldx(const std::uint32_t lane, const std::uint16_t argument) noexcept {
+                    std::uint8_t penalty = 0;
+
+                    this->x_registers[lane] = this->update_zn(lane, this->operand<mode>(lane, argument, penalty));
+
+                    return penalty;
+                }
+
+                template<Mode mode> std::uint8_t execute_ldy(const std::uint32_t lane, const std::uint16_t argument) noexcept {
+                    std::uint8_t penalty = 0;
+
+                    this->y_registers[lane] = this->update_zn(lane, this->operand<mode>(lane, argument, penalty));
+
+                    return penalty;
+                }
+
+                template<Mode mode> std::uint8_t execute_lsr(const std::uint32_t lane, const std::uint16_t argument) noexcept {
+                    return this->modify<mode>(lane, argument, [this, lane](std::uint8_t value) {
+                        this->set_flag(lane, Flag::Carry, value & 0x01);
+                        return static_cast<std::uint8_t>(value >> 1);
+                    });
+                }
+
+                template<Mode> std::uint8_t execute_nop(const std::uint32_t, const std::uint16_t) noexcept {
+                    return 0;
+                }
+
+                template<Mode mode> std::uint8_t execute_ora(const std::uint32_t lane, const std::uint16_t argument) noexcept {
+                    std::uint8_t penalty = 0;
+
+                    this->a_registers[lane] = this->update_zn(lane, this->a_registers[lane] | this->operand<mode>(lane, argument, penalty));
+
+                    return penalty;
+                }
+
+                template<Mode> std::uint8_t execute_pha(const std::uint32_t lane, const std::uint16_t) noexcept {
+                    this->push(lane, this->a_registers[lane]);
+                    return 0;
+                }
+
+                template<Mode> std::uint8_t execute_php(const std::uint32_t lane, const std::uint16_t) noexcept {
+                    this->push(lane, this->s_registers[lane] | Flag::Break | Flag::Unused);
+                    return 0;
+                }
+
+                template<Mode> std::uint8_t execute_pla(const std::uint32_t lane, const std::uint16_t) noexcept {
+                    this->a_registers[lane] = this->update_zn(lane, this->pull(lane));
+                    return 0;
+                }
+
+                template<Mode> std::uint8_t execute_plp(const std::uint32_t lane, const std::uint16_t) noexcept {
+                    this->s_registers[lane] = (this->pull(lane) & ~Flag::Break) | Flag::Unused;
+                    return 0;
+                }
+
+                template<Mode mode> std::uint8_t execute_rol(const std::uint32_t lane, const std::uint16_t argument) noexcept {
+                    return this->modify<mode>(lane, argument, [this, lane](std::uint8_t value) {
+                        std::uint8_t carry = this->s_registers[lane] & Flag::Carry;
+
+                        this->set_flag(lane, Flag::Carry, value & 0x80);
+                        return static_cast<std::uint8_t>((value << 1) | carry);
+                    });
+                }
+
+                template<Mode mode> std::uint8_t execute_ror(const std::uint32_t lane, const std::uint16_t argument) noexcept {
+                    return this->modify<mode>(lane, argument, [this, lane](std::uint8_t value) {
+                        std::uint8_t carry = this->s_registers[lane] & Flag::Carry;
+
+                        this->set_flag(lane, Flag::Carry, value & 0x01);
+                        return static_cast<std::uint8_t>((value >> 1) | (carry << 7));
+                    });
+                }
+
+                template<Mode> std::uint8_t execute_rti(const std::uint32_t lane, const std::uint16_t) noexcept {
+                    this->s_registers[lane] = (this->pull(lane) & ~Flag::Break) | Flag::Unused;
+                    this->i_pointers[lane] = this->pull(lane);
+                    this->i_pointers[lane] |= this->pull(lane) << 8;
+                    return 0;
+                }
+
+                template<Mode> std::uint8_t execute_rts(const std::uint32_t lane, const std::uint16_t) noexcept {
+                    this->i_pointers[lane] = this->pull(lane);
+                    this->i_pointers[lane] |= this->pull(lane) << 8;
+                    this->i_pointers[lane]++;
+                    return 0;
+                }
+
+                template<Mode mode> std::uint8_t execute_sbc(const std::uint32_t lane, const std::uint16_t argument) noexcept {
+                    std::uint8_t penalty = 0;
+
+                    this->a_registers[lane] = Machine::subtract(this->s_registers[lane], this->a_registers[lane], this->operand<mode>(lane, argument, penalty));
+
+                    return penalty;
+                }
+
+                template<Mode> std::uint8_t execute_sec(const std::uint32_t lane, const std::uint16_t) noexcept {
+                    this->set_flag(lane, Flag::Carry, true);
+                    return 0;
+                }
+
+                template<Mode> std::uint8_t execute_sed(const std::uint32_t lane, const std::uint16_t) noexcept {
+                    this->set_flag(lane, Flag::Decimal, true);
+                    return 0;
+                }
+
+                template<Mode> std::uint8_t execute_sei(const std::uint32_t lane, const std::uint16_t) noexcept {
+                    this->set_flag(lane, Flag::Interrupt, true);
+                    return 0;
+                }
+
+                template<Mode mode> std::uint8_t execute_sta(const std::uint32_t lane, const std::uint16_t argument) noexcept {
+                    std::uint8_t penalty = 0;
+
+                    this->set(lane, this->address<mode>(lane, argument, penalty), this->a_registers[lane]);
+
+                    return 0;
+                }
+
+                template<Mode mode> std::uint8_t execute_stx(const std::uint32_t lane, const std::uint16_t argument) noexcept {
+                    std::uint8_t penalty = 0;
+
+                    this->set(lane, this->address<mode>(lane, argument, penalty), this->x_registers[lane]);
+
+                    return 0;
+                }
+
+                template<Mode mode> std::uint8_t execute_sty(const std::uint32_t lane, const std::uint16_t argument) noexcept {
+                    std::uint8_t penalty = 0;
+
+                    this->set(lane, this->address<mode>(lane, argument, penalty), this->y_registers[lane]);
+
+                    return 0;
+                }
+
+                template<Mode> std::uint8_t execute_tax(const std::uint32_t lane, const std::uint16_t) noexcept {
+                    this->x_registers[lane] = this->update_zn(lane, this->a_registers[lane]);
+                    return 0;
+                }
+
+                template<Mode> std::uint8_t execute_tay(const std::uint32_t lane, const std::uint16_t) noexcept {
+                    this->y_registers[lane] = this->update_zn(lane, this->a_registers[lane]);
+                    return 0;
+                }
+
+                template<Mode> std::uint8_t execute_tsx(const std::uint32_t lane, const std::uint16_t) noexcept {
+                    this->x_registers[lane] = this->update_zn(lane, this->s_pointers[lane]);
+                    return 0;
+                }
+
+                template<Mode> std::uint8_t execute_txa(const std::uint32_t lane, const std::uint16_t) noexcept {
+                    this->a_registers[lane] = this->update_zn(lane, this->x_registers[lane]);
+                    return 0;
+                }
+
+                template<Mode> std::uint8_t execute_txs(const std::uint32_t lane, const std::uint16_t) noexcept {
+                    this->s_pointers[lane] = this->x_registers[lane];
+                    return 0;
+                }
+
+                template<Mode> std::uint8_t execute_tya(const std::uint32_t lane, const std::uint16_t) noexcept {
+                    this->a_registers[lane] = this->update_zn(lane, this->y_registers[lane]);
+                    return 0;
+                }
+            };
+
+            /**
+             * @brief Most instructions a lane runs on its own in one step, trying to get back to the others.
+             */
+            static constexpr std::uint32_t max_catch_up = 64;
+
+            /**
+             * @brief Steps over which Swarm::run weighs the instructions run in lockstep against the ones run alone,
+             *        and counts the steps after which every lane was at the same instruction.
+             */
+            static constexpr std::uint32_t divergence_window = 64;
+
+            std::uint32_t count;
+
+            /**
+             * @brief Registers, pointers and cycles of the lanes, one array each.
+             */
+            std::vector<std::uint8_t> a_registers;
+            std::vector<std::uint8_t> x_registers;
+            std::vector<std::uint8_t> y_registers;
+            std::vector<std::uint8_t> s_registers;
+            std::vector<std::uint8_t> s_pointers;
+            std::vector<std::uint16_t> i_pointers;
+            std::vector<std::uint64_t> cycles;
+
+            /**
+             * @brief Cycle each lane stops at in the current run, and the state of each lane.
+             */
+            std::vector<std::uint64_t> limits;
+            std::vector<State> states;
+
+            /**
+             * @brief Whether or not each lane is at the leading IP on the current step.
+             */
+            std::vector<std::uint8_t> matches;
+            std::uint16_t leader;
+
+            /**
+             * @brief Whether or not every lane that hasn't halted is running and at the same IP.
+             */
+            bool is_uniform;
+
+            /**
+             * @brief Memory the machine had, shared by every lane, its write protected pages and the pages some lane
+             *        copied (and may have changed).
+             */
+            std::unique_ptr<std::uint8_t[]> image;
+            std::bitset<0x100> is_read_only;
+            std::bitset<0x100> is_written;
+
+            /**
+             * @brief Page tables of the lanes, page by page with the lanes next to each other, so an address every
+             *        lane uses reads contiguous entries. The reads go to the image or to the copy of the lane, the
+             *        writes only to the copy (null until there's one).
+             */
+            std::vector<const std::uint8_t *> read_pages;
+            std::vector<std::uint8_t *> write_pages;
+
+            /**
+             * @brief Pages copied by the lanes, a deque so they never move.
+             */
+            std::deque<std::array<std::uint8_t, 0x100>> private_pages;
+
+            /**
+             * @brief Instructions executed together and one by one.
+             */
+            std::uint64_t converged;
+            std::uint64_t diverged;
+
+            /**
+             * @brief Checks if an opcode takes each lane to an IP of its own, which the others may not share.
+             * @param opcode The opcode.
+             * @param mode Its addressing mode.
+             * @return Whether or not it does.
+             */
+            static constexpr bool is_computed(const std::uint8_t opcode, const Mode mode) noexcept {
+                return mode == Mode::Relative || mode == Mode::Indirect || opcode == 0x00 || opcode == 0x40 || opcode == 0x60; // Branches, JMP (a), BRK, RTI and RTS.
+            }
+
+            Lanes get_lanes() noexcept {
+                return Lanes {
+                    this->a_registers.data(), this->x_registers.data(), this->y_registers.data(), this->s_registers.data(),
+                    this->s_pointers.data(), this->i_pointers.data(), this->read_pages.data(), this->write_pages.data(), this, this->count
+                };
+            }
+
+            /**
+             * @brief Checks if a lane has the same code as the image at an address, only looked at when a lane copied
+             *        the pages.
+             * @param lane The lane.
+             * @param address The address.
+             * @return Whether or not it has.
+             */
+            bool is_sharing_code(const std::uint32_t lane, const std::uint16_t address) const noexcept {
+                if(!this->is_written[address >> 8] && !this->is_written[static_cast<std::uint16_t>(address + 2) >> 8]) {
+                    return true;
+                }
+
+                for(std::uint16_t offset = 0; offset < 3; offset++) {
+                    if(this->get(lane, address + offset) != this->image[static_cast<std::uint16_t>(address + offset)]) {
+                        return false;
+                    }
+                }
+
+                return true;
+            }
+
+            /**
+             * @brief Gets the cycles every lane that hasn't halted can still run before one reaches its limit.
+             * @return The cycles, 0 if a lane reached its limit.
+             */
+            [[gnu::noinline]] std::uint64_t measure_slack() const noexcept {
+                std::uint64_t slack = std::numeric_limits<std::uint64_t>::max();
+
+                for(std::uint32_t lane = 0; lane < this->count; lane++) {
+                    if(this->states[lane] != State::Halted) {
+                        slack = std::min(slack, this->cycles[lane] < this->limits[lane] ? this->limits[lane] - this->cycles[lane] : 0);
+                    }
+                }
+
+                return slack;
+            }
+
+            /**
+             * @brief Executes instructions while every lane that hasn't halted runs the same code: the IP and the
+             *        decoding are shared and the limits are only checked once the lowest bound of the cycles left runs
+             *        out. Stops when the lanes split up or one reaches its limit.
+             * @return The number of instructions executed, over all the lanes.
+             */
+            std::uint64_t run_uniform() noexcept {
+                std::uint64_t executed = 0, slack = this->measure_slack();
+                std::uint32_t running = 0, first = this->count;
+
+                for(std::uint32_t lane = 0; lane < this->count; lane++) {
+                    this->matches[lane] = this->states[lane] == State::Running;
+                    running += this->matches[lane];
+                    first = (this->matches[lane] && first == this->count) ? lane : first;
+                }
+
+                while(slack > 0) {
+                    bool is_split = false;
+
+                    this->leader = this->i_pointers[first];
+
+                    if(this->is_written[this->leader >> 8] || this->is_written[static_cast<std::uint16_t>(this->leader + 2) >> 8]) {
+                        for(std::uint32_t lane = 0; lane < this->count && !is_split; lane++) {
+                            is_split = this->matches[lane] && !this->is_sharing_code(lane, this->leader);
+                        }
+
+                        if(is_split) {
+                            break;
+                        }
+                    }
+
+                    std::uint8_t worst_cycles = this->execute_group(running, first, is_split);
+
+                    if(worst_cycles == 0) {
+                        this->is_uniform = false;
+                        return executed;
+                    }
+
+                    slack = slack > worst_cycles ? slack - worst_cycles : this->measure_slack();
+                    executed += running;
+                    this->converged += running;
+
+                    if(is_split) {
+                        break;
+                    }
+                }
+
+                this->leader = this->i_pointers[first];
+
+                return executed;
+            }
+
+            /**
+             * @brief Executes the instruction at the leading IP on the lanes there, halting them if it's illegal.
+             * @param matching The number of lanes there.
+             * @param first The first of them.
+             * @param is_split Set if the instruction may have sent them to different IPs and it did.
+             * @return The most cycles the instruction can take, 0 if it's illegal.
+             */
+            [[gnu::flatten, gnu::noinline]] std::uint8_t execute_group(const std::uint32_t matching, const std::uint32_t first, bool & is_split) noexcept {
+                Lanes lanes = this->get_lanes();
+                std::uint16_t argument = this->image[static_cast<std::uint16_t>(this->leader + 1)] | (this->image[static_cast<std::uint16_t>(this->leader + 2)] << 8);
+
+                switch(this->image[this->leader]) {
+                    #define X(opcode, mnemonic, handler, mode, timing) \
+                        case opcode: \
+                            this->execute_lanes<Mode::mode, timing>(matching == this->count, argument, [&lanes](const std::uint32_t lane, const std::uint16_t argument) { \
+                                return lanes.execute_##handler<Mode::mode>(lane, argument); \
+                            }); \
+                            \
+                            if constexpr(is_computed(opcode, Mode::mode)) { \
+                                is_split = this->is_splitting(first); \
+                            } \
+                            \
+                            return timing + 2;
+                    __RHEA_INSTRUCTIONS__(X)
+                    #undef X
+
+                    default:
+                        for(std::uint32_t lane = 0; lane < this->count; lane++) {
+                            this->states[lane] = this->matches[lane] ? State::Halted : this->states[lane];
+                        }
+
+                        return 0;
+                }
+            }
+
+            /**
+             * @brief Checks if the lanes running together went to different IPs.
+             * @param first The first of them.
+             * @return Whether or not they did.
+             */
+            bool is_splitting(const std::uint32_t first) const noexcept {
+                const std::uint16_t * i_pointers = this->i_pointers.data();
+                const std::uint8_t * matches = this->matches.data();
+                std::uint16_t differences = 0;
+
+                for(std::uint32_t lane = first + 1; lane < this->count; lane++) {
+                    differences |= (i_pointers[lane] ^ i_pointers[first]) & -matches[lane];
+                }
+
+                return differences != 0;
+            }
+
+            /**
+             * @brief Executes an instruction on the lanes at the leading IP.
+             * @tparam mode The addressing mode.
+             * @tparam timing The base cycles.
+             * @param is_every_lane Whether or not every lane is at the leading IP, so none has to be skipped.
+             * @param argument The bytes after the opcode.
+             * @param handler Executes the instruction on a lane, returns the extra cycles.
+             */
+            template<Mode mode, std::uint8_t timing, typename Handler> void execute_lanes(const bool is_every_lane, const std::uint16_t argument, Handler handler) noexcept {
+                std::uint16_t next = this->leader + Machine::length(mode);
+                std::uint16_t * i_pointers = this->i_pointers.data();
+                std::uint64_t * cycles = this->cycles.data();
+                const std::uint8_t * matches = this->matches.data();
+                const std::uint32_t count = this->count;
+
+                if(is_every_lane) {
+                    for(std::uint32_t lane = 0; lane < count; lane++) {
+                        i_pointers[lane] = next;
+                        cycles[lane] += timing + handler(lane, argument);
+                    }
+
+                    return;
+                }
+
+                for(std::uint32_t lane = 0; lane < count; lane++) {
+                    if(matches[lane]) {
+                        i_pointers[lane] = next;
+                        cycles[lane] += timing + handler(lane, argument);
+                    }
+                }
+            }
+
+            /**
+             * @brief Executes instructions on every running lane, each one on its own until it reaches its limit or
+             *        halts, for when the lanes went separate ways.
+             * @return The number of instructions executed, over all the lanes.
+             */
+            std::uint64_t run_apart() noexcept {
+                std::uint64_t executed = 0;
+
+                for(std::uint32_t lane = 0; lane < this->count; lane++) {
+                    if(this->states[lane] == State::Running && this->cycles[lane] < this->limits[lane]) {
+                        executed += this->run_alone(lane);
+                    }
+
+                    this->states[lane] = this->states[lane] == State::Running ? State::Stopped : this->states[lane];
+                }
+
+                this->diverged += executed;
+
+                return executed;
+            }
+
+            /**
+             * @brief Executes instructions on one lane, with its own fetch and decode, until it gets to an IP (where
+             *        it may join the others on the next step), reaches its limit or halts. The lanes are separate
+             *        machines, so one running ahead of the rest changes nothing.
+             * @param lane The lane.
+             * @param target The IP.
+             * @return The number of instructions executed.
+             */
+            [[gnu::flatten, gnu::noinline]] std::uint32_t run_lane(const std::uint32_t lane, const std::uint16_t target) noexcept {
+                Lanes lanes = this->get_lanes();
+                std::uint64_t cycles = this->cycles[lane], limit = this->limits[lane]; // Locals, the byte stores can't touch them.
+                std::uint32_t executed = 0;
+
+                do {
+                    std::uint16_t address = lanes.i_pointers[lane], argument;
+
+                    switch(lanes.get(lane, address)) {
+                        #define X(opcode, mnemonic, handler, mode, timing) \
+                            case opcode: \
+                                argument = Machine::length(Mode::mode) > 1 ? lanes.get(lane, address + 1) : 0; \
+                                argument |= Machine::length(Mode::mode) > 2 ? lanes.get(lane, address + 2) << 8 : 0; \
+                                lanes.i_pointers[lane] = address + Machine::length(Mode::mode); \
+                                cycles += timing + lanes.execute_##handler<Mode::mode>(lane, argument); \
+                                break;
+                        __RHEA_INSTRUCTIONS__(X)
+                        #undef X
+
+                        default:
+                            this->states[lane] = State::Halted;
+                            this->cycles[lane] = cycles;
+                            return executed;
+                    }
+
+                    executed++;
+                } while(executed < max_catch_up && lanes.i_pointers[lane] != target && cycles < limit);
+
+                this->cycles[lane] = cycles;
+
+                return executed;
+            }
+
+            /**
+             * @brief Executes instructions on one lane until it reaches its limit or halts, for when the lanes went
+             *        separate ways. The lane runs like a machine would: through a page table of its own, gathered
+             *        from the page-major ones and scattered back at the end, and with threaded dispatch if the
+             *        compiler has it.
+             * @param lane The lane.
+             * @return The number of instructions executed.
+             */
+            [[gnu::flatten, gnu::noinline]] std::uint64_t run_alone(const std::uint32_t lane) noexcept {
+                std::array<const std::uint8_t *, 0x100> read_pages;
+                std::array<std::uint8_t *, 0x100> write_pages;
+                std::uint64_t executed = 0, cycles = this->cycles[lane], limit = this->limits[lane];
+                std::uint16_t argument;
+                bool is_halted = false;
+
+                for(std::uint16_t page = 0x00; page < 0x100; page++) {
+                    read_pages[page] = this->read_pages[page * this->count + lane];
+                    write_pages[page] = this->write_pages[page * this->count + lane];
+                }
+
+                Lanes lanes = Lanes {
+                    &this->a_registers[lane], &this->x_registers[lane], &this->y_registers[lane], &this->s_registers[lane],
+                    &this->s_pointers[lane], &this->i_pointers[lane], read_pages.data(), write_pages.data(), this, 1
+                };
+
+                #if __RHEA_THREADED__
+                    static void * labels[0x100];
+                    static std::atomic<bool> is_initialized = false;
+                    static std::mutex initialization;
+
+                    if(!is_initialized.load(std::memory_order_acquire)) { // Labels can't be taken outside of this function, so the table is filled on the first call.
+                        std::lock_guard<std::mutex> lock = std::lock_guard<std::mutex>(initialization);
+
+                        if(!is_initialized.load(std::memory_order_relaxed)) {
+                            std::fill(std::begin(labels), std::end(labels), &&label_illegal);
+
+                            #define X(opcode, mnemonic, handler, mode, timing) labels[opcode] = &&label_##opcode;
+                            __RHEA_INSTRUCTIONS__(X)
+                            #undef X
+
+                            is_initialized.store(true, std::memory_order_release);
+                        }
+                    }
+
+                    goto *labels[lanes.get(0, lanes.i_pointers[0])];
+
+                    #define X(opcode, mnemonic, handler, mode, timing) \
+                        label_##opcode: \
+                            argument = Machine::length(Mode::mode) > 1 ? lanes.get(0, lanes.i_pointers[0] + 1) : 0; \
+                            argument |= Machine::length(Mode::mode) > 2 ? lanes.get(0, lanes.i_pointers[0] + 2) << 8 : 0; \
+                            lanes.i_pointers[0] += Machine::length(Mode::mode); \
+                            cycles += timing + lanes.execute_##handler<Mode::mode>(0, argument); \
+                            executed++; \
+                            \
+                            if(cycles >= limit) { \
+                                goto label_done; \
+                            } \
+                            \
+                            goto *labels[lanes.get(0, lanes.i_pointers[0])];
+                    __RHEA_INSTRUCTIONS__(X)
+                    #undef X
+
+                    label_illegal:
+                        is_halted = true;
+
+                    label_done:
+                #else
+                    while(!is_halted && cycles < limit) {
+                        std::uint16_t address = lanes.i_pointers[0];
+
+                        switch(lanes.get(0, address)) {
+                            #define X(opcode, mnemonic, handler, mode, timing) \
+                                case opcode: \
+                                    argument = Machine::length(Mode::mode) > 1 ? lanes.get(0, address + 1) : 0; \
+                                    argument |= Machine::length(Mode::mode) > 2 ? lanes.get(0, address + 2) << 8 : 0; \
+                                    lanes.i_pointers[0] = address + Machine::length(Mode::mode); \
+                                    cycles += timing + lanes.execute_##handler<Mode::mode>(0, argument); \
+                                    executed++; \
+                                    break;
+                            __RHEA_INSTRUCTIONS__(X)
+                            #undef X
+
+                            default:
+                                is_halted = true;
+                        }
+                    }
+                #endif
+
+                for(std::uint16_t page = 0x00; page < 0x100; page++) {
+                    this->read_pages[page * this->count + lane] = read_pages[page];
+                    this->write_pages[page * this->count + lane] = write_pages[page];
+                }
+
+                this->states[lane] = is_halted ? State::Halted : State::Stopped;
+                this->cycles[lane] = cycles;
+
+                return executed;
+            }
+    };
+
+    class Pool {
+        public:
+            /**
+             * @brief Constructor.
+             * @param workers The number of worker threads, one per host core by default.
+             */
+            Pool(const std::size_t workers = std::max(1u, std::thread::hardware_concurrency())) {
+                this->queues = std::vector<Queue>(workers);
+            }
+
+            /**
+             * @brief Runs a task for every index of a range and waits for all of them. The indexes are dealt evenly to
+             *        the workers, and a worker that runs out of them steals from the back of the others' queues.
+             * @param count The number of indexes.
+             * @param task The task, called once per index from any of the workers.
+             */
+            void run(const std::size_t count, const std::function<void(std::size_t)> task) {
+                std::vector<std::thread> threads;
+
+                for(std::size_t index = 0; index < count; index++) {
+                    this->queues[index % this->queues.size()].indexes.push_back(index);
+                }
+
+                for(std::size_t worker = 0; worker < this->queues.size(); worker++) {
+                    threads.emplace_back([this, worker, &task]() {
+                        std::size_t index;
+
+                        while(this->take(worker, index)) {
+                            task(index);
+                        }
+                    });
+                }
+
+                for(std::thread & thread : threads) {
+                    thread.join();
+                }
+            }
+
+            std::size_t count_workers() const noexcept {
+                return this->queues.size();
+            }
+
+        private:
+            /**
+             * @brief Indexes waiting to be run by a worker.
+             */
+            struct Queue {
+                std::mutex lock;
+                std::deque<std::size_t> indexes;
+            };
+
+            /**
+             * @brief Queue of each worker.
+             */
+            std::vector<Queue> queues;
+
+            /**
+             * @brief Takes the next index of a worker, from the front of its own queue or else from the back of another.
+             * @param worker The worker.
+             * @param index The taken index.
+             * @return Whether or not there was an index left.
+             */
+            bool take(const std::size_t worker, std::size_t & index) {
+                for(std::size_t offset = 0; offset < this->queues.size(); offset++) {
+                    Queue & queue = this->queues[(worker + offset) % this->queues.size()];
+                    std::lock_guard<std::mutex> lock = std::lock_guard<std::mutex>(queue.lock);
+
+                    if(queue.indexes.empty()) {
+                        continue;
+                    }
+
+                    if(offset == 0) {
+                        index = queue.indexes.front();
+                        queue.indexes.pop_front();
+                    } else {
+                        index = queue.indexes.back();
+                        queue.indexes.pop_back();
+                    }
+
+                    return true;
+                }
+
+                return false;
+            }
+    };
+}
+
+#endif
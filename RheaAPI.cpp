@@ -0,0 +1,236 @@
+//--------------------------------------------------//
+// Headers
+//--------------------------------------------------//
+#include "Rhea.h"
+#include "Rhea.hpp"
+
+//--------------------------------------------------//
+// Code
+//--------------------------------------------------//
+namespace Rhea {
+    class Callbacks : public Device {
+        public:
+            /**
+             * @brief Constructor.
+             * @param reader The read callback, null to read zeros.
+             * @param writer The write callback, null to ignore the writes.
+             * @param context Passed to the callbacks.
+             */
+            Callbacks(const rhea_read_callback reader, const rhea_write_callback writer, void * context) noexcept {
+                this->reader = reader;
+                this->writer = writer;
+                this->context = context;
+            }
+
+            std::uint8_t read(const std::uint16_t address) override {
+                return this->reader != nullptr ? this->reader(this->context, address) : 0x00;
+            }
+
+            void write(const std::uint16_t address, const std::uint8_t value) override {
+                if(this->writer != nullptr) {
+                    this->writer(this->context, address, value);
+                }
+            }
+
+        private:
+            rhea_read_callback reader;
+            rhea_write_callback writer;
+            void * context;
+    };
+}
+
+/**
+ * @brief What the C interface hands out, the machine has no C layout of its own.
+ */
+struct rhea_machine {
+    Rhea::Machine machine;
+};
+
+/**
+ * @brief Gets the machine behind a read-only handle. The accessors of the machine hand out references, so they
+ *        aren't const even when they're only read.
+ * @param machine The handle.
+ * @return The machine.
+ */
+static Rhea::Machine & unwrap(const rhea_machine * machine) noexcept {
+    return const_cast<rhea_machine *> (machine)->machine;
+}
+
+//--------------------------------------------------//
+// Interface
+//--------------------------------------------------//
+extern "C" {
+    const char * rhea_version(void) {
+        return __RHEA_VERSION__;
+    }
+
+    rhea_machine * rhea_create(void) {
+        try {
+            return new rhea_machine();
+        } catch(const std::exception &) { // Nothing may unwind into C.
+            return nullptr;
+        }
+    }
+
+    rhea_machine * rhea_clone(const rhea_machine * machine) {
+        try {
+            return new rhea_machine(*machine);
+        } catch(const std::exception &) {
+            return nullptr;
+        }
+    }
+
+    void rhea_destroy(rhea_machine * machine) {
+        delete machine;
+    }
+
+    int rhea_load(rhea_machine * machine, const uint8_t * rom, size_t size) {
+        std::ostream errors(nullptr); // A library prints nothing, the result says it all.
+
+        return machine->machine.load(rom, size, errors) ? 0 : -1;
+    }
+
+    void rhea_reset(rhea_machine * machine) {
+        machine->machine.reset();
+    }
+
+    uint64_t rhea_step(rhea_machine * machine, uint64_t count) {
+        uint64_t executed = 0;
+
+        while(executed < count && machine->machine.step() != 0) {
+            executed++;
+        }
+
+        return executed;
+    }
+
+    uint64_t rhea_run(rhea_machine * machine, uint64_t cycles) {
+        return machine->machine.run(std::min(cycles, std::numeric_limits<uint64_t>::max() - machine->machine.reference_cycles()));
+    }
+
+    uint64_t rhea_get_cycles(const rhea_machine * machine) {
+        return unwrap(machine).reference_cycles();
+    }
+
+    int rhea_is_halted(const rhea_machine * machine) {
+        return machine->machine.is_halted() ? 1 : 0;
+    }
+
+    uint16_t rhea_get_register(const rhea_machine * machine, rhea_register name) {
+        Rhea::Machine & target = unwrap(machine);
+
+        switch(name) {
+            case RHEA_AR:
+                return target.reference_a_register();
+
+            case RHEA_XR:
+                return target.reference_x_register();
+
+            case RHEA_YR:
+                return target.reference_y_register();
+
+            case RHEA_SR:
+                return target.reference_s_register();
+
+            case RHEA_SP:
+                return target.reference_s_pointer();
+
+            case RHEA_IP:
+                return target.reference_i_pointer();
+
+            default:
+                return 0x0000;
+        }
+    }
+
+    void rhea_set_register(rhea_machine * machine, rhea_register name, uint16_t value) {
+        Rhea::Machine & target = machine->machine;
+
+        switch(name) {
+            case RHEA_AR:
+                target.reference_a_register() = value;
+                break;
+
+            case RHEA_XR:
+                target.reference_x_register() = value;
+                break;
+
+            case RHEA_YR:
+                target.reference_y_register() = value;
+                break;
+
+            case RHEA_SR:
+                target.reference_s_register() = value;
+                break;
+
+            case RHEA_SP:
+                target.reference_s_pointer() = value;
+                break;
+
+            case RHEA_IP:
+                target.reference_i_pointer() = value;
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    uint8_t rhea_read(rhea_machine * machine, uint16_t address) {
+        return machine->machine.reference_memory().get(address);
+    }
+
+    void rhea_write(rhea_machine * machine, uint16_t address, uint8_t value) {
+        machine->machine.reference_memory().set(address, value);
+    }
+
+    size_t rhea_peek(const rhea_machine * machine, uint16_t address, uint8_t * bytes, size_t count) {
+        Rhea::Memory & memory = unwrap(machine).reference_memory();
+
+        count = std::min<size_t>(count, 0x10000 - address);
+
+        for(size_t copied = 0; copied < count;) { // A page at a time, the pages are contiguous but only handed out one by one.
+            size_t chunk = std::min<size_t>(count - copied, 0x100 - ((address + copied) & 0xFF));
+
+            std::memcpy(&bytes[copied], &memory.get_page((address + copied) >> 8)[(address + copied) & 0xFF], chunk);
+            copied += chunk;
+        }
+
+        return count;
+    }
+
+    size_t rhea_poke(rhea_machine * machine, uint16_t address, const uint8_t * bytes, size_t count) {
+        count = std::min<size_t>(count, 0x10000 - address);
+        machine->machine.reference_memory().load_bytes(address, bytes, count);
+
+        return count;
+    }
+
+    int rhea_attach(rhea_machine * machine, uint8_t first_page, uint8_t last_page, rhea_read_callback read, rhea_write_callback write, void * context) {
+        if(first_page > last_page) {
+            return -1;
+        }
+
+        try {
+            machine->machine.reference_memory().attach(first_page, last_page, std::make_shared<Rhea::Callbacks>(read, write, context));
+        } catch(const std::exception &) {
+            return -1;
+        }
+
+        return 0;
+    }
+
+    void rhea_detach(rhea_machine * machine, uint8_t first_page, uint8_t last_page) {
+        if(first_page <= last_page) {
+            machine->machine.reference_memory().attach(first_page, last_page, nullptr);
+        }
+    }
+
+    void rhea_set_irq(rhea_machine * machine, uint8_t lines, int is_asserted) {
+        machine->machine.set_irq(lines & Rhea::Machine::Line::Devices, is_asserted != 0);
+    }
+
+    void rhea_trigger_nmi(rhea_machine * machine) {
+        machine->machine.trigger_nmi();
+    }
+}
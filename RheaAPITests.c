@@ -0,0 +1,154 @@
+//--------------------------------------------------//
+// Headers
+//--------------------------------------------------//
+#include "Rhea.h"
+
+#include <stdio.h>
+#include <string.h>
+
+//--------------------------------------------------//
+// Code
+//--------------------------------------------------//
+
+/**
+ * @brief A loop over the 0200 and 0300 pages that writes to the device at D000 and reads it back.
+ */
+static const uint8_t program[] = {
+    0xA2, 0x00,         // 8000: LDX #00
+    0x8A,               // 8002: TXA
+    0x9D, 0x00, 0x02,   // 8003: STA 0200,X
+    0x8D, 0x00, 0xD0,   // 8006: STA D000
+    0xAD, 0x01, 0xD0,   // 8009: LDA D001
+    0x9D, 0x00, 0x03,   // 800C: STA 0300,X
+    0xE8,               // 800F: INX
+    0xD0, 0xF0,         // 8010: BNE 8002
+    0x4C, 0x00, 0x80    // 8012: JMP 8000
+};
+
+/**
+ * @brief Checks that failed.
+ */
+static int failures = 0;
+
+/**
+ * @brief Reports a failed check.
+ * @param is_passing Whether or not the check passed.
+ * @param what What failed.
+ */
+static void check(const int is_passing, const char * what) {
+    if(!is_passing) {
+        fprintf(stderr, "\t%s\n", what);
+        failures++;
+    }
+}
+
+static uint8_t read_device(void * context, uint16_t address) {
+    (void) context;
+
+    return (address & 0xFF) ^ 0x5A;
+}
+
+static void write_device(void * context, uint16_t address, uint8_t value) {
+    (void) address;
+    (void) value;
+
+    (*(uint64_t *) context)++;
+}
+
+/**
+ * @brief Checks two machines are in the same state: cycles, registers and the whole memory.
+ * @param first The first machine.
+ * @param second The second machine.
+ * @return Whether or not they are.
+ */
+static int is_same(const rhea_machine * first, const rhea_machine * second) {
+    static uint8_t first_bytes[0x10000], second_bytes[0x10000];
+
+    if(rhea_get_cycles(first) != rhea_get_cycles(second)) {
+        return 0;
+    }
+
+    for(int name = RHEA_AR; name <= RHEA_IP; name++) {
+        if(rhea_get_register(first, (rhea_register) name) != rhea_get_register(second, (rhea_register) name)) {
+            return 0;
+        }
+    }
+
+    rhea_peek(first, 0x0000, first_bytes, sizeof(first_bytes));
+    rhea_peek(second, 0x0000, second_bytes, sizeof(second_bytes));
+
+    return memcmp(first_bytes, second_bytes, 0xD000) == 0 && memcmp(&first_bytes[0xD100], &second_bytes[0xD100], 0x2F00) == 0; // The device page reads through the callback.
+}
+
+
+//--------------------------------------------------//
+// Main Code
+//--------------------------------------------------//
+int main(void) {
+    static uint8_t rom[0x8000], oversized[0x8001];
+    uint8_t bytes[0x200], read[0x200];
+    uint64_t writes = 0, ran_writes, executed;
+    rhea_machine * machine = rhea_create(), * clone;
+
+    check(rhea_version() != NULL && strlen(rhea_version()) > 0, "The version is empty.");
+    check(machine != NULL, "The machine can't be created.");
+
+    if(machine == NULL) {
+        return 1;
+    }
+
+    memcpy(rom, program, sizeof(program));
+    rom[0x7FFC] = 0x00; // Reset vector at 8000.
+    rom[0x7FFD] = 0x80;
+
+    check(rhea_load(machine, oversized, sizeof(oversized)) == -1, "An image over 32 KB was loaded.");
+    check(rhea_load(machine, rom, sizeof(rom)) == 0, "The image can't be loaded.");
+    check(rhea_get_register(machine, RHEA_IP) == 0x8000, "The load didn't reset the machine.");
+    check(rhea_attach(machine, 0xD0, 0xD0, read_device, write_device, &writes) == 0, "The device can't be attached.");
+
+    // Running and stepping the same instructions end in the same state, the clone shares the device.
+    clone = rhea_clone(machine);
+    check(clone != NULL, "The machine can't be cloned.");
+
+    if(clone != NULL) {
+        executed = rhea_run(machine, 100000);
+        ran_writes = writes;
+        check(executed > 0 && rhea_step(clone, executed) == executed, "The clone didn't step as many instructions as the machine ran.");
+        check(is_same(machine, clone), "Running and stepping ended in different states.");
+        check(ran_writes > 0 && writes == 2 * ran_writes, "The device didn't see every write.");
+        check(rhea_read(machine, 0x0305) == (0x01 ^ 0x5A), "The device reads didn't reach the memory.");
+        rhea_destroy(clone);
+    }
+
+    // Bytes, registers and halting round-trip.
+    for(size_t index = 0; index < sizeof(bytes); index++) {
+        bytes[index] = (uint8_t) (index * 7 + 3);
+    }
+
+    check(rhea_poke(machine, 0x40F0, bytes, sizeof(bytes)) == sizeof(bytes), "The poke was cut short.");
+    check(rhea_peek(machine, 0x40F0, read, sizeof(read)) == sizeof(read) && memcmp(bytes, read, sizeof(bytes)) == 0, "The peek doesn't read what was poked.");
+    check(rhea_peek(machine, 0xFFF0, read, sizeof(read)) == 0x10, "The peek went past FFFF.");
+
+    rhea_write(machine, 0x0042, 0x99);
+    check(rhea_read(machine, 0x0042) == 0x99, "The read doesn't see the write.");
+
+    for(int name = RHEA_AR; name <= RHEA_IP; name++) {
+        uint16_t value = name == RHEA_IP ? 0x1234 : 0x56;
+
+        rhea_set_register(machine, (rhea_register) name, value);
+        check(rhea_get_register(machine, (rhea_register) name) == value, "A register doesn't hold what was set.");
+    }
+
+    rhea_write(machine, 0x1234, 0x02); // Illegal.
+    check(rhea_step(machine, 1) == 0 && rhea_is_halted(machine) == 1, "The machine didn't halt on an illegal opcode.");
+
+    rhea_reset(machine);
+    check(rhea_get_register(machine, RHEA_IP) == 0x8000 && rhea_is_halted(machine) == 0, "The reset didn't go through the vector.");
+
+    rhea_destroy(machine);
+    rhea_destroy(NULL);
+
+    printf("\tapi: %s.\n", failures == 0 ? "passed" : "failed");
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,274 @@
+//--------------------------------------------------//
+// Headers
+//--------------------------------------------------//
+#include "Rhea.hpp"
+
+#include <random>
+
+//--------------------------------------------------//
+// Code
+//--------------------------------------------------//
+namespace Rhea {
+    /**
+     * @brief Cycles each check runs the machines for.
+     */
+    static constexpr std::uint64_t test_cycles = 200000;
+
+    /**
+     * @brief Legal opcodes, what the random programs are made of.
+     */
+    static const std::uint8_t legal_opcodes[] = {
+        #define X(opcode, mnemonic, handler, mode, timing) opcode,
+        __RHEA_INSTRUCTIONS__(X)
+        #undef X
+    };
+
+    /**
+     * @brief Loads a random program into the ROM of a machine, which is reset. Every byte is a legal opcode, the
+     *        operands too, so the program can jump anywhere in the ROM without halting. It also writes into its
+     *        own code and runs into the zeros of the RAM (BRKs back into the program), until it stores an
+     *        illegal opcode where it runs.
+     * @param machine The machine.
+     * @param seed The seed of the program.
+     */
+    static void load_random(Machine & machine, const std::uint32_t seed) {
+        std::mt19937 random = std::mt19937(seed);
+        std::vector<std::uint8_t> rom = std::vector<std::uint8_t>(0x8000);
+        std::size_t offset = 0;
+
+        for(; offset < 0x7FFA; offset++) {
+            rom[offset] = legal_opcodes[random() % std::size(legal_opcodes)];
+        }
+
+        for(; offset < 0x8000; offset += 2) { // The NMI, reset and IRQ vectors, into the program.
+            std::uint16_t address = 0x8000 + random() % 0x7FFA;
+
+            rom[offset] = address & 0xFF;
+            rom[offset + 1] = address >> 8;
+        }
+
+        machine.load(rom.data(), rom.size());
+    }
+
+    /**
+     * @brief Executes instructions one by one through Machine::step, stopping like Machine::run does.
+     * @param machine The machine.
+     * @param max_cycles The maximum number of cycles.
+     * @return The number of instructions executed.
+     */
+    static std::uint64_t run_stepped(Machine & machine, const std::uint64_t max_cycles) {
+        std::uint64_t limit = machine.reference_cycles() + max_cycles, executed = 0;
+
+        while(machine.reference_cycles() < limit && machine.step() > 0) {
+            executed++;
+        }
+
+        return executed;
+    }
+
+    /**
+     * @brief Reports a failed check.
+     * @param is_passing Whether or not the check passed.
+     * @param what What failed.
+     * @return Whether or not the check passed.
+     */
+    static bool check(const bool is_passing, const std::string what) {
+        if(!is_passing) {
+            std::cerr << "\t" << what << std::endl;
+        }
+
+        return is_passing;
+    }
+
+    /**
+     * @brief Runs random programs through every dispatch strategy and checks each one ends up exactly as the
+     *        same program stepped one instruction at a time, in one run and in runs of a few cycles.
+     * @return If every check passed.
+     */
+    static bool test_dispatch() {
+        bool is_passing = true;
+
+        for(std::uint32_t seed = 1; seed <= 32; seed++) {
+            Machine original = Machine();
+            std::string name = "Seed " + std::to_string(seed) + ": ";
+
+            load_random(original, seed);
+
+            Machine stepped = original;
+            std::uint64_t executed = run_stepped(stepped, test_cycles);
+
+            Machine switched = original;
+
+            is_passing &= check(switched.run<Machine::Dispatch::Switch>(test_cycles) == executed && switched.is_identical(stepped), name + "the switch dispatch doesn't match the steps.");
+
+            #if __RHEA_THREADED__
+                Machine threaded = original;
+
+                is_passing &= check(threaded.run<Machine::Dispatch::Threaded>(test_cycles) == executed && threaded.is_identical(stepped), name + "the threaded dispatch doesn't match the steps.");
+            #endif
+
+            Machine cached = original;
+
+            cached.set_caching(true);
+            is_passing &= check(cached.run(test_cycles) == executed && cached.is_identical(stepped), name + "the cached dispatch doesn't match the steps.");
+
+            Machine sliced = original;
+
+            stepped = original;
+            sliced.set_caching(true);
+
+            for(std::uint64_t cycles = 1; cycles < test_cycles; cycles *= 3) { // Stopping and resuming mid-block.
+                is_passing &= check(sliced.run(cycles) == run_stepped(stepped, cycles) && sliced.is_identical(stepped), name + "the cached dispatch doesn't match the steps after " + std::to_string(cycles) + " cycle(s).");
+            }
+        }
+
+        return is_passing;
+    }
+
+    /**
+     * @brief Runs swarms whose lanes differ in one byte of input and checks every lane ends up as a machine with
+     *        the same input stepped one instruction at a time. The lanes of a countdown on the input split and
+     *        join again, the ones of random programs with a different first operand each go their own way.
+     * @return If every check passed.
+     */
+    static bool test_swarm() {
+        static const std::uint8_t countdown[] = {
+            0xA6, 0x10,         // 8000: LDX 10
+            0xCA,               // 8002: DEX
+            0xD0, 0xFD,         // 8003: BNE 8002
+            0xE6, 0x11,         // 8005: INC 11
+            0x4C, 0x00, 0x80    // 8007: JMP 8000
+        };
+        bool is_passing = true;
+
+        for(std::uint32_t seed = 0; seed <= 8; seed++) {
+            Machine original = Machine();
+            std::uint32_t lanes = 64;
+            std::uint16_t address = 0x0010;
+            std::string name = seed == 0 ? "Countdown: " : "Seed " + std::to_string(seed) + ": ";
+
+            if(seed == 0) {
+                original.reference_memory().load_bytes(0x8000, countdown, sizeof(countdown));
+                original.reference_i_pointer() = 0x8000;
+            } else {
+                load_random(original, seed);
+                address = original.reference_i_pointer() + 1;
+            }
+
+            std::vector<Machine> machines = std::vector<Machine>(lanes, original);
+            Swarm swarm = Swarm(original, lanes);
+
+            for(std::uint32_t lane = 0; lane < lanes; lane++) {
+                std::uint8_t input = (lane * 37) & 0xFF;
+
+                machines[lane].reference_memory().load_bytes(address, &input, 1);
+                swarm.patch(lane, address, input);
+            }
+
+            for(std::uint64_t cycles : { test_cycles / 4, test_cycles }) { // Resuming too.
+                std::uint64_t executed = swarm.run(cycles), stepped = 0;
+
+                for(Machine & machine : machines) {
+                    stepped += run_stepped(machine, cycles);
+                }
+
+                is_passing &= check(executed == stepped, name + "the swarm executed " + std::to_string(executed) + " instruction(s) instead of " + std::to_string(stepped) + ".");
+
+                for(std::uint32_t lane = 0; lane < lanes; lane++) {
+                    is_passing &= check(swarm.is_matching(lane, machines[lane]), name + "the lane #" + std::to_string(lane) + " doesn't match its machine.");
+                }
+            }
+        }
+
+        return is_passing;
+    }
+
+    /**
+     * @brief Saves the state of machines running random programs, with write protected pages, and checks a new
+     *        machine loading it is identical and stays so running on. Checks damaged states are rejected without
+     *        changing the machine.
+     * @return If every check passed.
+     */
+    static bool test_state() {
+        bool is_passing = true;
+
+        for(std::uint32_t seed = 1; seed <= 8; seed++) {
+            Machine original = Machine();
+            std::string name = "Seed " + std::to_string(seed) + ": ";
+
+            load_random(original, seed);
+            original.run(test_cycles);
+            original.reference_memory().protect(0x90 + seed, 0xA0 + seed, true);
+
+            for(bool is_compressed : { true, false }) {
+                std::vector<std::uint8_t> bytes;
+                Machine loaded = Machine(), running = original;
+                std::ostringstream errors;
+
+                running.encode_state(bytes, is_compressed);
+
+                if(!check(loaded.decode_state(bytes, name + "the state", errors), errors.str())) {
+                    is_passing = false;
+                    continue;
+                }
+
+                is_passing &= check(loaded.is_identical(running), name + "the loaded machine isn't identical.");
+                is_passing &= check(loaded.run(test_cycles) == running.run(test_cycles) && loaded.is_identical(running), name + "the loaded machine doesn't run on identically.");
+
+                Machine untouched = loaded;
+                std::vector<std::uint8_t> damaged = bytes;
+
+                damaged[damaged.size() / 2] ^= 0x01;
+                is_passing &= check(!loaded.decode_state(damaged, "The damaged state", errors) && loaded.is_identical(untouched), name + "a damaged state was loaded.");
+
+                damaged = bytes;
+                damaged.resize(damaged.size() / 2);
+                is_passing &= check(!loaded.decode_state(damaged, "The truncated state", errors) && loaded.is_identical(untouched), name + "a truncated state was loaded.");
+                is_passing &= check(errors.tellp() > 0, name + "the rejected states left no error.");
+            }
+
+            Machine loaded = Machine();
+            std::ostringstream errors;
+            std::string path = "rhea_tests_" + std::to_string(seed) + ".state";
+
+            is_passing &= check(original.save_state(path, true, errors) && loaded.load_state(path, errors) && loaded.is_identical(original), name + "the state didn't round-trip through \"" + path + "\". " + errors.str());
+            std::remove(path.c_str());
+        }
+
+        return is_passing;
+    }
+
+    /**
+     * @brief The tests, by name.
+     */
+    static const std::pair<const char *, bool (*)()> tests[] = {
+        { "dispatch", test_dispatch },
+        { "swarm", test_swarm },
+        { "state", test_state }
+    };
+}
+
+
+//--------------------------------------------------//
+// Main Code
+//--------------------------------------------------//
+int main(int argc, const char * argv[]) { // rhea_tests [test], every test without one.
+    bool is_found = false, is_passing = true;
+
+    for(const std::pair<const char *, bool (*)()> & test : Rhea::tests) {
+        if(argc < 2 || std::string(argv[1]) == test.first) {
+            bool is_test_passing = test.second();
+
+            std::cout << "\t" << test.first << ": " << (is_test_passing ? "passed" : "failed") << "." << std::endl;
+            is_found = true;
+            is_passing &= is_test_passing;
+        }
+    }
+
+    if(!is_found) {
+        std::cerr << "\tUnknown test \"" << argv[1] << "\"." << std::endl;
+        return 1;
+    }
+
+    return is_passing ? 0 : 1;
+}